@@ -52,6 +52,8 @@ public class DBSEditor : ModuleRules
 				"DeveloperSettings", 
 				
 				"EditorWidgets", 
+				"AnimationBlueprintLibrary",
+				"DerivedDataCache",
 				// ... add private dependencies that you statically link with here ...
 			}
 			);
@@ -0,0 +1,194 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSCaptureConvertCommandlet.h"
+
+#include "DBSCapture.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSCaptureConvertCommandlet)
+
+namespace
+{
+	const TCHAR* GetRecordTypeName(EDBSCaptureRecordType Type)
+	{
+		switch (Type)
+		{
+			case EDBSCaptureRecordType::Activation: return TEXT("Activation");
+			case EDBSCaptureRecordType::Sweep: return TEXT("Sweep");
+			case EDBSCaptureRecordType::SweepHit: return TEXT("SweepHit");
+			case EDBSCaptureRecordType::HitDecision: return TEXT("HitDecision");
+			default: return TEXT("Unknown");
+		}
+	}
+
+	const TCHAR* GetHitDecisionName(EDBSCaptureHitDecision Decision)
+	{
+		switch (Decision)
+		{
+			case EDBSCaptureHitDecision::Accepted: return TEXT("Accepted");
+			case EDBSCaptureHitDecision::RejectedInactive: return TEXT("RejectedInactive");
+			case EDBSCaptureHitDecision::RejectedInvalidActor: return TEXT("RejectedInvalidActor");
+			case EDBSCaptureHitDecision::RejectedAlreadyHit: return TEXT("RejectedAlreadyHit");
+			case EDBSCaptureHitDecision::RejectedByProcessHit: return TEXT("RejectedByProcessHit");
+			case EDBSCaptureHitDecision::RejectedReHitInterval: return TEXT("RejectedReHitInterval");
+			case EDBSCaptureHitDecision::RejectedMaxHitsPerTarget: return TEXT("RejectedMaxHitsPerTarget");
+			case EDBSCaptureHitDecision::RejectedMaxTargets: return TEXT("RejectedMaxTargets");
+			default: return TEXT("Unknown");
+		}
+	}
+
+	FString EscapeJson(const FString& String)
+	{
+		return String.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+	}
+}
+
+UDBSCaptureConvertCommandlet::UDBSCaptureConvertCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UDBSCaptureConvertCommandlet::Main(const FString& Params)
+{
+	FString CapturePath;
+	if (!FParse::Value(*Params, TEXT("Capture="), CapturePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("DBSCaptureConvert: -Capture=<file.dbscap> required"));
+		return 1;
+	}
+
+	FString Format = TEXT("csv");
+	FParse::Value(*Params, TEXT("Format="), Format);
+	const bool bIsJson = Format.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+
+	FString OutputPath = FPaths::ChangeExtension(CapturePath, bIsJson ? TEXT("json") : TEXT("csv"));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TMap<uint32, FString> Names;
+	const auto GetName = [&Names](uint32 Id) -> const FString&
+	{
+		static const FString None = TEXT("None");
+		const FString* Name = Names.Find(Id);
+		return Name ? *Name : None;
+	};
+
+	TArray<FString> Lines;
+	if (!bIsJson)
+	{
+		Lines.Add(TEXT("Frame,WorldTime,Record,Object,Other,Detail,StartX,StartY,StartZ,EndX,EndY,EndZ,RotX,RotY,RotZ,RotW,Shape,ExtentX,ExtentY,ExtentZ,Channel,Hurtboxes,Time"));
+	}
+
+	uint64 Frame = 0;
+	double WorldTime = 0.0;
+	const bool bIsRead = FDBSCapture::ReadCapture(CapturePath, [&](const FDBSCaptureRecord& Record)
+	{
+		switch (Record.Type)
+		{
+			case EDBSCaptureRecordType::Frame:
+				Frame = Record.Frame;
+				WorldTime = Record.WorldTime;
+				return;
+			case EDBSCaptureRecordType::Name:
+				Names.Add(Record.Id, Record.Name);
+				return;
+			default:
+				break;
+		}
+
+		// same columns for every record type, unused are empty
+		FString Object;
+		FString Other;
+		FString Detail;
+		bool bHasSweep = false;
+		bool bHasPoint = false;
+		switch (Record.Type)
+		{
+			case EDBSCaptureRecordType::Activation:
+				Object = GetName(Record.BehaviorId);
+				Other = GetName(Record.OwnerId);
+				Detail = FString::Printf(TEXT("%s payload %08x"), Record.bIsActive ? TEXT("Active") : TEXT("Inactive"), Record.PayloadHash);
+				break;
+			case EDBSCaptureRecordType::Sweep:
+				Object = GetName(Record.HitRegistratorId);
+				Detail = FString::Printf(TEXT("window %u hits %u"), Record.HitRegistrationWindow, Record.NumHits);
+				bHasSweep = true;
+				break;
+			case EDBSCaptureRecordType::SweepHit:
+				Object = GetName(Record.HitActorId);
+				Other = GetName(Record.HitComponentId);
+				Detail = Record.bStartPenetrating ? TEXT("StartPenetrating") : TEXT("");
+				bHasPoint = true;
+				break;
+			case EDBSCaptureRecordType::HitDecision:
+				Object = GetName(Record.BehaviorId);
+				Other = GetName(Record.HitActorId);
+				Detail = GetHitDecisionName(Record.Decision);
+				break;
+			default:
+				break;
+		}
+
+		if (bIsJson)
+		{
+			FString Line = FString::Printf(TEXT("{\"frame\":%llu,\"worldTime\":%.4f,\"record\":\"%s\",\"object\":\"%s\",\"other\":\"%s\",\"detail\":\"%s\""),
+				Frame, WorldTime, GetRecordTypeName(Record.Type), *EscapeJson(Object), *EscapeJson(Other), *EscapeJson(Detail));
+			if (bHasSweep)
+			{
+				Line += FString::Printf(TEXT(",\"start\":[%.2f,%.2f,%.2f],\"end\":[%.2f,%.2f,%.2f],\"rotation\":[%.4f,%.4f,%.4f,%.4f],\"shape\":%u,\"extent\":[%.2f,%.2f,%.2f],\"channel\":%u,\"hurtboxes\":%s"),
+					Record.Start.X, Record.Start.Y, Record.Start.Z, Record.End.X, Record.End.Y, Record.End.Z,
+					Record.Rotation.X, Record.Rotation.Y, Record.Rotation.Z, Record.Rotation.W,
+					Record.ShapeType, Record.ShapeExtent.X, Record.ShapeExtent.Y, Record.ShapeExtent.Z,
+					Record.TraceChannel, Record.bByHurtboxes ? TEXT("true") : TEXT("false"));
+			}
+			if (bHasPoint)
+			{
+				Line += FString::Printf(TEXT(",\"impactPoint\":[%.2f,%.2f,%.2f],\"time\":%.4f"),
+					Record.ImpactPoint.X, Record.ImpactPoint.Y, Record.ImpactPoint.Z, Record.Time);
+			}
+			Lines.Add(Line + TEXT("}"));
+			return;
+		}
+
+		FString Line = FString::Printf(TEXT("%llu,%.4f,%s,\"%s\",\"%s\",\"%s\""),
+			Frame, WorldTime, GetRecordTypeName(Record.Type), *Object, *Other, *Detail);
+		if (bHasSweep)
+		{
+			Line += FString::Printf(TEXT(",%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.4f,%.4f,%.4f,%.4f,%u,%.2f,%.2f,%.2f,%u,%d,"),
+				Record.Start.X, Record.Start.Y, Record.Start.Z, Record.End.X, Record.End.Y, Record.End.Z,
+				Record.Rotation.X, Record.Rotation.Y, Record.Rotation.Z, Record.Rotation.W,
+				Record.ShapeType, Record.ShapeExtent.X, Record.ShapeExtent.Y, Record.ShapeExtent.Z,
+				Record.TraceChannel, Record.bByHurtboxes ? 1 : 0);
+		}
+		else if (bHasPoint)
+		{
+			// impact point in start columns
+			Line += FString::Printf(TEXT(",%.2f,%.2f,%.2f,,,,,,,,,,,,,,%.4f"),
+				Record.ImpactPoint.X, Record.ImpactPoint.Y, Record.ImpactPoint.Z, Record.Time);
+		}
+		else
+		{
+			Line += TEXT(",,,,,,,,,,,,,,,,,");
+		}
+		Lines.Add(Line);
+	});
+
+	if (!bIsRead)
+	{
+		UE_LOG(LogTemp, Error, TEXT("DBSCaptureConvert: %s is not a DBS capture of version %u"), *CapturePath, FDBSCapture::Version);
+		return 1;
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("DBSCaptureConvert: can't write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("DBSCaptureConvert: %d records written to %s"), Lines.Num(), *OutputPath);
+	return 0;
+}
@@ -3,6 +3,8 @@
 #include "DBSEditor.h"
 
 #include "DBSEditorDamageBehaviorDetails.h"
+#include "DBSEditorHitWindowBaker.h"
+#include "DBSBakedTrajectory.h"
 #include "DamageBehaviorsComponent.h"
 #include "DBSEditorPreviewDrawer.h"
 #include "DBSPreviewDebugBridge.h"
@@ -78,6 +80,9 @@ void FDBSEditorModule::StartupModule()
 	// Ensure preview drawer singleton exists
 	FDBSEditorPreviewDrawer::Get();
 
+	// UANS_InvokeDamageBehavior bakes hit windows on save/cook through this
+	DBS_GetBakeHitWindowDelegate().BindStatic(&FDBSEditorHitWindowBaker::BakeHitWindow);
+
 	// Editor-only: listen to asset editor open/close to spawn/respawn DebugActors for montages
 	if (GEditor)
 	{
@@ -149,7 +154,7 @@ void FDBSEditorModule::StartupModule()
                     // Show HitRegistrators shapes (default OFF)
                     MenuBuilder.AddMenuEntry(
                         FText::FromString("Show HitRegistrators shapes"),
-                        FText::FromString("Toggle visibility of UCapsuleHitRegistrator shapes on spawned DebugActors"),
+                        FText::FromString("Toggle visibility of UDBSHitRegistratorBase shapes on spawned DebugActors"),
                         FSlateIcon(),
                         FUIAction(
                             FExecuteAction::CreateLambda([S]() mutable 
@@ -568,6 +573,7 @@ void FDBSEditorModule::ShutdownModule()
 	// }
 
 	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+	DBS_GetBakeHitWindowDelegate().Unbind();
 	if (GEditor)
 	{
 		if (UAssetEditorSubsystem* AES = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
@@ -0,0 +1,245 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSEditorHitWindowBaker.h"
+
+#include "ANS_InvokeDamageBehavior.h"
+#include "DamageBehaviorsSystemSettings.h"
+#include "DBSBakedTrajectory.h"
+#include "DerivedDataCacheInterface.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Animation/Skeleton.h"
+#include "AnimPose.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// bump when sampling or data layout changes, invalidates DDC
+#define DBS_HIT_WINDOW_BAKE_VERSION TEXT("1")
+
+bool FDBSEditorHitWindowBaker::BakeHitWindow(const UANS_InvokeDamageBehavior* InvokeDamageBehavior, FDBSBakedHitWindow& HitWindow)
+{
+	// notify states are outered to animation they placed in
+	const UAnimMontage* Montage = Cast<UAnimMontage>(InvokeDamageBehavior->GetOuter());
+	if (!Montage || Montage->SlotAnimTracks.IsEmpty()) return false;
+
+	float StartTime = 0.0f;
+	float Duration = 0.0f;
+	if (!FindNotifyWindow(Montage, InvokeDamageBehavior, StartTime, Duration)) return false;
+
+	USkeletalMesh* Mesh = Montage->GetPreviewMesh();
+	if (!Mesh && Montage->GetSkeleton())
+	{
+		Mesh = Montage->GetSkeleton()->GetPreviewMesh(true);
+	}
+	if (!Mesh) return false;
+
+	TArray<FDBSDebugActor> DebugActors;
+	TArray<FDBSDebugHitRegistratorDescription> Descriptions;
+	InvokeDamageBehavior->GatherHitRegistratorsDescriptions(Mesh, DebugActors, Descriptions);
+	if (Descriptions.IsEmpty()) return false;
+
+	const FString BakeKey = BuildBakeKey(Montage, Mesh, StartTime, Duration, Descriptions);
+	if (HitWindow.BakeKey == BakeKey && HitWindow.IsValid()) return false;
+
+	FDBSBakedHitWindow BakedHitWindow;
+	TArray<uint8> Data;
+	FDerivedDataCacheInterface& DDC = GetDerivedDataCacheRef();
+	if (DDC.GetSynchronous(*BakeKey, Data, Montage->GetPathName()))
+	{
+		FMemoryReader Ar(Data);
+		Ar << BakedHitWindow;
+	}
+	else
+	{
+		BakedHitWindow.StartTime = StartTime;
+		BakedHitWindow.Duration = Duration;
+
+		const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+		const int32 NumSamples = FMath::Max(2, FMath::CeilToInt32(Duration * DamageBehaviorsSystemSettings->BakedHitWindowsSampleRate) + 1);
+
+		TArray<float> SampleTimes;
+		TArray<TArray<FTransform>> Samples;
+		Samples.SetNum(Descriptions.Num());
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+		{
+			const float WindowTime = Duration * SampleIndex / (NumSamples - 1);
+			FAnimPose Pose;
+			FTransform RootMotionCorrection;
+			if (!EvaluateMontagePose(Montage, Mesh, StartTime + WindowTime, Pose, RootMotionCorrection)) continue;
+
+			SampleTimes.Add(WindowTime);
+			for (int32 i = 0; i < Descriptions.Num(); i++)
+			{
+				const FDBSDebugHitRegistratorDescription& Description = Descriptions[i];
+				const FTransform SocketTransform = GetSocketTransform(Pose, Description.SocketNameAttached) * RootMotionCorrection;
+				Samples[i].Add(FTransform(Description.Rotation, Description.Location) * SocketTransform);
+			}
+		}
+		if (SampleTimes.IsEmpty()) return false;
+
+		for (int32 i = 0; i < Descriptions.Num(); i++)
+		{
+			FDBSBakedTrajectoryTrack& Track = BakedHitWindow.Tracks.AddDefaulted_GetRef();
+			Track.SourceName = Descriptions[i].SourceName;
+			Track.HitRegistratorName = Descriptions[i].HitRegistratorName;
+			ReduceKeys(Track, Samples[i], SampleTimes);
+		}
+
+		FMemoryWriter Ar(Data);
+		Ar << BakedHitWindow;
+		DDC.Put(*BakeKey, Data, Montage->GetPathName());
+	}
+
+	BakedHitWindow.BakeKey = BakeKey;
+	HitWindow = MoveTemp(BakedHitWindow);
+	return true;
+}
+
+bool FDBSEditorHitWindowBaker::FindNotifyWindow(const UAnimMontage* Montage, const UANS_InvokeDamageBehavior* InvokeDamageBehavior, float& OutStartTime, float& OutDuration)
+{
+	const FAnimNotifyEvent* NotifyEvent = Montage->Notifies.FindByPredicate([&](const FAnimNotifyEvent& Event)
+	{
+		return Event.NotifyStateClass == InvokeDamageBehavior;
+	});
+	if (!NotifyEvent) return false;
+
+	OutStartTime = NotifyEvent->GetTriggerTime();
+	OutDuration = NotifyEvent->GetDuration();
+	return OutDuration > 0.0f;
+}
+
+FString FDBSEditorHitWindowBaker::BuildBakeKey(const UAnimMontage* Montage, const USkeletalMesh* Mesh, float StartTime, float Duration,
+	const TArray<FDBSDebugHitRegistratorDescription>& Descriptions)
+{
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+
+	FString KeyString = FString::Printf(TEXT("%s|%.4f|%.4f|%.2f|%.3f|%.3f|%s"),
+		*Montage->GetPathName(), StartTime, Duration,
+		DamageBehaviorsSystemSettings->BakedHitWindowsSampleRate,
+		DamageBehaviorsSystemSettings->BakedHitWindowsLocationTolerance,
+		DamageBehaviorsSystemSettings->BakedHitWindowsRotationTolerance,
+		*Mesh->GetPathName());
+
+	// animation data and how montage plays it
+	for (const FAnimSegment& Segment : Montage->SlotAnimTracks[0].AnimTrack.AnimSegments)
+	{
+		const UAnimSequenceBase* Anim = Segment.GetAnimReference();
+		KeyString += FString::Printf(TEXT("|%s|%s|%.4f|%.4f|%.4f|%.4f|%d"),
+			Anim ? *Anim->GetPathName() : TEXT("None"),
+			Anim && Anim->GetDataModel() ? *Anim->GetDataModel()->GenerateGuid().ToString() : TEXT(""),
+			Segment.StartPos, Segment.AnimStartTime, Segment.AnimEndTime, Segment.AnimPlayRate, Segment.LoopingCount);
+	}
+
+	// HitRegistrators placement and sockets they attached to
+	for (const FDBSDebugHitRegistratorDescription& Description : Descriptions)
+	{
+		KeyString += FString::Printf(TEXT("|%s|%s|%s|%s|%s"),
+			*Description.SourceName, *Description.HitRegistratorName, *Description.SocketNameAttached.ToString(),
+			*Description.Location.ToString(), *Description.Rotation.ToString());
+		if (const USkeletalMeshSocket* Socket = Mesh->FindSocket(Description.SocketNameAttached))
+		{
+			KeyString += FString::Printf(TEXT("|%s|%s|%s"),
+				*Socket->BoneName.ToString(), *Socket->RelativeLocation.ToString(), *Socket->RelativeRotation.ToString());
+		}
+	}
+
+	FSHAHash Hash;
+	FSHA1::HashBuffer(*KeyString, KeyString.Len() * sizeof(TCHAR), Hash.Hash);
+	return FDerivedDataCacheInterface::BuildCacheKey(TEXT("DBSHITWINDOW"), DBS_HIT_WINDOW_BAKE_VERSION, *Hash.ToString());
+}
+
+bool FDBSEditorHitWindowBaker::EvaluateMontagePose(const UAnimMontage* Montage, const USkeletalMesh* Mesh, float Time, FAnimPose& OutPose, FTransform& OutRootMotionCorrection)
+{
+	const FAnimTrack& AnimTrack = Montage->SlotAnimTracks[0].AnimTrack;
+	// segment end is exclusive
+	const float TrackTime = FMath::Min(Time, AnimTrack.GetLength() - UE_KINDA_SMALL_NUMBER);
+	const int32 SegmentIndex = AnimTrack.GetSegmentIndexAtTime(TrackTime);
+	if (!AnimTrack.AnimSegments.IsValidIndex(SegmentIndex)) return false;
+
+	const FAnimSegment& Segment = AnimTrack.AnimSegments[SegmentIndex];
+	const UAnimSequenceBase* Anim = Segment.GetAnimReference();
+	if (!Anim) return false;
+
+	FAnimPoseEvaluationOptions EvaluationOptions;
+	EvaluationOptions.EvaluationType = EAnimDataEvalType::Raw;
+	EvaluationOptions.OptionalSkeletalMesh = const_cast<USkeletalMesh*>(Mesh);
+	UAnimPoseExtensions::GetAnimPoseAtTime(Anim, Segment.ConvertTrackPosToAnimPos(TrackTime), EvaluationOptions, OutPose);
+	if (!UAnimPoseExtensions::IsValid(OutPose)) return false;
+
+	OutRootMotionCorrection = FTransform::Identity;
+	if (Anim->HasRootMotion())
+	{
+		// root motion moves actor, not root bone - root locked on ref pose
+		const FName RootBoneName = Mesh->GetRefSkeleton().GetBoneName(0);
+		const FTransform RootTransform = UAnimPoseExtensions::GetBonePose(OutPose, RootBoneName, EAnimPoseSpaces::World);
+		const FTransform RefRootTransform = UAnimPoseExtensions::GetRefBonePose(OutPose, RootBoneName, EAnimPoseSpaces::World);
+		OutRootMotionCorrection = RootTransform.Inverse() * RefRootTransform;
+	}
+	return true;
+}
+
+FTransform FDBSEditorHitWindowBaker::GetSocketTransform(const FAnimPose& Pose, FName SocketName)
+{
+	if (SocketName.IsNone()) return FTransform::Identity;
+
+	TArray<FName> SocketNames;
+	UAnimPoseExtensions::GetSocketNames(Pose, SocketNames);
+	if (SocketNames.Contains(SocketName))
+	{
+		return UAnimPoseExtensions::GetSocketPose(Pose, SocketName, EAnimPoseSpaces::World);
+	}
+
+	// attached directly to bone
+	TArray<FName> BoneNames;
+	UAnimPoseExtensions::GetBoneNames(Pose, BoneNames);
+	if (BoneNames.Contains(SocketName))
+	{
+		return UAnimPoseExtensions::GetBonePose(Pose, SocketName, EAnimPoseSpaces::World);
+	}
+	return FTransform::Identity;
+}
+
+void FDBSEditorHitWindowBaker::ReduceKeys(FDBSBakedTrajectoryTrack& Track, const TArray<FTransform>& Samples, const TArray<float>& SampleTimes)
+{
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+	const float LocationTolerance = DamageBehaviorsSystemSettings->BakedHitWindowsLocationTolerance;
+	const float RotationTolerance = FMath::DegreesToRadians(DamageBehaviorsSystemSettings->BakedHitWindowsRotationTolerance);
+
+	auto AddKey = [&Track, &Samples, &SampleTimes](int32 SampleIndex)
+	{
+		Track.KeyTimes.Add(SampleTimes[SampleIndex]);
+		Track.KeyLocations.Add(FVector3f(Samples[SampleIndex].GetLocation()));
+		Track.KeyRotations.Add(FQuat4f(Samples[SampleIndex].GetRotation()));
+	};
+
+	// key kept when any sample between it and next candidate drifts from interpolation
+	int32 AnchorIndex = 0;
+	AddKey(AnchorIndex);
+	for (int32 CandidateIndex = 2; CandidateIndex < Samples.Num(); CandidateIndex++)
+	{
+		const FTransform& Anchor = Samples[AnchorIndex];
+		const FTransform& Candidate = Samples[CandidateIndex];
+		bool bCanSkip = true;
+		for (int32 i = AnchorIndex + 1; i < CandidateIndex && bCanSkip; i++)
+		{
+			const float Alpha = (SampleTimes[i] - SampleTimes[AnchorIndex]) / (SampleTimes[CandidateIndex] - SampleTimes[AnchorIndex]);
+			const FVector Location = FMath::Lerp(Anchor.GetLocation(), Candidate.GetLocation(), Alpha);
+			const FQuat Rotation = FQuat::Slerp(Anchor.GetRotation(), Candidate.GetRotation(), Alpha);
+			bCanSkip = FVector::Dist(Location, Samples[i].GetLocation()) <= LocationTolerance
+				&& Rotation.AngularDistance(Samples[i].GetRotation()) <= RotationTolerance;
+		}
+
+		if (!bCanSkip)
+		{
+			AnchorIndex = CandidateIndex - 1;
+			AddKey(AnchorIndex);
+		}
+	}
+	if (Samples.Num() > 1)
+	{
+		AddKey(Samples.Num() - 1);
+	}
+}
@@ -82,6 +82,22 @@ void FDBSEditorPreviewDrawer::Tick(float DeltaTime)
 			const FRotator FinalRotation = SocketRotation + Desc.Rotation;
 			const FVector FinalLocation = SocketLocation + FinalRotation.RotateVector(Desc.Location);
 
+			if (Desc.bIsBox)
+			{
+				DrawDebugBox(
+					MeshComp->GetWorld(),
+					FinalLocation,
+					Desc.BoxExtent,
+					FinalRotation.Quaternion(),
+					Desc.Color.ToFColor(true),
+					false,
+					-1.0f,
+					0,
+					Desc.Thickness
+				);
+				continue;
+			}
+
 			DrawDebugCapsule(
 				MeshComp->GetWorld(),
 				FinalLocation,
@@ -363,8 +379,8 @@ void FDBSEditorPreviewDrawer::ApplySpawnForMeshWithComponent(USkeletalMesh* Mesh
 		// Apply HitRegistrator shapes visibility on initial spawn/respawn
 		{
 			const bool bHide = Settings->bHideDebugActorHitRegistratorShapes;
-			TInlineComponentArray<UCapsuleHitRegistrator*> Registrators(Existing);
-			for (UCapsuleHitRegistrator* Reg : Registrators)
+			TInlineComponentArray<UDBSHitRegistratorBase*> Registrators(Existing);
+			for (UDBSHitRegistratorBase* Reg : Registrators)
 			{
 				if (!Reg) continue;
 				Reg->SetVisibility(!bHide, true);
@@ -385,8 +401,8 @@ void FDBSEditorPreviewDrawer::UpdateHitRegistratorShapesVisibilityForAll()
         {
             if (AActor* Actor = SourcePair.Value.Get())
             {
-                TInlineComponentArray<UCapsuleHitRegistrator*> Registrators(Actor);
-                for (UCapsuleHitRegistrator* Reg : Registrators)
+                TInlineComponentArray<UDBSHitRegistratorBase*> Registrators(Actor);
+                for (UDBSHitRegistratorBase* Reg : Registrators)
                 {
                     if (!Reg) continue;
                     Reg->SetVisibility(!bHide);
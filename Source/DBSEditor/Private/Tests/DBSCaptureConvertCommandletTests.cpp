@@ -0,0 +1,67 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSCaptureConvertCommandlet.h"
+#include "DBSCapture.h"
+#include "DamageBehavior.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "StructUtils/InstancedStruct.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSCaptureConvertCommandletTest, "DamageBehaviorsSystem.Capture.Convert",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDBSCaptureConvertCommandletTest::RunTest(const FString& Parameters)
+{
+	const FString CapturePath = FPaths::AutomationTransientDir() / TEXT("DBSCaptureConvert.dbscap");
+	const FString CsvPath = FPaths::ChangeExtension(CapturePath, TEXT("csv"));
+	const FString JsonPath = FPaths::ChangeExtension(CapturePath, TEXT("json"));
+	if (FDBSCapture::IsCapturing())
+	{
+		AddError(TEXT("capture already running"));
+		return false;
+	}
+
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	AActor* HitActor = NewObject<AActor>(GetTransientPackage());
+	if (!TestTrue(TEXT("capture started"), FDBSCapture::Start(CapturePath))) return false;
+	FDBSCapture::RecordActivation(DamageBehavior, true, FInstancedStruct());
+	FDBSCapture::RecordHitDecision(DamageBehavior, HitActor, EDBSCaptureHitDecision::RejectedReHitInterval);
+	FDBSCapture::Stop();
+
+	UDBSCaptureConvertCommandlet* Commandlet = NewObject<UDBSCaptureConvertCommandlet>();
+	TestEqual(TEXT("csv converted"), Commandlet->Main(FString::Printf(TEXT("-Capture=\"%s\""), *CapturePath)), 0);
+	TestEqual(TEXT("json converted"), Commandlet->Main(FString::Printf(TEXT("-Capture=\"%s\" -Format=json"), *CapturePath)), 0);
+
+	// ids replaced with object paths, frame and name records folded into other records
+	const FString BehaviorPath = DamageBehavior->GetPathName(nullptr);
+	const FString HitActorPath = HitActor->GetPathName(nullptr);
+	TArray<FString> CsvLines;
+	FFileHelper::LoadFileToStringArray(CsvLines, *CsvPath);
+	if (TestEqual(TEXT("csv header and two records"), CsvLines.Num(), 3))
+	{
+		TestTrue(TEXT("csv activation"), CsvLines[1].Contains(FString::Printf(TEXT(",Activation,\"%s\",\"None\",\"Active payload 00000000\""), *BehaviorPath)));
+		TestTrue(TEXT("csv hit decision"), CsvLines[2].Contains(FString::Printf(TEXT(",HitDecision,\"%s\",\"%s\",\"RejectedReHitInterval\""), *BehaviorPath, *HitActorPath)));
+	}
+
+	TArray<FString> JsonLines;
+	FFileHelper::LoadFileToStringArray(JsonLines, *JsonPath);
+	if (TestEqual(TEXT("json record per line"), JsonLines.Num(), 2))
+	{
+		TestTrue(TEXT("json activation"), JsonLines[0].Contains(TEXT("\"record\":\"Activation\"")));
+		TestTrue(TEXT("json hit decision"), JsonLines[1].Contains(TEXT("\"detail\":\"RejectedReHitInterval\"")));
+		TestTrue(TEXT("json object path"), JsonLines[1].Contains(FString::Printf(TEXT("\"other\":\"%s\""), *HitActorPath)));
+	}
+
+	TestNotEqual(TEXT("missing capture fails"), Commandlet->Main(FString::Printf(TEXT("-Capture=\"%s.missing\""), *CapturePath)), 0);
+
+	IFileManager::Get().Delete(*CapturePath);
+	IFileManager::Get().Delete(*CsvPath);
+	IFileManager::Get().Delete(*JsonPath);
+	return true;
+}
+
+#endif
@@ -0,0 +1,23 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DBSCaptureConvertCommandlet.generated.h"
+
+/**
+ * Converts "DamageBehaviorsSystem.Capture" binary captures to text for diffing between builds.
+ * -run=DBSCaptureConvert -Capture=<file.dbscap> [-Output=<file>] [-Format=csv|json]
+ * Object ids replaced with object paths, json is one record per line
+ */
+UCLASS()
+class UDBSCaptureConvertCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDBSCaptureConvertCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
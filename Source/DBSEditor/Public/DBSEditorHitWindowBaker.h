@@ -0,0 +1,32 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimMontage;
+class UANS_InvokeDamageBehavior;
+class USkeletalMesh;
+struct FAnimPose;
+struct FDBSBakedHitWindow;
+struct FDBSBakedTrajectoryTrack;
+struct FDBSDebugHitRegistratorDescription;
+
+/**
+ * Bakes HitRegistrators trajectories of UANS_InvokeDamageBehavior windows in montages(bound to DBS_GetBakeHitWindowDelegate).
+ * Pose sampled from first slot track of montage on preview mesh, HitRegistrators placed on sockets
+ * the same way animation preview draws them. Results cached in DDC by everything that affects them
+ */
+struct FDBSEditorHitWindowBaker
+{
+	static bool BakeHitWindow(const UANS_InvokeDamageBehavior* InvokeDamageBehavior, FDBSBakedHitWindow& HitWindow);
+
+private:
+	static bool FindNotifyWindow(const UAnimMontage* Montage, const UANS_InvokeDamageBehavior* InvokeDamageBehavior, float& OutStartTime, float& OutDuration);
+	static FString BuildBakeKey(const UAnimMontage* Montage, const USkeletalMesh* Mesh, float StartTime, float Duration,
+		const TArray<FDBSDebugHitRegistratorDescription>& Descriptions);
+	// pose in skeletal mesh component space, root motion removed same as root lock on RefPose
+	static bool EvaluateMontagePose(const UAnimMontage* Montage, const USkeletalMesh* Mesh, float Time, FAnimPose& OutPose, FTransform& OutRootMotionCorrection);
+	static FTransform GetSocketTransform(const FAnimPose& Pose, FName SocketName);
+	static void ReduceKeys(FDBSBakedTrajectoryTrack& Track, const TArray<FTransform>& Samples, const TArray<float>& SampleTimes);
+};
@@ -5,10 +5,13 @@
 
 #include "DamageBehaviorsComponent.h"
 #include "DamageBehaviorsSystemSettings.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
 #include "DBSPreviewDebugBridge.h"
 #include "Engine/InheritableComponentHandler.h"
 #include "Engine/SCS_Node.h"
 #include "Engine/SimpleConstructionScript.h"
+#include "UObject/ObjectSaveContext.h"
 
 void FDBSDebugActor::FillData()
 {
@@ -29,7 +32,7 @@ void FDBSDebugActor::FillData()
 	}
 			
 	// 3) Gather components by traversing the class hierarchy
-	TMap<FString, TTuple<UCapsuleHitRegistrator*, FName>> ComponentNameToInfo;
+	TMap<FString, TTuple<UDBSHitRegistratorBase*, FName>> ComponentNameToInfo;
 	
 	// First, try to get components from the current blueprint class
 	if (UBlueprintGeneratedClass* CurrentBPGC = Cast<UBlueprintGeneratedClass>(CharClass))
@@ -43,7 +46,7 @@ void FDBSDebugActor::FillData()
 			InheritableComponentHandler->GetAllTemplates(Templates);
 			for (UActorComponent* Template : Templates)
 			{
-				if (UCapsuleHitRegistrator* HitReg = Cast<UCapsuleHitRegistrator>(Template))
+				if (UDBSHitRegistratorBase* HitReg = Cast<UDBSHitRegistratorBase>(Template))
 				{
 					FString CompName = HitReg->GetName();
 					UE_LOG(LogTemp, Log, TEXT("Found overridden hit registrator in current class: %s"), *CompName);
@@ -83,7 +86,7 @@ void FDBSDebugActor::FillData()
 			{
 				if (UActorComponent* Component = Node->ComponentTemplate)
 				{
-					if (UCapsuleHitRegistrator* HitReg = Cast<UCapsuleHitRegistrator>(Component))
+					if (UDBSHitRegistratorBase* HitReg = Cast<UDBSHitRegistratorBase>(Component))
 					{
 						FString CompName = HitReg->GetName();
 						if (!ComponentNameToInfo.Contains(CompName))
@@ -118,7 +121,7 @@ void FDBSDebugActor::FillData()
 					{
 						if (UActorComponent* Component = Node->ComponentTemplate)
 						{
-							if (UCapsuleHitRegistrator* HitReg = Cast<UCapsuleHitRegistrator>(Component))
+							if (UDBSHitRegistratorBase* HitReg = Cast<UDBSHitRegistratorBase>(Component))
 							{
 								FString CompName = HitReg->GetName();
 								if (!ComponentNameToInfo.Contains(CompName))
@@ -143,7 +146,7 @@ void FDBSDebugActor::FillData()
 	// Now add all the components we found
 	for (const auto& ComponentInfo : ComponentNameToInfo)
 	{
-		UCapsuleHitRegistrator* HitReg = ComponentInfo.Value.Get<0>();
+		UDBSHitRegistratorBase* HitReg = ComponentInfo.Value.Get<0>();
 		FName SocketName2 = ComponentInfo.Value.Get<1>();
 		HitRegistrators.Add(HitReg);
 		HitRegistratorsToAttachSocketsList.Add(HitReg, SocketName2);
@@ -154,7 +157,7 @@ void FDBSDebugActor::FillData()
 	ActorCDO->GetComponents(UActorComponent::StaticClass(), NativeComponents);
 	for (UActorComponent* Component : NativeComponents)
 	{
-		if (UCapsuleHitRegistrator* HitReg = Cast<UCapsuleHitRegistrator>(Component))
+		if (UDBSHitRegistratorBase* HitReg = Cast<UDBSHitRegistratorBase>(Component))
 		{
 			FString CompName = HitReg->GetName();
 			if (!ComponentNameToInfo.Contains(CompName))
@@ -183,78 +186,43 @@ UANS_InvokeDamageBehavior::UANS_InvokeDamageBehavior()
 	}
 }
 
+void UANS_InvokeDamageBehavior::PostInitProperties()
+{
+	Super::PostInitProperties();
+	CacheNames();
+}
+
+void UANS_InvokeDamageBehavior::PostLoad()
+{
+	Super::PostLoad();
+	CacheNames();
+}
+
+#if WITH_EDITOR
+void UANS_InvokeDamageBehavior::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	CacheNames();
+}
+#endif
+
+void UANS_InvokeDamageBehavior::CacheNames()
+{
+	CachedName = FName(*Name);
+	CachedSourcesNames = GetDamageBehaviorSourcesNames();
+}
+
 void UANS_InvokeDamageBehavior::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference)
 {
 	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
 
     if (MeshComp->GetWorld()->IsPreviewWorld())
 	{
-		const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
-		const FDBSDebugActorsForMesh* InvokeDamageBehaviorDebugForMeshSearch = DamageBehaviorsSystemSettings->DefaultDebugActorsForPreview.FindByKey(MeshComp->GetSkeletalMeshAsset());
-		
-		// If no specific debug actors found for this mesh, use the fallback mesh
-		if (!InvokeDamageBehaviorDebugForMeshSearch)
-		{
-			FilledDebugActors = DamageBehaviorsSystemSettings->FallbackDebugMesh.DebugActors;
-		}
-		else
-		{
-			const FDBSDebugActorsForMesh& InvokeDamageBehaviorDebugForMesh = *InvokeDamageBehaviorDebugForMeshSearch;
-			FilledDebugActors = InvokeDamageBehaviorDebugForMesh.DebugActors;
-		}
-		
-		if (FilledDebugActors.IsEmpty()) return;
-		
-		TArray<FString> DamageBehaviorsSourcesList = GetDamageBehaviorSourcesList();
-
-		for (FDBSDebugActor& DebugActor : FilledDebugActors)
+		TArray<FDBSDebugHitRegistratorDescription> HitRegistratorsDescriptions;
+		if (!GatherHitRegistratorsDescriptions(MeshComp->GetSkeletalMeshAsset(), FilledDebugActors, HitRegistratorsDescriptions)) return;
+		for (const FDBSDebugHitRegistratorDescription& HitRegistratorDescription : HitRegistratorsDescriptions)
 		{
-			DebugActor.FillData();
-		}
-		
-		for (FString DamageBehaviorsSource : DamageBehaviorsSourcesList)
-		{
-			FDBSDebugActor DebugActor = GetFilledDebugActor(DamageBehaviorsSource);
-			if (!DebugActor.IsValid()) continue;
-
-			UDamageBehavior* DamageBehavior = DebugActor.DBC->GetDamageBehavior(Name);
-			if (!DamageBehavior) continue;
-
-			for (FDBSHitRegistratorsToActivateSource HitRegistratorsToActivateBySource : DamageBehavior->HitRegistratorsToActivateBySource)
-			{
-				FDBSDebugActor DebugActorForHitRegistrator = GetFilledDebugActor(HitRegistratorsToActivateBySource.SourceName);
-				if (!DebugActorForHitRegistrator.Actor) continue;
-
-				for (FString HitRegistratorsName : HitRegistratorsToActivateBySource.HitRegistratorsNames)
-				{
-					for (int32 i = 0; i < DebugActorForHitRegistrator.HitRegistrators.Num(); i++)
-					{
-						UCapsuleHitRegistrator* HitReg = DebugActorForHitRegistrator.HitRegistrators[i].IsValid()
-							? DebugActorForHitRegistrator.HitRegistrators[i].Get()
-							: nullptr;
-						if (!HitReg) continue;
-
-						FString ActorCompName = HitReg->GetName();
-						ActorCompName.RemoveFromEnd(TEXT("_GEN_VARIABLE")); // for blueprint created components
-						if (ActorCompName == HitRegistratorsName)
-						{
-							UE_LOG(LogTemp, Log, TEXT("Found matching hit registrator '%s' at index %d. Socket list size: %d"), *ActorCompName, i, DebugActorForHitRegistrator.HitRegistratorsToAttachSocketsList.Num());
-							FDBSDebugHitRegistratorDescription HitRegistratorDescription = {};
-							FName SocketNameFromBPNode = DebugActorForHitRegistrator.HitRegistratorsToAttachSocketsList.FindRef(HitReg);
-							HitRegistratorDescription.SocketNameAttached = DebugActorForHitRegistrator.bCustomSocketName
-								? DebugActorForHitRegistrator.SocketName
-								: SocketNameFromBPNode;
-							HitRegistratorDescription.Location = HitReg->GetRelativeLocation();
-							HitRegistratorDescription.Rotation = HitReg->GetRelativeRotation();
-							HitRegistratorDescription.CapsuleRadius = HitReg->GetScaledCapsuleRadius();
-							HitRegistratorDescription.CapsuleHalfHeight = HitReg->GetScaledCapsuleHalfHeight();
-							HitRegistratorDescription.Color = HitReg->ShapeColor;
-							HitRegistratorDescription.Thickness = HitReg->GetLineThickness();
-							HitRegistratorsDescription.Add(DebugActorForHitRegistrator.SourceName, HitRegistratorDescription);
-						}
-					}
-				}
-			}
+			HitRegistratorsDescription.Add(HitRegistratorDescription.SourceName, HitRegistratorDescription);
 		}
 		
         // Broadcast preview debug begin
@@ -275,9 +243,156 @@ void UANS_InvokeDamageBehavior::NotifyBegin(USkeletalMeshComponent* MeshComp, UA
 		UDamageBehaviorsComponent* DmgBehaviorComponent = StaticCast<UDamageBehaviorsComponent*>(Component);
 		if (!DmgBehaviorComponent) return;
 		
-		DmgBehaviorComponent->InvokeDamageBehavior(Name, true, GetDamageBehaviorSourcesList(), Payload);
+		DmgBehaviorComponent->InvokeDamageBehaviorByName(CachedName, true, CachedSourcesNames, Payload);
+		ApplyBakedHitWindow(DmgBehaviorComponent, MeshComp, Animation);
+	}
+}
+
+void UANS_InvokeDamageBehavior::ApplyBakedHitWindow(UDamageBehaviorsComponent* DamageBehaviorsComponent, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) const
+{
+	if (!BakedHitWindow.IsValid()) return;
+
+	static IConsoleVariable* CVarDBSBakedHitWindows = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.BakedHitWindows"));
+	if (!CVarDBSBakedHitWindows || !CVarDBSBakedHitWindows->GetBool()) return;
+
+	// only montage windows are baked, montage position drives sampling
+	const UAnimMontage* Montage = Cast<UAnimMontage>(Animation);
+	UAnimInstance* AnimInstance = MeshComp->GetAnimInstance();
+	UDamageBehavior* DamageBehavior = DamageBehaviorsComponent->GetDamageBehaviorByName(CachedName);
+	if (!Montage || !AnimInstance || !DamageBehavior) return;
+
+	FDBSBakedTrajectoryPlayback BakedTrajectory;
+	BakedTrajectory.Montage = Montage;
+	BakedTrajectory.AnimInstance = AnimInstance;
+	BakedTrajectory.MeshComponent = MeshComp;
+	BakedTrajectory.WindowStartTime = BakedHitWindow.StartTime;
+
+	for (const FDBSHitRegistratorsSource& HitRegistratorsSource : DamageBehavior->HitRegistratorsSources)
+	{
+		for (UDBSHitRegistratorBase* HitRegistrator : HitRegistratorsSource.CapsuleHitRegistrators)
+		{
+			if (!IsValid(HitRegistrator) || !HitRegistrator->IsHitRegistrationEnabled()) continue;
+
+			const EDamageBehaviorHitDetectionType HitDetectionType = HitRegistrator->GetHitDetectionType();
+			if (HitDetectionType != EDamageBehaviorHitDetectionType::ByTrace && HitDetectionType != EDamageBehaviorHitDetectionType::ByHurtboxes) continue;
+
+			BakedTrajectory.Track = BakedHitWindow.FindTrack(HitRegistratorsSource.SourceName, HitRegistrator->GetName());
+			if (BakedTrajectory.Track)
+			{
+				HitRegistrator->SetBakedTrajectory(BakedTrajectory);
+			}
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UANS_InvokeDamageBehavior::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	// saving or cooking montage, baker skips windows which inputs didn't change(see FDBSBakedHitWindow::BakeKey)
+	if (!GetDefault<UDamageBehaviorsSystemSettings>()->bBakeHitWindows)
+	{
+		BakedHitWindow = {};
+		return;
+	}
+	FDBSBakedHitWindow NewBakedHitWindow = BakedHitWindow;
+	if (DBS_GetBakeHitWindowDelegate().IsBound() && DBS_GetBakeHitWindowDelegate().Execute(this, NewBakedHitWindow))
+	{
+		BakedHitWindow = MoveTemp(NewBakedHitWindow);
 	}
 }
+#endif
+
+bool UANS_InvokeDamageBehavior::GatherHitRegistratorsDescriptions(const USkeletalMesh* Mesh, TArray<FDBSDebugActor>& DebugActors,
+	TArray<FDBSDebugHitRegistratorDescription>& OutDescriptions) const
+{
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+	const FDBSDebugActorsForMesh* InvokeDamageBehaviorDebugForMeshSearch = DamageBehaviorsSystemSettings->DefaultDebugActorsForPreview.FindByKey(Mesh);
+	
+	// If no specific debug actors found for this mesh, use the fallback mesh
+	if (!InvokeDamageBehaviorDebugForMeshSearch)
+	{
+		DebugActors = DamageBehaviorsSystemSettings->FallbackDebugMesh.DebugActors;
+	}
+	else
+	{
+		const FDBSDebugActorsForMesh& InvokeDamageBehaviorDebugForMesh = *InvokeDamageBehaviorDebugForMeshSearch;
+		DebugActors = InvokeDamageBehaviorDebugForMesh.DebugActors;
+	}
+	
+	if (DebugActors.IsEmpty()) return false;
+	
+	TArray<FString> DamageBehaviorsSourcesList = GetDamageBehaviorSourcesList();
+
+	for (FDBSDebugActor& DebugActor : DebugActors)
+	{
+		DebugActor.FillData();
+	}
+	
+	for (FString DamageBehaviorsSource : DamageBehaviorsSourcesList)
+	{
+		FDBSDebugActor DebugActor = GetFilledDebugActor(DebugActors, DamageBehaviorsSource);
+		if (!DebugActor.IsValid()) continue;
+
+		UDamageBehavior* DamageBehavior = DebugActor.DBC->GetDamageBehavior(Name);
+		if (!DamageBehavior) continue;
+
+		for (FDBSHitRegistratorsToActivateSource HitRegistratorsToActivateBySource : DamageBehavior->HitRegistratorsToActivateBySource)
+		{
+			FDBSDebugActor DebugActorForHitRegistrator = GetFilledDebugActor(DebugActors, HitRegistratorsToActivateBySource.SourceName);
+			if (!DebugActorForHitRegistrator.Actor) continue;
+
+			for (FString HitRegistratorsName : HitRegistratorsToActivateBySource.HitRegistratorsNames)
+			{
+				for (int32 i = 0; i < DebugActorForHitRegistrator.HitRegistrators.Num(); i++)
+				{
+					UDBSHitRegistratorBase* HitReg = DebugActorForHitRegistrator.HitRegistrators[i].IsValid()
+						? DebugActorForHitRegistrator.HitRegistrators[i].Get()
+						: nullptr;
+					if (!HitReg) continue;
+
+					FString ActorCompName = HitReg->GetName();
+					ActorCompName.RemoveFromEnd(TEXT("_GEN_VARIABLE")); // for blueprint created components
+					if (ActorCompName == HitRegistratorsName)
+					{
+						UE_LOG(LogTemp, Log, TEXT("Found matching hit registrator '%s' at index %d. Socket list size: %d"), *ActorCompName, i, DebugActorForHitRegistrator.HitRegistratorsToAttachSocketsList.Num());
+						FDBSDebugHitRegistratorDescription HitRegistratorDescription = {};
+						FName SocketNameFromBPNode = DebugActorForHitRegistrator.HitRegistratorsToAttachSocketsList.FindRef(HitReg);
+						HitRegistratorDescription.SocketNameAttached = DebugActorForHitRegistrator.bCustomSocketName
+							? DebugActorForHitRegistrator.SocketName
+							: SocketNameFromBPNode;
+						HitRegistratorDescription.Location = HitReg->GetRelativeLocation();
+						HitRegistratorDescription.Rotation = HitReg->GetRelativeRotation();
+						const FCollisionShape CollisionShape = HitReg->GetCollisionShape();
+						if (CollisionShape.IsBox())
+						{
+							HitRegistratorDescription.bIsBox = true;
+							HitRegistratorDescription.BoxExtent = CollisionShape.GetExtent();
+							HitRegistratorDescription.CapsuleHalfHeight = CollisionShape.GetExtent().Z;
+						}
+						else if (CollisionShape.IsSphere())
+						{
+							HitRegistratorDescription.CapsuleRadius = CollisionShape.GetSphereRadius();
+							HitRegistratorDescription.CapsuleHalfHeight = CollisionShape.GetSphereRadius();
+						}
+						else
+						{
+							HitRegistratorDescription.CapsuleRadius = CollisionShape.GetCapsuleRadius();
+							HitRegistratorDescription.CapsuleHalfHeight = CollisionShape.GetCapsuleHalfHeight();
+						}
+						HitRegistratorDescription.Color = HitReg->ShapeColor;
+						HitRegistratorDescription.Thickness = HitReg->GetLineThickness();
+						HitRegistratorDescription.SourceName = HitRegistratorsToActivateBySource.SourceName;
+						HitRegistratorDescription.HitRegistratorName = HitRegistratorsName;
+						OutDescriptions.Add(HitRegistratorDescription);
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
 
 void UANS_InvokeDamageBehavior::NotifyTick(
 	USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float FrameDeltaTime,
@@ -317,7 +432,7 @@ void UANS_InvokeDamageBehavior::NotifyEnd(USkeletalMeshComponent* MeshComp, UAni
 		UDamageBehaviorsComponent* DmgBehaviorComponent = StaticCast<UDamageBehaviorsComponent*>(Component);
 		if (!DmgBehaviorComponent) return;
 	
-		DmgBehaviorComponent->InvokeDamageBehavior(Name, false, GetDamageBehaviorSourcesList(), Payload);	
+		DmgBehaviorComponent->InvokeDamageBehaviorByName(CachedName, false, CachedSourcesNames, Payload);	
 	}
 }
 
@@ -334,9 +449,22 @@ TArray<FString> UANS_InvokeDamageBehavior::GetDamageBehaviorSourcesList() const
 	return Result;
 }
 
-FDBSDebugActor UANS_InvokeDamageBehavior::GetFilledDebugActor(FString SourceName)
+TArray<FName> UANS_InvokeDamageBehavior::GetDamageBehaviorSourcesNames() const
 {
-	FDBSDebugActor* DebugActorSearch = FilledDebugActors.FindByPredicate([&](const FDBSDebugActor& DebugActor)
+	TArray<FName> Result = {};
+	for (const TPair<FString, bool>& DamageBehaviorSource : TargetSources)
+	{
+		if (DamageBehaviorSource.Value)
+		{
+			Result.Add(FName(*DamageBehaviorSource.Key));
+		}
+	}
+	return Result;
+}
+
+FDBSDebugActor UANS_InvokeDamageBehavior::GetFilledDebugActor(TArray<FDBSDebugActor>& DebugActors, FString SourceName)
+{
+	FDBSDebugActor* DebugActorSearch = DebugActors.FindByPredicate([&](const FDBSDebugActor& DebugActor)
 		{
 			return DebugActor.SourceName == SourceName;
 		});
@@ -352,9 +480,9 @@ FDBSDebugActor UANS_InvokeDamageBehavior::GetFilledDebugActor(FString SourceName
 
 	// If there is no explicit mapping for the default source ("ThisActor"),
 	// fallback to the first configured debug actor (e.g., a weapon like WP_M_Sword)
-	if (SourceName == DEFAULT_DAMAGE_BEHAVIOR_SOURCE && FilledDebugActors.Num() > 0)
+	if (SourceName == DEFAULT_DAMAGE_BEHAVIOR_SOURCE && DebugActors.Num() > 0)
 	{
-		FDBSDebugActor& First = FilledDebugActors[0];
+		FDBSDebugActor& First = DebugActors[0];
 		if (!First.IsValid())
 		{
 			First.FillData();
@@ -382,18 +510,35 @@ void UANS_InvokeDamageBehavior::DrawCapsules(UWorld* WorldContextObject, USkelet
 		FVector FinalLocation = SocketLocation + FinalRotation.RotateVector(RegistratorsDescription.Value.Location);
 		
 		// Draw each frame without persistence to handle pauses correctly
-		DrawDebugCapsule(
-			WorldContextObject,
-			FinalLocation,
-			RegistratorsDescription.Value.CapsuleHalfHeight,
-			RegistratorsDescription.Value.CapsuleRadius,
-			FinalRotation.Quaternion(),
-			RegistratorsDescription.Value.Color.ToFColor(true),
-			false,  // bPersistentLines - redraw each tick instead
-			-1.0f,  // LifeTime - will be cleared next frame
-			0,      // DepthPriority
-			RegistratorsDescription.Value.Thickness  // Use the component's shape thickness
-		);
+		if (RegistratorsDescription.Value.bIsBox)
+		{
+			DrawDebugBox(
+				WorldContextObject,
+				FinalLocation,
+				RegistratorsDescription.Value.BoxExtent,
+				FinalRotation.Quaternion(),
+				RegistratorsDescription.Value.Color.ToFColor(true),
+				false,
+				-1.0f,
+				0,
+				RegistratorsDescription.Value.Thickness
+			);
+		}
+		else
+		{
+			DrawDebugCapsule(
+				WorldContextObject,
+				FinalLocation,
+				RegistratorsDescription.Value.CapsuleHalfHeight,
+				RegistratorsDescription.Value.CapsuleRadius,
+				FinalRotation.Quaternion(),
+				RegistratorsDescription.Value.Color.ToFColor(true),
+				false,  // bPersistentLines - redraw each tick instead
+				-1.0f,  // LifeTime - will be cleared next frame
+				0,      // DepthPriority
+				RegistratorsDescription.Value.Thickness  // Use the component's shape thickness
+			);
+		}
 
 		if (bUsingFallback)
 		{
@@ -0,0 +1,16 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "BoxHitRegistrator.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BoxHitRegistrator)
+
+FCollisionShape UBoxHitRegistrator::GetUnscaledShape() const
+{
+	return FCollisionShape::MakeBox(BoxExtent);
+}
+
+void UBoxHitRegistrator::SetBoxExtent(FVector BoxExtent_In, bool bUpdateOverlaps)
+{
+	BoxExtent = FVector::Max(FVector::ZeroVector, BoxExtent_In);
+	NotifyShapeChanged(bUpdateOverlaps);
+}
@@ -0,0 +1,78 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "ChainHitRegistrator.h"
+
+#include "PhysicsEngine/BodySetup.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ChainHitRegistrator)
+
+FCollisionShape UChainHitRegistrator::GetUnscaledShape() const
+{
+	float Radius = 0.0f;
+	for (const FDBSChainHitRegistratorSegment& Segment : Segments)
+	{
+		Radius = FMath::Max(Radius, Segment.Location.Size() + FMath::Max(Segment.CapsuleHalfHeight, Segment.CapsuleRadius));
+	}
+	return FCollisionShape::MakeSphere(Radius);
+}
+
+void UChainHitRegistrator::UpdateBodySetup()
+{
+	// one sphyl per segment, ByEntering overlaps whole chain as one body
+	CreateShapeBodySetupIfNeeded<FKSphylElem>();
+	TArray<FKSphylElem>& SphylElems = ShapeBodySetup->AggGeom.SphylElems;
+	SphylElems.SetNum(FMath::Max(1, CachedSegments.Num()));
+	for (int32 i = 0; i < CachedSegments.Num(); i++)
+	{
+		const FCollisionShape& CollisionShape = CachedSegments[i].CollisionShape;
+		SphylElems[i].SetTransform(CachedSegments[i].RelativeTransform);
+		SphylElems[i].Radius = CollisionShape.GetCapsuleRadius();
+		SphylElems[i].Length = 2.0f * FMath::Max(CollisionShape.GetCapsuleHalfHeight() - CollisionShape.GetCapsuleRadius(), 0.0f);
+	}
+}
+
+#if WITH_EDITOR
+void UChainHitRegistrator::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	RebuildCachedSegments();
+	if (bPhysicsStateCreated)
+	{
+		// number of bodies could change, scale update isn't enough
+		RecreatePhysicsState();
+	}
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+#endif
+
+void UChainHitRegistrator::SetSegments(const TArray<FDBSChainHitRegistratorSegment>& Segments_In)
+{
+	Segments = Segments_In;
+	RebuildCachedSegments();
+	UpdateBounds();
+	UpdateBodySetup();
+	MarkRenderStateDirty();
+	if (bPhysicsStateCreated)
+	{
+		RecreatePhysicsState();
+	}
+}
+
+void UChainHitRegistrator::OnRegister()
+{
+	// bounds, body setup and scene proxy built from segments during register
+	RebuildCachedSegments();
+
+	Super::OnRegister();
+}
+
+void UChainHitRegistrator::RebuildCachedSegments()
+{
+	CachedSegments.Reset(Segments.Num());
+	for (const FDBSChainHitRegistratorSegment& Segment : Segments)
+	{
+		FDBSHitRegistratorSegment& CachedSegment = CachedSegments.AddDefaulted_GetRef();
+		CachedSegment.RelativeTransform = FTransform(Segment.Rotation, Segment.Location);
+		CachedSegment.CollisionShape = FCollisionShape::MakeCapsule(Segment.CapsuleRadius, FMath::Max(Segment.CapsuleHalfHeight, Segment.CapsuleRadius));
+	}
+}
@@ -0,0 +1,74 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSBakedTrajectory.h"
+
+#include "Algo/BinarySearch.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSBakedTrajectory)
+
+static FDBSBakeHitWindow GDBSBakeHitWindow;
+
+FDBSBakeHitWindow& DBS_GetBakeHitWindowDelegate()
+{
+	return GDBSBakeHitWindow;
+}
+
+FTransform FDBSBakedTrajectoryTrack::Evaluate(float Time) const
+{
+	const int32 NumKeys = KeyTimes.Num();
+	if (NumKeys == 0) return FTransform::Identity;
+
+	// first key after Time
+	const int32 NextKey = Algo::UpperBound(KeyTimes, Time);
+	if (NextKey == 0) return FTransform(FQuat(KeyRotations[0]), FVector(KeyLocations[0]));
+	if (NextKey == NumKeys) return FTransform(FQuat(KeyRotations[NumKeys - 1]), FVector(KeyLocations[NumKeys - 1]));
+
+	const int32 PrevKey = NextKey - 1;
+	const float Alpha = (Time - KeyTimes[PrevKey]) / FMath::Max(KeyTimes[NextKey] - KeyTimes[PrevKey], UE_KINDA_SMALL_NUMBER);
+	return FTransform(
+		FQuat(FQuat4f::Slerp(KeyRotations[PrevKey], KeyRotations[NextKey], Alpha)),
+		FVector(FMath::Lerp(KeyLocations[PrevKey], KeyLocations[NextKey], Alpha))
+	);
+}
+
+FArchive& operator<<(FArchive& Ar, FDBSBakedTrajectoryTrack& Track)
+{
+	Ar << Track.SourceName;
+	Ar << Track.HitRegistratorName;
+	Ar << Track.KeyTimes;
+	Ar << Track.KeyLocations;
+	Ar << Track.KeyRotations;
+	return Ar;
+}
+
+const FDBSBakedTrajectoryTrack* FDBSBakedHitWindow::FindTrack(const FString& SourceName, const FString& HitRegistratorName) const
+{
+	return Tracks.FindByPredicate([&](const FDBSBakedTrajectoryTrack& Track)
+	{
+		return Track.HitRegistratorName == HitRegistratorName && Track.SourceName == SourceName;
+	});
+}
+
+FArchive& operator<<(FArchive& Ar, FDBSBakedHitWindow& HitWindow)
+{
+	Ar << HitWindow.StartTime;
+	Ar << HitWindow.Duration;
+	Ar << HitWindow.Tracks;
+	return Ar;
+}
+
+bool FDBSBakedTrajectoryPlayback::Evaluate(FTransform& OutTransform) const
+{
+	const UAnimMontage* MontagePtr = Montage.Get();
+	const UAnimInstance* AnimInstancePtr = AnimInstance.Get();
+	const USkeletalMeshComponent* MeshComponentPtr = MeshComponent.Get();
+	if (!Track || !MontagePtr || !AnimInstancePtr || !MeshComponentPtr) return false;
+
+	// montage keeps advancing with pose evaluation disabled(OnlyTickMontagesWhenNotRendered)
+	const float WindowTime = AnimInstancePtr->Montage_GetPosition(MontagePtr) - WindowStartTime;
+	OutTransform = Track->Evaluate(WindowTime) * MeshComponentPtr->GetComponentTransform();
+	return true;
+}
@@ -0,0 +1,316 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSCapsuleSweepKernel.h"
+
+#include "DBSHitRegistratorSweep.h"
+#include "DamageBehaviorsSystemStats.h"
+#include "Algo/Sort.h"
+#include "Math/VectorRegister.h"
+
+DECLARE_CYCLE_STAT(TEXT("Capsule sweep kernel"), STAT_DBS_CapsuleSweepKernel, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capsule sweep kernel targets"), STAT_DBS_CapsuleSweepKernelTargets, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capsule sweep kernel fallbacks"), STAT_DBS_CapsuleSweepKernelFallbacks, STATGROUP_DamageBehaviorsSystem);
+
+void FDBSCapsulesSoA::Reset(const FVector& Origin_In)
+{
+	Origin = Origin_In;
+	NumCapsules = 0;
+	CenterX.Reset();
+	CenterY.Reset();
+	CenterZ.Reset();
+	SegmentX.Reset();
+	SegmentY.Reset();
+	SegmentZ.Reset();
+	Radius.Reset();
+}
+
+int32 FDBSCapsulesSoA::Add(const FVector& Center, const FQuat& Rotation, float Radius_In, float HalfHeight)
+{
+	if (NumCapsules == Radius.Num())
+	{
+		// padding capsule is infinitely far, kernel never reports it
+		for (TArray<float>* Lane : { &CenterX, &CenterY, &CenterZ, &SegmentX, &SegmentY, &SegmentZ })
+		{
+			Lane->AddZeroed(4);
+		}
+		for (int32 i = 0; i < 4; i++)
+		{
+			Radius.Add(-UE_BIG_NUMBER);
+		}
+	}
+
+	const FVector LocalCenter = Center - Origin;
+	const FVector Segment = Rotation.GetUpVector() * FMath::Max(HalfHeight - Radius_In, 0.0f);
+
+	const int32 Index = NumCapsules++;
+	CenterX[Index] = LocalCenter.X;
+	CenterY[Index] = LocalCenter.Y;
+	CenterZ[Index] = LocalCenter.Z;
+	SegmentX[Index] = Segment.X;
+	SegmentY[Index] = Segment.Y;
+	SegmentZ[Index] = Segment.Z;
+	Radius[Index] = Radius_In;
+	return Index;
+}
+
+namespace DBSCapsuleSweepKernel
+{
+	struct FVec3Register
+	{
+		VectorRegister4Float X;
+		VectorRegister4Float Y;
+		VectorRegister4Float Z;
+	};
+
+	FORCEINLINE VectorRegister4Float Dot(const FVec3Register& A, const FVec3Register& B)
+	{
+		return VectorMultiplyAdd(A.X, B.X, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.Z, B.Z)));
+	}
+
+	FORCEINLINE FVec3Register MultiplyAdd(const FVec3Register& A, const VectorRegister4Float& Scale, const FVec3Register& B)
+	{
+		return { VectorMultiplyAdd(A.X, Scale, B.X), VectorMultiplyAdd(A.Y, Scale, B.Y), VectorMultiplyAdd(A.Z, Scale, B.Z) };
+	}
+
+	FORCEINLINE FVec3Register Subtract(const FVec3Register& A, const FVec3Register& B)
+	{
+		return { VectorSubtract(A.X, B.X), VectorSubtract(A.Y, B.Y), VectorSubtract(A.Z, B.Z) };
+	}
+
+	FORCEINLINE FVec3Register Splat(const FVector3f& V)
+	{
+		return { VectorSetFloat1(V.X), VectorSetFloat1(V.Y), VectorSetFloat1(V.Z) };
+	}
+
+	FORCEINLINE VectorRegister4Float Saturate(const VectorRegister4Float& V)
+	{
+		return VectorMin(VectorMax(V, VectorZeroFloat()), VectorOneFloat());
+	}
+
+	// Per target data that doesn't depend on time
+	struct FTargetLanes
+	{
+		// segment start and full segment direction of target
+		FVec3Register P2;
+		FVec3Register D2;
+		VectorRegister4Float B;
+		VectorRegister4Float E;
+		VectorRegister4Float Denom;
+		VectorRegister4Float DenomValidMask;
+	};
+
+	// Closest points between swept segment at time T and target segments, Ericson "Real-Time Collision Detection" 5.1.9
+	// written without branches, degenerated segments(spheres) handled by clamping squared lengths
+	FORCEINLINE VectorRegister4Float SegmentsDistance(
+		const FVec3Register& P1, const FVec3Register& D1, const VectorRegister4Float& A, const FVec3Register& Direction,
+		const FTargetLanes& Target, const VectorRegister4Float& T,
+		FVec3Register& OutClosest1, FVec3Register& OutClosest2)
+	{
+		const FVec3Register P1AtT = MultiplyAdd(Direction, T, P1);
+		const FVec3Register R = Subtract(P1AtT, Target.P2);
+		const VectorRegister4Float C = Dot(D1, R);
+		const VectorRegister4Float F = Dot(Target.D2, R);
+
+		// parallel segments - any S works, take start
+		const VectorRegister4Float SUnclamped = VectorDivide(VectorSubtract(VectorMultiply(Target.B, F), VectorMultiply(C, Target.E)), Target.Denom);
+		VectorRegister4Float S = VectorSelect(Target.DenomValidMask, Saturate(SUnclamped), VectorZeroFloat());
+
+		const VectorRegister4Float TUnclamped = VectorDivide(VectorMultiplyAdd(Target.B, S, F), Target.E);
+		const VectorRegister4Float TClamped = Saturate(TUnclamped);
+		// closest point on target clamped - recompute closest point on swept segment
+		const VectorRegister4Float SRecomputed = Saturate(VectorDivide(VectorSubtract(VectorMultiply(Target.B, TClamped), C), A));
+		S = VectorSelect(VectorCompareNE(TUnclamped, TClamped), SRecomputed, S);
+
+		OutClosest1 = MultiplyAdd(D1, S, P1AtT);
+		OutClosest2 = MultiplyAdd(Target.D2, TClamped, Target.P2);
+		const FVec3Register Diff = Subtract(OutClosest1, OutClosest2);
+		return VectorSqrt(Dot(Diff, Diff));
+	}
+}
+
+void FDBSCapsuleSweepKernel::SweepCapsuleAgainstCapsules(const FDBSHitRegistratorSweep& Sweep, const FDBSCapsulesSoA& Targets, TArray<FDBSCapsuleSweepHit>& OutHits)
+{
+	using namespace DBSCapsuleSweepKernel;
+
+	SCOPE_CYCLE_COUNTER(STAT_DBS_CapsuleSweepKernel);
+	INC_DWORD_STAT_BY(STAT_DBS_CapsuleSweepKernelTargets, Targets.Num());
+
+	const int32 FirstHit = OutHits.Num();
+	if (Targets.Num() == 0) return;
+
+	const float SweepRadius = Sweep.CollisionShape.GetCapsuleRadius();
+	const float SweepHalfHeight = Sweep.CollisionShape.GetCapsuleHalfHeight();
+	const FVector3f SweepSegment = FVector3f(Sweep.Rotation.GetUpVector() * FMath::Max(SweepHalfHeight - SweepRadius, 0.0f));
+	const FVector3f SweepDirection = FVector3f(Sweep.End - Sweep.Start);
+	const float SweepLength = SweepDirection.Size();
+
+	// swept segment at T = 0, relative to targets origin so floats keep precision in large worlds
+	const FVector3f LocalStart = FVector3f(Sweep.Start - Targets.Origin);
+	const FVec3Register P1 = Splat(LocalStart - SweepSegment);
+	const FVec3Register D1 = Splat(SweepSegment * 2.0f);
+	const FVec3Register Direction = Splat(SweepDirection);
+	const VectorRegister4Float Epsilon = VectorSetFloat1(UE_SMALL_NUMBER);
+	const VectorRegister4Float A = VectorMax(Dot(D1, D1), Epsilon);
+	// zero length sweep - only overlap at T = 0 is checked, any gap moves T past 1
+	const VectorRegister4Float InvSweepLength = VectorSetFloat1(1.0f / FMath::Max(SweepLength, UE_SMALL_NUMBER));
+	const VectorRegister4Float SweepRadiusRegister = VectorSetFloat1(SweepRadius);
+	const VectorRegister4Float ToleranceRegister = VectorSetFloat1(Tolerance);
+	const VectorRegister4Float ZeroRegister = VectorZeroFloat();
+	const VectorRegister4Float OneRegister = VectorOneFloat();
+
+	alignas(16) float TimeLanes[4];
+	alignas(16) float ClosestLanes[6][4];
+
+	for (int32 Lane = 0; Lane < Targets.NumPadded(); Lane += 4)
+	{
+		const FVec3Register Center = { VectorLoad(&Targets.CenterX[Lane]), VectorLoad(&Targets.CenterY[Lane]), VectorLoad(&Targets.CenterZ[Lane]) };
+		const FVec3Register Segment = { VectorLoad(&Targets.SegmentX[Lane]), VectorLoad(&Targets.SegmentY[Lane]), VectorLoad(&Targets.SegmentZ[Lane]) };
+		const VectorRegister4Float TargetRadius = VectorLoad(&Targets.Radius[Lane]);
+		const VectorRegister4Float RadiusSum = VectorAdd(SweepRadiusRegister, TargetRadius);
+
+		FTargetLanes Target;
+		Target.P2 = Subtract(Center, Segment);
+		Target.D2 = { VectorAdd(Segment.X, Segment.X), VectorAdd(Segment.Y, Segment.Y), VectorAdd(Segment.Z, Segment.Z) };
+		Target.B = Dot(D1, Target.D2);
+		Target.E = VectorMax(Dot(Target.D2, Target.D2), Epsilon);
+		Target.Denom = VectorSubtract(VectorMultiply(A, Target.E), VectorMultiply(Target.B, Target.B));
+		Target.DenomValidMask = VectorCompareGT(Target.Denom, Epsilon);
+		Target.Denom = VectorMax(Target.Denom, Epsilon);
+
+		// conservative advancement - capsule can't get closer than it traveled,
+		// so stepping by gap never passes time of impact
+		VectorRegister4Float T = ZeroRegister;
+		VectorRegister4Float HitMask = VectorCompareGT(ZeroRegister, OneRegister);
+		VectorRegister4Float ActiveMask = VectorCompareGT(OneRegister, ZeroRegister);
+		FVec3Register Closest1;
+		FVec3Register Closest2;
+		for (int32 Iteration = 0; Iteration < MaxIterations; Iteration++)
+		{
+			const VectorRegister4Float Distance = SegmentsDistance(P1, D1, A, Direction, Target, T, Closest1, Closest2);
+			const VectorRegister4Float Gap = VectorSubtract(Distance, RadiusSum);
+			const VectorRegister4Float TouchingMask = VectorCompareLE(Gap, ToleranceRegister);
+
+			HitMask = VectorBitwiseOr(HitMask, VectorBitwiseAnd(ActiveMask, TouchingMask));
+			ActiveMask = VectorBitwiseAnd(ActiveMask, VectorCompareGT(Gap, ToleranceRegister));
+			T = VectorSelect(ActiveMask, VectorMultiplyAdd(Gap, InvSweepLength, T), T);
+			ActiveMask = VectorBitwiseAnd(ActiveMask, VectorCompareLE(T, OneRegister));
+
+			if (VectorMaskBits(ActiveMask) == 0) break;
+		}
+
+		// still approaching after MaxIterations - long grazing sweeps, advancement steps get tiny.
+		// Distance to translating convex shape is convex in T, so find its minimum over rest of sweep
+		// and bisect to first touch instead of dropping the lane as miss
+		if (VectorMaskBits(ActiveMask) != 0)
+		{
+			INC_DWORD_STAT(STAT_DBS_CapsuleSweepKernelFallbacks);
+
+			const VectorRegister4Float ThirdRegister = VectorSetFloat1(1.0f / 3.0f);
+			const VectorRegister4Float HalfRegister = VectorSetFloat1(0.5f);
+			VectorRegister4Float Low = T;
+			VectorRegister4Float High = OneRegister;
+			for (int32 Iteration = 0; Iteration < FallbackIterations; Iteration++)
+			{
+				const VectorRegister4Float Step = VectorMultiply(VectorSubtract(High, Low), ThirdRegister);
+				const VectorRegister4Float T1 = VectorAdd(Low, Step);
+				const VectorRegister4Float T2 = VectorSubtract(High, Step);
+				const VectorRegister4Float Distance1 = SegmentsDistance(P1, D1, A, Direction, Target, T1, Closest1, Closest2);
+				const VectorRegister4Float Distance2 = SegmentsDistance(P1, D1, A, Direction, Target, T2, Closest1, Closest2);
+				const VectorRegister4Float MinimumBeforeT2Mask = VectorCompareLT(Distance1, Distance2);
+				High = VectorSelect(MinimumBeforeT2Mask, T2, High);
+				Low = VectorSelect(MinimumBeforeT2Mask, Low, T1);
+			}
+
+			const VectorRegister4Float TMinimum = VectorMultiply(VectorAdd(Low, High), HalfRegister);
+			const VectorRegister4Float MinimumGap = VectorSubtract(
+				SegmentsDistance(P1, D1, A, Direction, Target, TMinimum, Closest1, Closest2), RadiusSum);
+			const VectorRegister4Float FallbackHitMask = VectorBitwiseAnd(ActiveMask, VectorCompareLE(MinimumGap, ToleranceRegister));
+
+			// gap decreases on T..TMinimum, High always touching
+			Low = T;
+			High = TMinimum;
+			for (int32 Iteration = 0; Iteration < FallbackIterations; Iteration++)
+			{
+				const VectorRegister4Float Middle = VectorMultiply(VectorAdd(Low, High), HalfRegister);
+				const VectorRegister4Float Gap = VectorSubtract(
+					SegmentsDistance(P1, D1, A, Direction, Target, Middle, Closest1, Closest2), RadiusSum);
+				const VectorRegister4Float TouchingMask = VectorCompareLE(Gap, ToleranceRegister);
+				High = VectorSelect(TouchingMask, Middle, High);
+				Low = VectorSelect(TouchingMask, Low, Middle);
+			}
+
+			T = VectorSelect(FallbackHitMask, High, T);
+			HitMask = VectorBitwiseOr(HitMask, FallbackHitMask);
+			// closest points of every lane at its final T
+			SegmentsDistance(P1, D1, A, Direction, Target, T, Closest1, Closest2);
+		}
+
+		const int32 HitBits = VectorMaskBits(HitMask);
+		if (HitBits == 0) continue;
+
+		// touching lanes stopped advancing, closest points of last iteration are at their time of impact
+		VectorStoreAligned(T, TimeLanes);
+		VectorStoreAligned(Closest1.X, ClosestLanes[0]);
+		VectorStoreAligned(Closest1.Y, ClosestLanes[1]);
+		VectorStoreAligned(Closest1.Z, ClosestLanes[2]);
+		VectorStoreAligned(Closest2.X, ClosestLanes[3]);
+		VectorStoreAligned(Closest2.Y, ClosestLanes[4]);
+		VectorStoreAligned(Closest2.Z, ClosestLanes[5]);
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			if (!(HitBits & (1 << i)) || Lane + i >= Targets.Num()) continue;
+
+			const FVector Closest1Local(ClosestLanes[0][i], ClosestLanes[1][i], ClosestLanes[2][i]);
+			const FVector Closest2Local(ClosestLanes[3][i], ClosestLanes[4][i], ClosestLanes[5][i]);
+			const FVector Diff = Closest1Local - Closest2Local;
+			const double Distance = Diff.Size();
+
+			FDBSCapsuleSweepHit& SweepHit = OutHits.AddDefaulted_GetRef();
+			SweepHit.TargetIndex = Lane + i;
+			SweepHit.Time = TimeLanes[i];
+			SweepHit.Location = FMath::Lerp(Sweep.Start, Sweep.End, static_cast<double>(TimeLanes[i]));
+			// segments intersect - no separating direction, push back against sweep
+			SweepHit.ImpactNormal = Distance > UE_KINDA_SMALL_NUMBER
+				? Diff / Distance
+				: -FVector(SweepDirection.GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector));
+			SweepHit.ImpactPoint = Targets.Origin + Closest2Local + SweepHit.ImpactNormal * Targets.Radius[Lane + i];
+			SweepHit.bStartPenetrating = TimeLanes[i] <= 0.0f && Distance < SweepRadius + Targets.Radius[Lane + i];
+		}
+	}
+
+	// same order as SweepMultiByChannel results
+	Algo::SortBy(MakeArrayView(OutHits.GetData() + FirstHit, OutHits.Num() - FirstHit), &FDBSCapsuleSweepHit::Time);
+}
+
+void FDBSCapsuleSweepKernel::MakeHitResult(const FDBSHitRegistratorSweep& Sweep, const FDBSCapsuleSweepHit& SweepHit, FHitResult& OutHitResult)
+{
+	OutHitResult.Init(Sweep.Start, Sweep.End);
+	OutHitResult.bBlockingHit = true;
+	OutHitResult.bStartPenetrating = SweepHit.bStartPenetrating;
+	OutHitResult.Time = SweepHit.Time;
+	OutHitResult.Distance = FVector::Dist(Sweep.Start, Sweep.End) * SweepHit.Time;
+	OutHitResult.Location = SweepHit.Location;
+	OutHitResult.ImpactPoint = SweepHit.ImpactPoint;
+	OutHitResult.Normal = SweepHit.ImpactNormal;
+	OutHitResult.ImpactNormal = SweepHit.ImpactNormal;
+	OutHitResult.Item = SweepHit.TargetIndex;
+}
+
+FCollisionShape FDBSCapsuleSweepKernel::MakeSweepCapsule(const FCollisionShape& CollisionShape)
+{
+	switch (CollisionShape.ShapeType)
+	{
+		case ECollisionShape::Sphere:
+			return FCollisionShape::MakeCapsule(CollisionShape.GetSphereRadius(), CollisionShape.GetSphereRadius());
+		case ECollisionShape::Box:
+		{
+			// circle around XY face, box corners covered by hemispheres
+			const FVector Extent = CollisionShape.GetExtent();
+			const float Radius = FMath::Sqrt(FMath::Square(Extent.X) + FMath::Square(Extent.Y));
+			return FCollisionShape::MakeCapsule(Radius, Extent.Z + Radius);
+		}
+		default:
+			return CollisionShape;
+	}
+}
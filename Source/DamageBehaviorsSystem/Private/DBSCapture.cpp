@@ -0,0 +1,416 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSCapture.h"
+
+#include "DamageBehavior.h"
+#include "DamageBehaviorsComponent.h"
+#include "DamageBehaviorsSystemStats.h"
+#include "DBSHitRegistratorSweep.h"
+#include "DBSHitRegistratorBase.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "StructUtils/InstancedStruct.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UnrealType.h"
+
+#include <atomic>
+
+DECLARE_CYCLE_STAT(TEXT("Capture record"), STAT_DBS_CaptureRecord, STATGROUP_DamageBehaviorsSystem);
+
+bool FDBSCapture::bIsCapturing = false;
+
+namespace
+{
+	// chunk handed to writer thread when filled over this
+	constexpr int32 CaptureChunkSize = 64 * 1024;
+
+	class FDBSCaptureWriter : public FRunnable
+	{
+	public:
+		explicit FDBSCaptureWriter(FArchive* Archive_In)
+			: Archive(Archive_In)
+		{
+			WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+			Thread = FRunnableThread::Create(this, TEXT("DBSCaptureWriter"), 0, TPri_BelowNormal);
+		}
+
+		virtual ~FDBSCaptureWriter() override
+		{
+			bIsStopRequested = true;
+			WakeEvent->Trigger();
+			Thread->WaitForCompletion();
+			delete Thread;
+			FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+			delete Archive;
+		}
+
+		void Enqueue(TArray<uint8>&& Chunk)
+		{
+			FilledChunks.Enqueue(MoveTemp(Chunk));
+			WakeEvent->Trigger();
+		}
+
+		// written chunk memory, empty array if writer didn't return any yet
+		TArray<uint8> AcquireChunk()
+		{
+			TArray<uint8> Chunk;
+			FreeChunks.Dequeue(Chunk);
+			return Chunk;
+		}
+
+		virtual uint32 Run() override
+		{
+			while (true)
+			{
+				// read before draining, chunks enqueued before stop are still written
+				const bool bShouldStop = bIsStopRequested;
+				TArray<uint8> Chunk;
+				while (FilledChunks.Dequeue(Chunk))
+				{
+					Archive->Serialize(Chunk.GetData(), Chunk.Num());
+					Chunk.Reset();
+					FreeChunks.Enqueue(MoveTemp(Chunk));
+				}
+				if (bShouldStop) break;
+				WakeEvent->Wait();
+			}
+			Archive->Flush();
+			return 0;
+		}
+
+	private:
+		FArchive* Archive = nullptr;
+		FRunnableThread* Thread = nullptr;
+		FEvent* WakeEvent = nullptr;
+		std::atomic<bool> bIsStopRequested = false;
+		// game thread -> writer
+		TQueue<TArray<uint8>, EQueueMode::Spsc> FilledChunks;
+		// writer -> game thread
+		TQueue<TArray<uint8>, EQueueMode::Spsc> FreeChunks;
+	};
+
+	struct FDBSCaptureState
+	{
+		TUniquePtr<FDBSCaptureWriter> Writer;
+		TArray<uint8> Chunk;
+		TMap<FObjectKey, uint32> ObjectIds;
+		uint64 LastFrame = MAX_uint64;
+
+		template<typename T>
+		void Write(const T& Value)
+		{
+			const int32 Offset = Chunk.AddUninitialized(sizeof(T));
+			FMemory::Memcpy(Chunk.GetData() + Offset, &Value, sizeof(T));
+		}
+
+		void WriteType(EDBSCaptureRecordType Type) { Write(static_cast<uint8>(Type)); }
+
+		void WriteString(const FString& String)
+		{
+			const FTCHARToUTF8 Utf8(*String);
+			const uint16 Length = static_cast<uint16>(FMath::Min(Utf8.Length(), static_cast<int32>(MAX_uint16)));
+			Write(Length);
+			Chunk.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+		}
+
+		void WriteFrame(const UObject* WorldContextObject)
+		{
+			if (LastFrame == GFrameCounter) return;
+			LastFrame = GFrameCounter;
+
+			const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+			WriteType(EDBSCaptureRecordType::Frame);
+			Write(static_cast<uint64>(GFrameCounter));
+			Write(World ? World->GetTimeSeconds() : 0.0);
+		}
+
+		// Name record written first time object seen, 0 - null
+		uint32 GetObjectId(const UObject* Object)
+		{
+			if (!Object) return 0;
+
+			if (const uint32* Id = ObjectIds.Find(Object)) return *Id;
+
+			const uint32 Id = ObjectIds.Num() + 1;
+			ObjectIds.Add(Object, Id);
+			WriteType(EDBSCaptureRecordType::Name);
+			Write(Id);
+			// path inside world is stable between runs of same map
+			WriteString(Object->GetPathName(Object->GetWorld()));
+			return Id;
+		}
+
+		void SubmitChunkIfFull(bool bForce = false)
+		{
+			if (Chunk.IsEmpty() || (!bForce && Chunk.Num() < CaptureChunkSize)) return;
+
+			Writer->Enqueue(MoveTemp(Chunk));
+			Chunk = Writer->AcquireChunk();
+			Chunk.Reserve(CaptureChunkSize + 1024);
+		}
+	};
+
+	TUniquePtr<FDBSCaptureState> CaptureState;
+
+	uint32 HashStruct(const UStruct* Struct, const void* Memory, uint32 Hash);
+
+	// names and objects hashed by string, FName/pointer hashes differ between runs
+	uint32 HashPropertyValue(const FProperty* Property, const void* Value)
+	{
+		if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+		{
+			// FName is case insensitive, its display case depends on which spelling was registered first
+			return FCrc::StrCrc32(*NameProperty->GetPropertyValue(Value).ToString().ToLower());
+		}
+		if (const FSoftObjectProperty* SoftObjectProperty = CastField<FSoftObjectProperty>(Property))
+		{
+			return FCrc::StrCrc32(*SoftObjectProperty->GetPropertyValue(Value).ToString());
+		}
+		if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+		{
+			const UObject* Object = ObjectProperty->GetObjectPropertyValue(Value);
+			return Object ? FCrc::StrCrc32(*Object->GetPathName()) : 0;
+		}
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			return HashStruct(StructProperty->Struct, Value, 0);
+		}
+		if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+			uint32 Hash = ArrayHelper.Num();
+			for (int32 i = 0; i < ArrayHelper.Num(); i++)
+			{
+				Hash = HashCombine(Hash, HashPropertyValue(ArrayProperty->Inner, ArrayHelper.GetRawPtr(i)));
+			}
+			return Hash;
+		}
+		return Property->HasAnyPropertyFlags(CPF_HasGetValueTypeHash) ? Property->GetValueTypeHash(Value) : 0;
+	}
+
+	uint32 HashStruct(const UStruct* Struct, const void* Memory, uint32 Hash)
+	{
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			for (int32 i = 0; i < It->ArrayDim; i++)
+			{
+				Hash = HashCombine(Hash, HashPropertyValue(*It, It->ContainerPtrToValuePtr<void>(Memory, i)));
+			}
+		}
+		return Hash;
+	}
+
+	// deterministic between runs, memory of struct could contain padding/pointers
+	uint32 HashPayload(const FInstancedStruct& Payload)
+	{
+		const UScriptStruct* ScriptStruct = Payload.GetScriptStruct();
+		if (!ScriptStruct) return 0;
+
+		return HashStruct(ScriptStruct, Payload.GetMemory(), FCrc::StrCrc32(*ScriptStruct->GetPathName()));
+	}
+
+	template<typename T>
+	bool Read(const TArray<uint8>& Data, int32& Offset, T& OutValue)
+	{
+		if (Offset + static_cast<int32>(sizeof(T)) > Data.Num()) return false;
+
+		FMemory::Memcpy(&OutValue, Data.GetData() + Offset, sizeof(T));
+		Offset += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(const TArray<uint8>& Data, int32& Offset, FString& OutString)
+	{
+		uint16 Length = 0;
+		if (!Read(Data, Offset, Length) || Offset + Length > Data.Num()) return false;
+
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Data.GetData() + Offset), Length);
+		OutString = FString(Converted.Length(), Converted.Get());
+		Offset += Length;
+		return true;
+	}
+}
+
+bool FDBSCapture::Start(const FString& FilePath)
+{
+	check(IsInGameThread());
+	if (bIsCapturing) return true;
+
+	const FString CaptureFilePath = !FilePath.IsEmpty()
+		? FilePath
+		: FPaths::ProjectSavedDir() / TEXT("DamageBehaviorsSystem/Captures") / FDateTime::Now().ToString() + TEXT(".dbscap");
+	FArchive* Archive = IFileManager::Get().CreateFileWriter(*CaptureFilePath);
+	if (!Archive)
+	{
+		UE_LOG(LogDamageBehaviorsSystem, Warning, TEXT("Can't open capture file %s"), *CaptureFilePath);
+		return false;
+	}
+
+	CaptureState = MakeUnique<FDBSCaptureState>();
+	CaptureState->Writer = MakeUnique<FDBSCaptureWriter>(Archive);
+	CaptureState->Chunk.Reserve(CaptureChunkSize + 1024);
+	CaptureState->Write(Magic);
+	CaptureState->Write(Version);
+	bIsCapturing = true;
+
+	UE_LOG(LogDamageBehaviorsSystem, Log, TEXT("Capture started %s"), *CaptureFilePath);
+	return true;
+}
+
+void FDBSCapture::Stop()
+{
+	check(IsInGameThread());
+	if (!bIsCapturing) return;
+
+	bIsCapturing = false;
+	CaptureState->SubmitChunkIfFull(true);
+	// writer drains queue and closes file
+	CaptureState.Reset();
+	UE_LOG(LogDamageBehaviorsSystem, Log, TEXT("Capture stopped"));
+}
+
+void FDBSCapture::RecordActivation(const UDamageBehavior* DamageBehavior, bool bIsActive, const FInstancedStruct& Payload)
+{
+	if (!bIsCapturing) return;
+	SCOPE_CYCLE_COUNTER(STAT_DBS_CaptureRecord);
+
+	FDBSCaptureState& State = *CaptureState;
+	State.WriteFrame(DamageBehavior);
+	const uint32 BehaviorId = State.GetObjectId(DamageBehavior);
+	const uint32 OwnerId = State.GetObjectId(DamageBehavior->GetOwningActor());
+
+	State.WriteType(EDBSCaptureRecordType::Activation);
+	State.Write(BehaviorId);
+	State.Write(OwnerId);
+	State.Write(static_cast<uint8>(bIsActive));
+	State.Write(HashPayload(Payload));
+	State.SubmitChunkIfFull();
+}
+
+void FDBSCapture::RecordSweep(const FDBSHitRegistratorSweep& Sweep, uint32 HitRegistrationWindow)
+{
+	if (!bIsCapturing) return;
+	SCOPE_CYCLE_COUNTER(STAT_DBS_CaptureRecord);
+
+	FDBSCaptureState& State = *CaptureState;
+	State.WriteFrame(Sweep.HitRegistrator);
+	const uint32 HitRegistratorId = State.GetObjectId(Sweep.HitRegistrator);
+	const uint16 NumHits = static_cast<uint16>(FMath::Min(Sweep.HitResults.Num(), static_cast<int32>(MAX_uint16)));
+
+	// ids of hit objects resolved first, their Name records can't be inside Sweep record
+	TArray<TPair<uint32, uint32>, TInlineAllocator<16>> HitIds;
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		const FHitResult& HitResult = Sweep.HitResults[i];
+		HitIds.Emplace(State.GetObjectId(HitResult.GetActor()), State.GetObjectId(HitResult.GetComponent()));
+	}
+
+	State.WriteType(EDBSCaptureRecordType::Sweep);
+	State.Write(HitRegistratorId);
+	State.Write(HitRegistrationWindow);
+	State.Write(FVector3f(Sweep.Start));
+	State.Write(FVector3f(Sweep.End));
+	State.Write(FQuat4f(Sweep.Rotation));
+	State.Write(static_cast<uint8>(Sweep.CollisionShape.ShapeType));
+	State.Write(FVector3f(Sweep.CollisionShape.GetExtent()));
+	State.Write(static_cast<uint8>(Sweep.TraceChannel));
+	State.Write(static_cast<uint8>(Sweep.Hurtboxes != nullptr));
+	State.Write(NumHits);
+
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		const FHitResult& HitResult = Sweep.HitResults[i];
+		State.WriteType(EDBSCaptureRecordType::SweepHit);
+		State.Write(HitIds[i].Key);
+		State.Write(HitIds[i].Value);
+		State.Write(FVector3f(HitResult.ImpactPoint));
+		State.Write(HitResult.Time);
+		State.Write(static_cast<uint8>(HitResult.bStartPenetrating));
+	}
+	State.SubmitChunkIfFull();
+}
+
+void FDBSCapture::RecordHitDecision(const UDamageBehavior* DamageBehavior, const AActor* HitActor, EDBSCaptureHitDecision Decision)
+{
+	if (!bIsCapturing) return;
+	SCOPE_CYCLE_COUNTER(STAT_DBS_CaptureRecord);
+
+	FDBSCaptureState& State = *CaptureState;
+	State.WriteFrame(DamageBehavior);
+	const uint32 BehaviorId = State.GetObjectId(DamageBehavior);
+	const uint32 HitActorId = State.GetObjectId(HitActor);
+
+	State.WriteType(EDBSCaptureRecordType::HitDecision);
+	State.Write(BehaviorId);
+	State.Write(HitActorId);
+	State.Write(static_cast<uint8>(Decision));
+	State.SubmitChunkIfFull();
+}
+
+bool FDBSCapture::ReadCapture(const FString& FilePath, TFunctionRef<void(const FDBSCaptureRecord&)> Visitor)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath)) return false;
+
+	int32 Offset = 0;
+	uint32 FileMagic = 0;
+	uint32 FileVersion = 0;
+	if (!Read(Data, Offset, FileMagic) || !Read(Data, Offset, FileVersion)) return false;
+	if (FileMagic != Magic || FileVersion != Version) return false;
+
+	FDBSCaptureRecord Record;
+	uint8 Type = 0;
+	while (Read(Data, Offset, Type))
+	{
+		Record.Type = static_cast<EDBSCaptureRecordType>(Type);
+		uint8 Flag = 0;
+		bool bIsRead = true;
+		switch (Record.Type)
+		{
+			case EDBSCaptureRecordType::Frame:
+				bIsRead = Read(Data, Offset, Record.Frame) && Read(Data, Offset, Record.WorldTime);
+				break;
+			case EDBSCaptureRecordType::Name:
+				bIsRead = Read(Data, Offset, Record.Id) && ReadString(Data, Offset, Record.Name);
+				break;
+			case EDBSCaptureRecordType::Activation:
+				bIsRead = Read(Data, Offset, Record.BehaviorId) && Read(Data, Offset, Record.OwnerId)
+					&& Read(Data, Offset, Flag) && Read(Data, Offset, Record.PayloadHash);
+				Record.bIsActive = Flag != 0;
+				break;
+			case EDBSCaptureRecordType::Sweep:
+			{
+				uint8 HurtboxesFlag = 0;
+				bIsRead = Read(Data, Offset, Record.HitRegistratorId) && Read(Data, Offset, Record.HitRegistrationWindow)
+					&& Read(Data, Offset, Record.Start) && Read(Data, Offset, Record.End) && Read(Data, Offset, Record.Rotation)
+					&& Read(Data, Offset, Record.ShapeType) && Read(Data, Offset, Record.ShapeExtent)
+					&& Read(Data, Offset, Record.TraceChannel) && Read(Data, Offset, HurtboxesFlag) && Read(Data, Offset, Record.NumHits);
+				Record.bByHurtboxes = HurtboxesFlag != 0;
+				break;
+			}
+			case EDBSCaptureRecordType::SweepHit:
+				bIsRead = Read(Data, Offset, Record.HitActorId) && Read(Data, Offset, Record.HitComponentId)
+					&& Read(Data, Offset, Record.ImpactPoint) && Read(Data, Offset, Record.Time) && Read(Data, Offset, Flag);
+				Record.bStartPenetrating = Flag != 0;
+				break;
+			case EDBSCaptureRecordType::HitDecision:
+				bIsRead = Read(Data, Offset, Record.BehaviorId) && Read(Data, Offset, Record.HitActorId) && Read(Data, Offset, Flag);
+				Record.Decision = static_cast<EDBSCaptureHitDecision>(Flag);
+				break;
+			default:
+				// unknown record, rest of file can't be parsed
+				bIsRead = false;
+				break;
+		}
+		if (!bIsRead) break;
+
+		Visitor(Record);
+	}
+	return true;
+}
@@ -0,0 +1,87 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHitPolicy.h"
+
+#include "Templates/TypeHash.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSHitPolicy)
+
+const FDBSHitActorsSet::FEntry* FDBSHitActorsSet::Find(const UObject* Object) const
+{
+	if (!Object || NumEntries == 0) return nullptr;
+
+	const int32 Slot = FindSlot(FObjectKey(Object));
+	return Entries[Slot].Generation == Generation ? &Entries[Slot] : nullptr;
+}
+
+void FDBSHitActorsSet::Add(const UObject* Object, double Time, uint32 HitSerial)
+{
+	if (!Object) return;
+
+	const FObjectKey Key(Object);
+	int32 Slot = Entries.Num() > 0 ? FindSlot(Key) : INDEX_NONE;
+	if (Slot == INDEX_NONE || Entries[Slot].Generation != Generation)
+	{
+		// load factor kept under 0.5 so probing stays short with 100+ targets,
+		// grown only when new key really added
+		if ((NumEntries + 1) * 2 > Entries.Num())
+		{
+			Grow();
+			Slot = FindSlot(Key);
+		}
+
+		FEntry& Entry = Entries[Slot];
+		Entry.Key = Key;
+		Entry.Generation = Generation;
+		Entry.Hits = 0;
+		Entry.LastHitSerial = HitSerial - 1;
+		NumEntries++;
+	}
+
+	FEntry& Entry = Entries[Slot];
+	if (Entry.LastHitSerial != HitSerial)
+	{
+		Entry.Hits++;
+		Entry.LastHitSerial = HitSerial;
+	}
+	Entry.LastHitTime = Time;
+}
+
+void FDBSHitActorsSet::Reset()
+{
+	NumEntries = 0;
+	Generation++;
+	if (Generation == 0)
+	{
+		// wrapped around, old slots could look alive
+		for (FEntry& Entry : Entries)
+		{
+			Entry.Generation = 0;
+		}
+		Generation = 1;
+	}
+}
+
+int32 FDBSHitActorsSet::FindSlot(const FObjectKey& Key) const
+{
+	const uint32 Mask = static_cast<uint32>(Entries.Num() - 1);
+	uint32 Slot = MurmurFinalize32(GetTypeHash(Key)) & Mask;
+	// no removals inside generation, first free slot ends the probe
+	while (Entries[Slot].Generation == Generation && Entries[Slot].Key != Key)
+	{
+		Slot = (Slot + 1) & Mask;
+	}
+	return static_cast<int32>(Slot);
+}
+
+void FDBSHitActorsSet::Grow()
+{
+	TArray<FEntry> OldEntries = MoveTemp(Entries);
+	Entries.SetNum(FMath::Max(MinCapacity, OldEntries.Num() * 2));
+
+	for (const FEntry& OldEntry : OldEntries)
+	{
+		if (OldEntry.Generation != Generation) continue;
+		Entries[FindSlot(OldEntry.Key)] = OldEntry;
+	}
+}
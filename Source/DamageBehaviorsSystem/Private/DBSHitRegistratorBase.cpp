@@ -0,0 +1,1287 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DBSHitRegistratorBase.h"
+
+#include "DBSCapsuleSweepKernel.h"
+#include "DBSCapture.h"
+#include "DBSHittableActorsSubsystem.h"
+#include "DBSHurtboxesSubsystem.h"
+#include "DamageBehaviorsSubsystem.h"
+#include "DamageBehaviorsSystemSettings.h"
+#include "DamageBehaviorsSystemStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "SceneView.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSHitRegistratorBase)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async sweeps submitted"), STAT_DBS_AsyncSweepsSubmitted, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async sweeps delivered"), STAT_DBS_AsyncSweepsDelivered, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async sweeps flushed synchronously"), STAT_DBS_AsyncSweepsFlushed, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async sweeps expired"), STAT_DBS_AsyncSweepsExpired, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sweep substeps"), STAT_DBS_SweepSubsteps, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Query params rebuilds"), STAT_DBS_QueryParamsRebuilds, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Query params rebuilds skipped"), STAT_DBS_QueryParamsRebuildsSkipped, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits dispatched"), STAT_DBS_HitsDispatched, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Dispatch hit"), STAT_DBS_DispatchHit, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared sweeps skipped"), STAT_DBS_SharedSweepsSkipped, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlap queries"), STAT_DBS_OverlapQueries, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sweeps deferred by skipped animation"), STAT_DBS_AnimSkippedSweepsDeferred, STATGROUP_DamageBehaviorsSystem);
+// same scene, same swings - compare costs of shapes
+DECLARE_CYCLE_STAT(TEXT("Sweep capsule"), STAT_DBS_SweepCapsule, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Sweep sphere"), STAT_DBS_SweepSphere, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Sweep box"), STAT_DBS_SweepBox, STATGROUP_DamageBehaviorsSystem);
+
+namespace
+{
+	// registrator scratch batch, or own empty batch when scratch already used higher in the stack
+	struct FDBSScopedScratchSweepBatch
+	{
+		FDBSScopedScratchSweepBatch(FDBSHitRegistratorSweepBatch& ScratchSweepBatch_In, bool& bIsScratchSweepBatchInUse_In)
+			: ScratchSweepBatch(ScratchSweepBatch_In)
+			, bIsScratchSweepBatchInUse(bIsScratchSweepBatchInUse_In)
+			, bOwnsScratch(!bIsScratchSweepBatchInUse_In)
+		{
+			bIsScratchSweepBatchInUse = true;
+		}
+
+		~FDBSScopedScratchSweepBatch()
+		{
+			if (!bOwnsScratch) return;
+			ScratchSweepBatch.Reset();
+			bIsScratchSweepBatchInUse = false;
+		}
+
+		FDBSHitRegistratorSweepBatch& Get() { return bOwnsScratch ? ScratchSweepBatch : NestedSweepBatch; }
+
+	private:
+		FDBSHitRegistratorSweepBatch& ScratchSweepBatch;
+		bool& bIsScratchSweepBatchInUse;
+		const bool bOwnsScratch;
+		FDBSHitRegistratorSweepBatch NestedSweepBatch;
+	};
+
+	// smallest half size of shape - how far it can move per substep without tunneling,
+	// reach - distance from center to farthest point, covers shape in any rotation
+	void GetShapeThicknessAndReach(const FCollisionShape& CollisionShape, float& OutThickness, float& OutReach)
+	{
+		switch (CollisionShape.ShapeType)
+		{
+			case ECollisionShape::Box:
+				OutThickness = CollisionShape.GetExtent().GetMin();
+				OutReach = CollisionShape.GetExtent().Size();
+				break;
+			case ECollisionShape::Sphere:
+				OutThickness = CollisionShape.GetSphereRadius();
+				OutReach = CollisionShape.GetSphereRadius();
+				break;
+			case ECollisionShape::Capsule:
+				OutThickness = CollisionShape.GetCapsuleRadius();
+				OutReach = CollisionShape.GetCapsuleHalfHeight();
+				break;
+			default:
+				OutThickness = 0.0f;
+				OutReach = 0.0f;
+				break;
+		}
+	}
+
+	FCollisionShape ScaleCollisionShape(const FCollisionShape& CollisionShape, const FVector& Scale3D, float Inflation = 0.0f)
+	{
+		// sphere and capsule can't be scaled non-uniformly, same as engine shape components
+		const float ShapeScale = Scale3D.GetAbsMin();
+		switch (CollisionShape.ShapeType)
+		{
+			case ECollisionShape::Box:
+				return FCollisionShape::MakeBox(FVector::Max(FVector::ZeroVector, CollisionShape.GetExtent() * Scale3D.GetAbs() + Inflation));
+			case ECollisionShape::Sphere:
+				return FCollisionShape::MakeSphere(FMath::Max(0.0f, CollisionShape.GetSphereRadius() * ShapeScale + Inflation));
+			case ECollisionShape::Capsule:
+				return FCollisionShape::MakeCapsule(FMath::Max(0.0f, CollisionShape.GetCapsuleRadius() * ShapeScale + Inflation),
+					FMath::Max(0.0f, CollisionShape.GetCapsuleHalfHeight() * ShapeScale + Inflation));
+			default:
+				return CollisionShape;
+		}
+	}
+
+	FBoxSphereBounds CalcShapeBounds(const FCollisionShape& CollisionShape)
+	{
+		switch (CollisionShape.ShapeType)
+		{
+			case ECollisionShape::Box:
+				return FBoxSphereBounds(FBox(-CollisionShape.GetExtent(), CollisionShape.GetExtent()));
+			case ECollisionShape::Sphere:
+				return FBoxSphereBounds(FVector::ZeroVector, FVector(CollisionShape.GetSphereRadius()), CollisionShape.GetSphereRadius());
+			case ECollisionShape::Capsule:
+			{
+				const FVector BoxPoint(CollisionShape.GetCapsuleRadius(), CollisionShape.GetCapsuleRadius(), CollisionShape.GetCapsuleHalfHeight());
+				return FBoxSphereBounds(FVector::ZeroVector, BoxPoint, CollisionShape.GetCapsuleHalfHeight());
+			}
+			default:
+				return FBoxSphereBounds(FVector::ZeroVector, FVector::ZeroVector, 0.0f);
+		}
+	}
+
+	void SweepMultiByShape(const UWorld* World, FDBSHitRegistratorSweep& Sweep)
+	{
+		Sweep.bHasHit = World->SweepMultiByChannel(
+			Sweep.HitResults,
+			Sweep.Start,
+			Sweep.End,
+			Sweep.Rotation,
+			Sweep.TraceChannel,
+			Sweep.CollisionShape,
+			*Sweep.QueryParams,
+			FCollisionResponseParams::DefaultResponseParam
+		);
+	}
+
+	// wireframe of any HitRegistrator shape, same look as engine shape components
+	class FDBSHitRegistratorSceneProxy final : public FPrimitiveSceneProxy
+	{
+	public:
+		virtual SIZE_T GetTypeHash() const override
+		{
+			static size_t UniquePointer;
+			return reinterpret_cast<size_t>(&UniquePointer);
+		}
+
+		FDBSHitRegistratorSceneProxy(const UDBSHitRegistratorBase* InComponent)
+			: FPrimitiveSceneProxy(InComponent)
+			, bDrawOnlyIfSelected(InComponent->bDrawOnlyIfSelected)
+			, Segments(InComponent->GetSegments())
+			, ShapeColor(InComponent->ShapeColor)
+			, LineThickness(InComponent->LineThickness)
+		{
+			bWillEverBeLit = false;
+			if (Segments.IsEmpty())
+			{
+				Segments.Add({ FTransform::Identity, InComponent->GetUnscaledShape() });
+			}
+		}
+
+		virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+		{
+			QUICK_SCOPE_CYCLE_COUNTER(STAT_DBSHitRegistratorSceneProxy_GetDynamicMeshElements);
+
+			for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+			{
+				if (!(VisibilityMap & (1 << ViewIndex))) continue;
+
+				const FSceneView* View = Views[ViewIndex];
+				const FLinearColor DrawColor = GetViewSelectionColor(ShapeColor, *View, IsSelected(), IsHovered(), false, IsIndividuallySelected());
+				FPrimitiveDrawInterface* PDI = Collector.GetPDI(ViewIndex);
+
+				for (const FDBSHitRegistratorSegment& Segment : Segments)
+				{
+					DrawSegment(PDI, Segment, DrawColor);
+				}
+			}
+		}
+
+		virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+		{
+			const bool bProxyVisible = !bDrawOnlyIfSelected || IsSelected();
+			const bool bShowForCollision = View->Family->EngineShowFlags.Collision && IsCollisionEnabled();
+
+			FPrimitiveViewRelevance Result;
+			Result.bDrawRelevance = (IsShown(View) && bProxyVisible) || bShowForCollision;
+			Result.bDynamicRelevance = true;
+			Result.bShadowRelevance = IsShadowCast(View);
+			Result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
+			return Result;
+		}
+
+		virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize() + Segments.GetAllocatedSize(); }
+
+	private:
+		const uint32 bDrawOnlyIfSelected : 1;
+		TArray<FDBSHitRegistratorSegment> Segments;
+		const FColor ShapeColor;
+		const float LineThickness;
+
+		void DrawSegment(FPrimitiveDrawInterface* PDI, const FDBSHitRegistratorSegment& Segment, const FLinearColor& DrawColor) const
+		{
+			const FMatrix LocalToWorld = Segment.RelativeTransform.ToMatrixWithScale() * GetLocalToWorld();
+			const FVector Origin = LocalToWorld.GetOrigin();
+			const float ShapeScale = LocalToWorld.GetMinimumAxisScale();
+			const FCollisionShape& CollisionShape = Segment.CollisionShape;
+
+			switch (CollisionShape.ShapeType)
+			{
+				case ECollisionShape::Box:
+					DrawOrientedWireBox(PDI, Origin, LocalToWorld.GetScaledAxis(EAxis::X), LocalToWorld.GetScaledAxis(EAxis::Y), LocalToWorld.GetScaledAxis(EAxis::Z),
+						CollisionShape.GetExtent(), DrawColor, SDPG_World, LineThickness);
+					break;
+				case ECollisionShape::Sphere:
+					DrawWireSphereAutoSides(PDI, Origin, DrawColor, CollisionShape.GetSphereRadius() * ShapeScale, SDPG_World, LineThickness);
+					break;
+				case ECollisionShape::Capsule:
+				{
+					const float Radius = CollisionShape.GetCapsuleRadius() * ShapeScale;
+					const int32 CapsuleSides = FMath::Clamp<int32>(Radius / 4.0f, 16, 64);
+					DrawWireCapsule(PDI, Origin, LocalToWorld.GetUnitAxis(EAxis::X), LocalToWorld.GetUnitAxis(EAxis::Y), LocalToWorld.GetUnitAxis(EAxis::Z),
+						DrawColor, Radius, CollisionShape.GetCapsuleHalfHeight() * ShapeScale, CapsuleSides, SDPG_World, LineThickness);
+					break;
+				}
+				default:
+					break;
+			}
+		}
+	};
+}
+
+
+UDBSHitRegistratorBase::UDBSHitRegistratorBase()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+    ShapeColor = FColor(255.0f, 0.0f, 0.0f);
+	SetCollisionProfileName(FName("NoCollision"));
+}
+
+FPrimitiveSceneProxy* UDBSHitRegistratorBase::CreateSceneProxy()
+{
+	return new FDBSHitRegistratorSceneProxy(this);
+}
+
+FBoxSphereBounds UDBSHitRegistratorBase::CalcBounds(const FTransform& LocalToWorld) const
+{
+	const TConstArrayView<FDBSHitRegistratorSegment> Segments = GetSegments();
+	if (Segments.IsEmpty())
+	{
+		return CalcShapeBounds(GetUnscaledShape()).TransformBy(LocalToWorld);
+	}
+
+	FBoxSphereBounds LocalBounds = CalcShapeBounds(Segments[0].CollisionShape).TransformBy(Segments[0].RelativeTransform);
+	for (int32 i = 1; i < Segments.Num(); i++)
+	{
+		LocalBounds = LocalBounds + CalcShapeBounds(Segments[i].CollisionShape).TransformBy(Segments[i].RelativeTransform);
+	}
+	return LocalBounds.TransformBy(LocalToWorld);
+}
+
+bool UDBSHitRegistratorBase::IsZeroExtent() const
+{
+	return GetUnscaledShape().IsNearlyZero();
+}
+
+FCollisionShape UDBSHitRegistratorBase::GetCollisionShape(float Inflation) const
+{
+	return ScaleCollisionShape(GetUnscaledShape(), GetComponentTransform().GetScale3D(), Inflation);
+}
+
+void UDBSHitRegistratorBase::UpdateBodySetup()
+{
+	const FCollisionShape CollisionShape = GetUnscaledShape();
+	switch (CollisionShape.ShapeType)
+	{
+		case ECollisionShape::Box:
+		{
+			CreateShapeBodySetupIfNeeded<FKBoxElem>();
+			FKBoxElem* BoxElem = ShapeBodySetup->AggGeom.BoxElems.GetData();
+			BoxElem->SetTransform(FTransform::Identity);
+			BoxElem->X = CollisionShape.GetExtent().X * 2.0f;
+			BoxElem->Y = CollisionShape.GetExtent().Y * 2.0f;
+			BoxElem->Z = CollisionShape.GetExtent().Z * 2.0f;
+			break;
+		}
+		case ECollisionShape::Sphere:
+		{
+			CreateShapeBodySetupIfNeeded<FKSphereElem>();
+			FKSphereElem* SphereElem = ShapeBodySetup->AggGeom.SphereElems.GetData();
+			SphereElem->SetTransform(FTransform::Identity);
+			SphereElem->Radius = CollisionShape.GetSphereRadius();
+			break;
+		}
+		case ECollisionShape::Capsule:
+		{
+			CreateShapeBodySetupIfNeeded<FKSphylElem>();
+			FKSphylElem* SphylElem = ShapeBodySetup->AggGeom.SphylElems.GetData();
+			SphylElem->SetTransform(FTransform::Identity);
+			SphylElem->Radius = CollisionShape.GetCapsuleRadius();
+			SphylElem->Length = 2.0f * FMath::Max(CollisionShape.GetCapsuleHalfHeight() - CollisionShape.GetCapsuleRadius(), 0.0f);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+#if WITH_EDITOR
+void UDBSHitRegistratorBase::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// shape properties live in subclasses, cheap enough to rebuild on any change
+	UpdateBodySetup();
+	MarkRenderStateDirty();
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+#endif
+
+void UDBSHitRegistratorBase::NotifyShapeChanged(bool bUpdateOverlaps)
+{
+	UpdateBounds();
+	UpdateBodySetup();
+	MarkRenderStateDirty();
+
+	// otherwise created with new shape by OnCreatePhysicsState
+	if (bPhysicsStateCreated)
+	{
+		BodyInstance.UpdateBodyScale(GetComponentTransform().GetScale3D(), true);
+		if (bUpdateOverlaps && IsCollisionEnabled() && GetOwner())
+		{
+			UpdateOverlaps();
+		}
+	}
+}
+
+void UDBSHitRegistratorBase::TickHitRegistration(float /*DeltaTime*/, FDBSHitRegistratorSweepBatch* SweepBatch)
+{
+	// registrator shared by several active DamageBehaviors already swept this frame,
+	// its hits were dispatched to every behavior listening it(see HitSinks)
+	if (LastHitRegistrationFrame == GFrameCounter)
+	{
+		INC_DWORD_STAT(STAT_DBS_SharedSweepsSkipped);
+		return;
+	}
+	LastHitRegistrationFrame = GFrameCounter;
+
+	bool bIsSweepDeferred = false;
+	if (bIsHitRegistrationEnabled
+		&& DBSIsTickedHitDetectionType(CurrentHitDetectionSettings.HitDetectionType))
+	{
+		if (bQueryParamsDirty)
+		{
+			RebuildQueryParams();
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_DBS_QueryParamsRebuildsSkipped);
+		}
+
+		// callers outside of UDamageBehaviorsSubsystem may not have scratch
+		FDBSScopedScratchSweepBatch LocalSweepBatch(ScratchSweepBatch, bIsScratchSweepBatchInUse);
+		FDBSHitRegistratorSweepBatch& Batch = SweepBatch ? *SweepBatch : LocalSweepBatch.Get();
+
+		// results of previous frames delivered before any branch could skip this frame sweep
+		ConsumeAsyncSweeps(Batch);
+
+		if (CurrentHitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery
+			|| CurrentHitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside)
+		{
+			TickOverlapQuery();
+		}
+		else if (ShouldDeferSweepForSkippedAnimation())
+		{
+			// pose frozen this frame, zero-length sweep now and one giant sweep later otherwise
+			bIsSweepDeferred = true;
+			INC_DWORD_STAT(STAT_DBS_AnimSkippedSweepsDeferred);
+		}
+		// hurtboxes don't touch physics scene, nothing to wait for
+		else if (CurrentHitDetectionSettings.bUseAsyncTrace
+			&& CurrentHitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::ByTrace)
+		{
+			// previous frames results already delivered above
+			if (bIsHitRegistrationEnabled && HasHittableActorsNearSweep())
+			{
+				const int32 FirstSweep = Batch.Num();
+				BuildSweeps(Batch);
+				for (int32 i = FirstSweep; i < Batch.Num(); i++)
+				{
+					SubmitAsyncSweep(Batch[i]);
+				}
+				Batch.Truncate(FirstSweep);
+			}
+		}
+		else if (!HasHittableActorsNearSweep())
+		{
+			// nobody to hit around, see UDBSHittableActorsSubsystem
+		}
+		else if (Batch.bDeferExecution)
+		{
+			// executed later all together, see UDamageBehaviorsSubsystem::TickActiveBehaviors
+			BuildSweeps(Batch);
+		}
+		else
+		{
+			const int32 FirstSweep = Batch.Num();
+			BuildSweeps(Batch);
+			for (int32 i = FirstSweep; i < Batch.Num(); i++)
+			{
+				ExecuteSweep(GetWorld(), Batch[i]);
+				CommitSweep(Batch[i]);
+			}
+			Batch.Truncate(FirstSweep);
+		}
+	}
+
+	if (bIsSweepDeferred)
+	{
+		// next sweep starts from last swept transform and covers skipped frames
+		NumDeferredSweepFrames++;
+		return;
+	}
+	NumDeferredSweepFrames = 0;
+	PreviousComponentTransform = GetHitRegistrationTransform();
+}
+
+void UDBSHitRegistratorBase::ResyncHitRegistration()
+{
+	NumDeferredSweepFrames = 0;
+	PreviousComponentTransform = GetHitRegistrationTransform();
+}
+
+void UDBSHitRegistratorBase::DeliverAsyncSweeps()
+{
+	if (PendingAsyncSweeps.IsEmpty()) return;
+
+	FDBSScopedScratchSweepBatch LocalSweepBatch(ScratchSweepBatch, bIsScratchSweepBatchInUse);
+	ConsumeAsyncSweeps(LocalSweepBatch.Get());
+}
+
+void UDBSHitRegistratorBase::FlushAsyncSweeps()
+{
+	if (PendingAsyncSweeps.IsEmpty()) return;
+
+	if (bQueryParamsDirty)
+	{
+		RebuildQueryParams();
+	}
+	FDBSScopedScratchSweepBatch LocalSweepBatch(ScratchSweepBatch, bIsScratchSweepBatchInUse);
+	ConsumeAsyncSweeps(LocalSweepBatch.Get(), true);
+}
+
+void UDBSHitRegistratorBase::SetBakedTrajectory(const FDBSBakedTrajectoryPlayback& BakedTrajectory_In)
+{
+	if (!bIsHitRegistrationEnabled) return;
+
+	BakedTrajectory = BakedTrajectory_In;
+	// window starts from baked pose, not from wherever frozen mesh left the component
+	NumDeferredSweepFrames = 0;
+	PreviousComponentTransform = GetHitRegistrationTransform();
+}
+
+FTransform UDBSHitRegistratorBase::GetHitRegistrationTransform() const
+{
+	FTransform BakedTransform;
+	if (BakedTrajectory.IsActive() && BakedTrajectory.Evaluate(BakedTransform))
+	{
+		// shape scale still comes from component
+		BakedTransform.SetScale3D(GetComponentTransform().GetScale3D());
+		return BakedTransform;
+	}
+	return GetComponentTransform();
+}
+
+bool UDBSHitRegistratorBase::ShouldDeferSweepForSkippedAnimation()
+{
+	// baked trajectory doesn't need evaluated pose
+	if (BakedTrajectory.IsActive()) return false;
+
+	const USkeletalMeshComponent* AnimatedMesh = AnimatedMeshComponent.Get();
+	if (!AnimatedMesh) return false;
+
+	static IConsoleVariable* CVarDBSAnimSkippedFramesSweeps = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.AnimSkippedFramesSweeps"));
+	if (!CVarDBSAnimSkippedFramesSweeps || !CVarDBSAnimSkippedFramesSweeps->GetBool()) return false;
+
+	// interpolated skipped frames also bump revision, their pose is what was rendered
+	const uint32 BoneTransformRevision = AnimatedMesh->GetBoneTransformRevisionNumber();
+	const bool bIsPoseUpdated = BoneTransformRevision != LastBoneTransformRevision;
+	LastBoneTransformRevision = BoneTransformRevision;
+	if (bIsPoseUpdated) return false;
+
+	// pose not refreshed because animation was skipped, not because mesh doesn't animate at all
+	const FAnimUpdateRateParameters* UpdateRateParams = AnimatedMesh->AnimUpdateRateParams;
+	const bool bIsSkippedByURO = AnimatedMesh->ShouldUseUpdateRateOptimizations() && UpdateRateParams
+		&& UpdateRateParams->ShouldSkipEvaluation() && !UpdateRateParams->ShouldInterpolateSkippedFrames();
+	const bool bIsSkippedByVisibility = !AnimatedMesh->bRecentlyRendered
+		&& AnimatedMesh->VisibilityBasedAnimTickOption != EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	if (!bIsSkippedByURO && !bIsSkippedByVisibility) return false;
+
+	return NumDeferredSweepFrames < GetDefault<UDamageBehaviorsSystemSettings>()->MaxAnimSkippedFramesToDefer;
+}
+
+int32 UDBSHitRegistratorBase::CalculateSubstepsCount(const FTransform& From, const FTransform& To, const FCollisionShape& CollisionShape) const
+{
+	// frames deferred by skipped animation swept at once, each of them keeps its substeps budget
+	const int32 MaxSubsteps = FMath::Max(1, CurrentHitDetectionSettings.MaxSubsteps) * (NumDeferredSweepFrames + 1);
+	if (MaxSubsteps == 1) return 1;
+
+	float Thickness = 0.0f;
+	float Reach = 0.0f;
+	GetShapeThicknessAndReach(CollisionShape, Thickness, Reach);
+	Thickness = FMath::Max(Thickness, UE_KINDA_SMALL_NUMBER);
+	Reach = FMath::Max(Reach, UE_KINDA_SMALL_NUMBER);
+
+	// swept shape covers translation exactly, straight movement of any length stays single sweep.
+	// Substeps only for what rotation adds: shape tip swinging around component origin should travel
+	// not more than its thickness(capsule radius) per substep, rotating sphere doesn't move
+	const float Angle = From.GetRotation().AngularDistance(To.GetRotation());
+	const float TipSubsteps = CollisionShape.IsSphere() ? 0.0f : Angle * Reach / Thickness;
+
+	// component rotating around other pivot(weapon in hand) moves its origin along arc, not chord between
+	// origins - arc turning by A deviates from chord by PivotDistance * (1 - cos(A / 2)), kept under thickness
+	float ArcSubsteps = 0.0f;
+	const float HalfAngleSin = FMath::Sin(Angle * 0.5f);
+	if (HalfAngleSin > UE_KINDA_SMALL_NUMBER)
+	{
+		const float PivotDistance = FVector::Dist(From.GetLocation(), To.GetLocation()) / (2.0f * HalfAngleSin);
+		if (PivotDistance > Thickness)
+		{
+			ArcSubsteps = Angle / (2.0f * FMath::Acos(1.0f - Thickness / PivotDistance));
+		}
+	}
+	const float Substeps = FMath::Max(TipSubsteps, ArcSubsteps);
+
+	return FMath::Clamp(FMath::CeilToInt32(Substeps), 1, MaxSubsteps);
+}
+
+bool UDBSHitRegistratorBase::HasHittableActorsNearSweep() const
+{
+	// hurtboxes sweep is already cheaper than broadphase
+	if (CurrentHitDetectionSettings.HitDetectionType != EDamageBehaviorHitDetectionType::ByTrace) return true;
+
+	static IConsoleVariable* CVarDBSHittableBroadphase = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HittableBroadphase"));
+	if (!CVarDBSHittableBroadphase || !CVarDBSHittableBroadphase->GetBool()) return true;
+
+	const UDBSHittableActorsSubsystem* HittableActorsSubsystem = UDBSHittableActorsSubsystem::Get(GetWorld());
+	if (!HittableActorsSubsystem) return true;
+
+	// reach covers shape in any rotation
+	FBox SweptBounds(ForceInit);
+	SweptBounds += PreviousComponentTransform.GetLocation();
+	SweptBounds += GetHitRegistrationTransform().GetLocation();
+	SweptBounds = SweptBounds.ExpandBy(GetScaledReach());
+
+	const bool bHasHittableActors = HittableActorsSubsystem->HasHittableActorsInBounds(SweptBounds, QueryIgnoredActors);
+	HittableActorsSubsystem->RecordQuery(bHasHittableActors);
+	return bHasHittableActors;
+}
+
+void UDBSHitRegistratorBase::RebuildQueryParams()
+{
+	INC_DWORD_STAT(STAT_DBS_QueryParamsRebuilds);
+
+	CachedQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(DBSHitRegistratorSweep), false);
+    FCollisionQueryParams& CollisionParams = CachedQueryParams;
+	CollisionParams.bReturnPhysicalMaterial = true;
+
+    AActor* OwnerActor = GetOwner();
+	CollisionParams.AddIgnoredActor(OwnerActor);
+    TArray<AActor*>& CharacterAttachedActors = AttachedActorsScratch;
+    CharacterAttachedActors.Reset();
+    // ignore Character
+    CollisionParams.AddIgnoredActor(OwnerActor->GetOwner());
+    CollisionParams.AddIgnoredActors(IgnoredActors);
+    // ignore all childs of Character
+    OwnerActor->GetAttachedActors(CharacterAttachedActors, false, true);
+    AActor* OwnerCharacter = OwnerActor->GetOwner();
+    if (OwnerCharacter != nullptr)
+    {
+        OwnerCharacter->GetAttachedActors(CharacterAttachedActors, false, true);
+        CollisionParams.AddIgnoredActors(CharacterAttachedActors);
+    }
+
+	// same actors ignored by hittable actors broadphase and hurtboxes sweeps,
+	// otherwise owner always found near its capsule
+	QueryIgnoredActors.Reset();
+	QueryIgnoredActors.Add(OwnerActor);
+	QueryIgnoredActors.Add(OwnerCharacter);
+	QueryIgnoredActors.Append(IgnoredActors);
+	if (OwnerCharacter != nullptr)
+	{
+		QueryIgnoredActors.Append(CharacterAttachedActors);
+	}
+
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+	CachedTraceChannel = DamageBehaviorsSystemSettings->HitRegistratorsTraceChannel;
+	if (CurrentHitDetectionSettings.bUseCustomTraceChannel)
+	{
+		CachedTraceChannel = CurrentHitDetectionSettings.CustomTraceChannel;
+	}
+
+	bQueryParamsDirty = false;
+}
+
+void UDBSHitRegistratorBase::BuildSweeps(FDBSHitRegistratorSweepBatch& SweepBatch) const
+{
+	const FTransform CurrentTransform = GetHitRegistrationTransform();
+
+	const FDBSHurtboxesSnapshot* Hurtboxes = nullptr;
+	if (CurrentHitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::ByHurtboxes)
+	{
+		UDBSHurtboxesSubsystem* HurtboxesSubsystem = UDBSHurtboxesSubsystem::Get(GetWorld());
+		if (!HurtboxesSubsystem) return;
+		Hurtboxes = LagCompensationDelay > 0.0f
+			? &HurtboxesSubsystem->GetRewoundHurtboxesSnapshot(GetWorld()->GetTimeSeconds() - LagCompensationDelay)
+			: &HurtboxesSubsystem->GetHurtboxesSnapshot();
+	}
+
+	const TConstArrayView<FDBSHitRegistratorSegment> Segments = GetSegments();
+	if (Segments.IsEmpty())
+	{
+		BuildShapeSweeps(SweepBatch, PreviousComponentTransform, CurrentTransform, GetCollisionShape(), Hurtboxes);
+		return;
+	}
+
+	// all segments follow one component transform, no scene components per segment
+	const FVector Scale3D = CurrentTransform.GetScale3D();
+	for (const FDBSHitRegistratorSegment& Segment : Segments)
+	{
+		BuildShapeSweeps(SweepBatch,
+			Segment.RelativeTransform * PreviousComponentTransform,
+			Segment.RelativeTransform * CurrentTransform,
+			ScaleCollisionShape(Segment.CollisionShape, Scale3D),
+			Hurtboxes);
+	}
+}
+
+void UDBSHitRegistratorBase::BuildShapeSweeps(FDBSHitRegistratorSweepBatch& SweepBatch, const FTransform& From, const FTransform& To,
+	const FCollisionShape& CollisionShape_In, const FDBSHurtboxesSnapshot* Hurtboxes) const
+{
+	// hurtboxes kernel sweeps capsules only
+	const FCollisionShape CollisionShape = Hurtboxes ? FDBSCapsuleSweepKernel::MakeSweepCapsule(CollisionShape_In) : CollisionShape_In;
+
+	// fast swings - interpolate position and rotation between previous and current transform
+	const int32 SubstepsCount = CalculateSubstepsCount(From, To, CollisionShape);
+	INC_DWORD_STAT_BY(STAT_DBS_SweepSubsteps, SubstepsCount);
+
+	for (int32 i = 0; i < SubstepsCount; i++)
+	{
+		const float StartAlpha = static_cast<float>(i) / SubstepsCount;
+		const float EndAlpha = static_cast<float>(i + 1) / SubstepsCount;
+
+		FDBSHitRegistratorSweep& Sweep = SweepBatch.AddSweep();
+		Sweep.HitRegistrator = const_cast<UDBSHitRegistratorBase*>(this);
+		Sweep.Start = FMath::Lerp(From.GetLocation(), To.GetLocation(), StartAlpha);
+		Sweep.End = FMath::Lerp(From.GetLocation(), To.GetLocation(), EndAlpha);
+		// rotation doesn't change sphere, identity keeps query on sphere fast path
+		Sweep.Rotation = CollisionShape.IsSphere()
+			? FQuat::Identity
+			: FQuat::Slerp(From.GetRotation(), To.GetRotation(), (StartAlpha + EndAlpha) * 0.5f);
+		Sweep.CollisionShape = CollisionShape;
+		Sweep.TraceChannel = CachedTraceChannel;
+		Sweep.QueryParams = &CachedQueryParams;
+		Sweep.Hurtboxes = Hurtboxes;
+		Sweep.IgnoredActors = QueryIgnoredActors;
+
+		// fix to correct impact point if CurrentLocation and PrevioutLocation are the same
+		if (Sweep.Start == Sweep.End)
+		{
+			Sweep.End += FVector(0.1f, 0.0f, 0.0f);
+		}
+	}
+}
+
+float UDBSHitRegistratorBase::GetScaledReach() const
+{
+	float Thickness = 0.0f;
+	float Reach = 0.0f;
+	const TConstArrayView<FDBSHitRegistratorSegment> Segments = GetSegments();
+	if (Segments.IsEmpty())
+	{
+		GetShapeThicknessAndReach(GetCollisionShape(), Thickness, Reach);
+		return Reach;
+	}
+
+	const FVector Scale3D = GetComponentTransform().GetScale3D();
+	float MaxReach = 0.0f;
+	for (const FDBSHitRegistratorSegment& Segment : Segments)
+	{
+		GetShapeThicknessAndReach(ScaleCollisionShape(Segment.CollisionShape, Scale3D), Thickness, Reach);
+		MaxReach = FMath::Max(MaxReach, (Segment.RelativeTransform.GetLocation() * Scale3D).Size() + Reach);
+	}
+	return MaxReach;
+}
+
+bool UDBSHitRegistratorBase::ShouldDispatchSegmentsHit(const FHitResult& HitResult)
+{
+	if (GetSegments().IsEmpty()) return true;
+
+	if (SegmentsHitFrame != GFrameCounter)
+	{
+		SegmentsHitFrame = GFrameCounter;
+		SegmentsHitObjects.Reset();
+	}
+
+	const UPrimitiveComponent* HitComponent = HitResult.GetComponent();
+	const UObject* HitObject = HitComponent ? static_cast<const UObject*>(HitComponent) : HitResult.GetActor();
+	// nothing to identify, never merge such hits
+	if (!HitObject) return true;
+
+	bool bIsAlreadyHit = false;
+	SegmentsHitObjects.Add(FObjectKey(HitObject), &bIsAlreadyHit);
+	return !bIsAlreadyHit;
+}
+
+bool UDBSHitRegistratorBase::ShouldQueryOverlaps() const
+{
+	if (LastOverlapQueryFrame == 0) return true;
+
+	switch (CurrentHitDetectionSettings.OverlapQueryRate)
+	{
+		case EDBSOverlapQueryRate::EveryNFrames:
+			return GFrameCounter - LastOverlapQueryFrame >= static_cast<uint64>(FMath::Max(1, CurrentHitDetectionSettings.OverlapQueryIntervalFrames));
+		case EDBSOverlapQueryRate::EveryNMilliseconds:
+			return (GetWorld()->GetTimeSeconds() - LastOverlapQueryTime) * 1000.0 >= CurrentHitDetectionSettings.OverlapQueryIntervalMs;
+		default:
+			return true;
+	}
+}
+
+void UDBSHitRegistratorBase::TickOverlapQuery()
+{
+	if (!ShouldQueryOverlaps()) return;
+
+	INC_DWORD_STAT(STAT_DBS_OverlapQueries);
+
+	// first query of window only remembers what is inside if we shouldn't hit them
+	const bool bShouldDispatchHits = LastOverlapQueryFrame != 0 || CurrentHitDetectionSettings.bCheckOverlappingActorsOnStart;
+	LastOverlapQueryFrame = GFrameCounter;
+	LastOverlapQueryTime = GetWorld()->GetTimeSeconds();
+
+	const FTransform& ComponentTransform = GetComponentTransform();
+	const TConstArrayView<FDBSHitRegistratorSegment> Segments = GetSegments();
+	const int32 NumShapes = FMath::Max(1, Segments.Num());
+
+#if ENABLE_DRAW_DEBUG
+	static IConsoleVariable* CVarDBSHitBoxes = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
+	const bool bIsDebugEnabled = CVarDBSHitBoxes && CVarDBSHitBoxes->GetBool();
+#endif
+
+	OverlapResults.Reset();
+	for (int32 ShapeIndex = 0; ShapeIndex < NumShapes; ShapeIndex++)
+	{
+		const FTransform ShapeTransform = Segments.IsEmpty() ? ComponentTransform : Segments[ShapeIndex].RelativeTransform * ComponentTransform;
+		const FCollisionShape CollisionShape = Segments.IsEmpty()
+			? GetCollisionShape()
+			: ScaleCollisionShape(Segments[ShapeIndex].CollisionShape, ComponentTransform.GetScale3D());
+		const FQuat Rotation = CollisionShape.IsSphere() ? FQuat::Identity : ShapeTransform.GetRotation();
+
+		// overlap query resets its output, segments collected into scratch
+		TArray<FOverlapResult>& ShapeOverlapResults = Segments.IsEmpty() ? OverlapResults : SegmentOverlapResults;
+		const bool bHasOverlaps = GetWorld()->OverlapMultiByChannel(
+			ShapeOverlapResults,
+			ShapeTransform.GetLocation(),
+			Rotation,
+			CachedTraceChannel,
+			CollisionShape,
+			CachedQueryParams,
+			FCollisionResponseParams::DefaultResponseParam
+		);
+		if (!Segments.IsEmpty())
+		{
+			OverlapResults.Append(SegmentOverlapResults);
+		}
+
+#if ENABLE_DRAW_DEBUG
+		if (bIsDebugEnabled)
+		{
+			DrawDebugShape(GetWorld(), ShapeTransform.GetLocation(), Rotation, CollisionShape, bHasOverlaps ? FColor::Yellow : ShapeColor);
+		}
+#endif
+	}
+
+	const bool bIsStandingInside = CurrentHitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside;
+
+	// previous overlaps become current set after diff, both keep their allocations
+	Swap(PreviousOverlappedComponents, CurrentOverlappedComponents);
+	CurrentOverlappedComponents.Reset();
+	for (const FOverlapResult& OverlapResult : OverlapResults)
+	{
+		UPrimitiveComponent* OverlappedComponent = OverlapResult.GetComponent();
+		if (!OverlappedComponent) continue;
+
+		// component overlapped by several segments handled once
+		bool bIsAlreadyOverlapped = false;
+		CurrentOverlappedComponents.Add(OverlappedComponent, &bIsAlreadyOverlapped);
+		if (bIsAlreadyOverlapped) continue;
+		// could be disabled by previous hit processing
+		if (!bIsHitRegistrationEnabled || PreviousOverlappedComponents.Contains(OverlappedComponent)) continue;
+
+		if (bIsStandingInside)
+		{
+			AddStandingInsideOccupant(OverlappedComponent, bShouldDispatchHits);
+		}
+		else if (bShouldDispatchHits)
+		{
+			DispatchOverlapHit(OverlappedComponent, 1);
+		}
+	}
+
+	if (bIsStandingInside)
+	{
+		// left since previous query - stop re-hitting
+		for (auto It = StandingInsideOccupants.CreateIterator(); It; ++It)
+		{
+			if (CurrentOverlappedComponents.Contains(It.Key())) continue;
+			CancelStandingInsideHit(It.Value().HitTimerHandle);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UDBSHitRegistratorBase::DispatchOverlapHit(UPrimitiveComponent* OverlappedComponent, int32 Stacks)
+{
+	if (HitSinks.IsEmpty() && !OnHitRegistered.IsBound()) return;
+
+	// same as ByEntering begin overlap, no sweep so impact is capsule center
+	const FVector Location = GetComponentLocation();
+	AActor* OverlappedActor = OverlappedComponent->GetOwner();
+	FDBSHitRegistratorHitResult HitRegistratorHitResult;
+	HitRegistratorHitResult.HitResult = FHitResult(OverlappedActor, OverlappedComponent, Location,
+		(Location - OverlappedComponent->GetComponentLocation()).GetSafeNormal());
+	HitRegistratorHitResult.HitActor = OverlappedActor;
+	// Default instigator is Character owning capsule, but don't forget to override it if needed
+	HitRegistratorHitResult.Instigator = GetOwner();
+	HitRegistratorHitResult.PhysicalSurfaceType = UGameplayStatics::GetSurfaceType(HitRegistratorHitResult.HitResult);
+	HitRegistratorHitResult.Stacks = Stacks;
+	DispatchHit(HitRegistratorHitResult);
+}
+
+void UDBSHitRegistratorBase::AddStandingInsideOccupant(UPrimitiveComponent* OverlappedComponent, bool bHitOnEnter)
+{
+	FDBSStandingInsideOccupant& Occupant = StandingInsideOccupants.FindOrAdd(OverlappedComponent);
+	Occupant.Component = OverlappedComponent;
+	Occupant.Stacks = bHitOnEnter ? 1 : 0;
+	Occupant.HitTimerHandle = ScheduleStandingInsideHit(OverlappedComponent);
+
+	if (bHitOnEnter)
+	{
+		DispatchOverlapHit(OverlappedComponent, Occupant.Stacks);
+	}
+}
+
+void UDBSHitRegistratorBase::HandleStandingInsideHit(const TObjectKey<UPrimitiveComponent>& OccupantKey)
+{
+	if (!bIsHitRegistrationEnabled
+		|| CurrentHitDetectionSettings.HitDetectionType != EDamageBehaviorHitDetectionType::WhileStandingInside) return;
+
+	FDBSStandingInsideOccupant* Occupant = StandingInsideOccupants.Find(OccupantKey);
+	if (!Occupant) return;
+
+	UPrimitiveComponent* OverlappedComponent = Occupant->Component.Get();
+	if (!OverlappedComponent)
+	{
+		StandingInsideOccupants.Remove(OccupantKey);
+		return;
+	}
+
+	Occupant->Stacks = CurrentHitDetectionSettings.bUseStacks
+		? FMath::Min(Occupant->Stacks + 1, FMath::Max(1, CurrentHitDetectionSettings.MaxStacks))
+		: 1;
+	// rescheduled before dispatch - hit processing could disable registration and cancel it
+	Occupant->HitTimerHandle = ScheduleStandingInsideHit(OverlappedComponent);
+	DispatchOverlapHit(OverlappedComponent, Occupant->Stacks);
+}
+
+FDBSTimerWheelHandle UDBSHitRegistratorBase::ScheduleStandingInsideHit(UPrimitiveComponent* OverlappedComponent)
+{
+	UDamageBehaviorsSubsystem* DamageBehaviorsSubsystem = UDamageBehaviorsSubsystem::Get(GetWorld());
+	if (!DamageBehaviorsSubsystem) return {};
+
+	return DamageBehaviorsSubsystem->ScheduleStandingInsideHit(this, OverlappedComponent, CurrentHitDetectionSettings.StandingInsideHitInterval);
+}
+
+void UDBSHitRegistratorBase::CancelStandingInsideHit(FDBSTimerWheelHandle& HitTimerHandle)
+{
+	if (UDamageBehaviorsSubsystem* DamageBehaviorsSubsystem = UDamageBehaviorsSubsystem::Get(GetWorld()))
+	{
+		DamageBehaviorsSubsystem->CancelStandingInsideHit(HitTimerHandle);
+	}
+	HitTimerHandle.Invalidate();
+}
+
+void UDBSHitRegistratorBase::ClearStandingInsideOccupants()
+{
+	for (TPair<TObjectKey<UPrimitiveComponent>, FDBSStandingInsideOccupant>& Occupant : StandingInsideOccupants)
+	{
+		CancelStandingInsideHit(Occupant.Value.HitTimerHandle);
+	}
+	StandingInsideOccupants.Reset();
+}
+
+void UDBSHitRegistratorBase::ExecuteSweep(const UWorld* World, FDBSHitRegistratorSweep& Sweep)
+{
+	if (Sweep.Hurtboxes)
+	{
+		UDBSHurtboxesSubsystem::ExecuteSweep(Sweep);
+		return;
+	}
+
+	switch (Sweep.CollisionShape.ShapeType)
+	{
+		case ECollisionShape::Sphere:
+		{
+			SCOPE_CYCLE_COUNTER(STAT_DBS_SweepSphere);
+			SweepMultiByShape(World, Sweep);
+			break;
+		}
+		case ECollisionShape::Box:
+		{
+			SCOPE_CYCLE_COUNTER(STAT_DBS_SweepBox);
+			SweepMultiByShape(World, Sweep);
+			break;
+		}
+		default:
+		{
+			SCOPE_CYCLE_COUNTER(STAT_DBS_SweepCapsule);
+			SweepMultiByShape(World, Sweep);
+			break;
+		}
+	}
+}
+
+void UDBSHitRegistratorBase::SubmitAsyncSweep(const FDBSHitRegistratorSweep& Sweep)
+{
+	INC_DWORD_STAT(STAT_DBS_AsyncSweepsSubmitted);
+
+	FDBSPendingAsyncSweep& PendingSweep = PendingAsyncSweeps.AddDefaulted_GetRef();
+	PendingSweep.TraceHandle = GetWorld()->AsyncSweepByChannel(
+		EAsyncTraceType::Multi,
+		Sweep.Start,
+		Sweep.End,
+		Sweep.Rotation,
+		Sweep.TraceChannel,
+		Sweep.CollisionShape,
+		*Sweep.QueryParams,
+		FCollisionResponseParams::DefaultResponseParam
+	);
+	PendingSweep.Start = Sweep.Start;
+	PendingSweep.End = Sweep.End;
+	PendingSweep.Rotation = Sweep.Rotation;
+	PendingSweep.CollisionShape = Sweep.CollisionShape;
+	PendingSweep.HitRegistrationWindow = HitRegistrationWindow;
+}
+
+void UDBSHitRegistratorBase::ConsumeAsyncSweeps(FDBSHitRegistratorSweepBatch& SweepBatch, bool bSweepNotReady)
+{
+	if (PendingAsyncSweeps.IsEmpty()) return;
+
+	UWorld* World = GetWorld();
+	const uint32 ConsumedHitRegistrationWindow = HitRegistrationWindow;
+	// not ready sweeps compacted to the front and kept for next frames
+	int32 NumKept = 0;
+	// index loop - hits processing could disable hit registration and reset pending sweeps
+	for (int32 i = 0; i < PendingAsyncSweeps.Num(); i++)
+	{
+		const FDBSPendingAsyncSweep PendingSweep = PendingAsyncSweeps[i];
+		// behavior was deactivated/reactivated since submit, results not relevant anymore
+		if (!bIsHitRegistrationEnabled || PendingSweep.HitRegistrationWindow != HitRegistrationWindow) break;
+
+		// copy into member datum reuses its OutHits allocation
+		const bool bIsReady = World->QueryTraceData(PendingSweep.TraceHandle, AsyncTraceDatum);
+		if (!bIsReady && !bSweepNotReady)
+		{
+			if (World->IsTraceHandleValid(PendingSweep.TraceHandle, false))
+			{
+				PendingAsyncSweeps[NumKept++] = PendingSweep;
+			}
+			else
+			{
+				INC_DWORD_STAT(STAT_DBS_AsyncSweepsExpired);
+			}
+			continue;
+		}
+
+		const int32 SweepIndex = SweepBatch.Num();
+		FDBSHitRegistratorSweep& Sweep = SweepBatch.AddSweep();
+		Sweep.HitRegistrator = this;
+		Sweep.Start = PendingSweep.Start;
+		Sweep.End = PendingSweep.End;
+		Sweep.Rotation = PendingSweep.Rotation;
+		Sweep.CollisionShape = PendingSweep.CollisionShape;
+		if (bIsReady)
+		{
+			INC_DWORD_STAT(STAT_DBS_AsyncSweepsDelivered);
+			Sweep.HitResults.Append(AsyncTraceDatum.OutHits);
+			// same as SweepMultiByChannel result - has blocking hit
+			Sweep.bHasHit = Sweep.HitResults.ContainsByPredicate([](const FHitResult& HitResult) { return HitResult.bBlockingHit; });
+		}
+		else
+		{
+			// window ends, results would arrive when nobody listens
+			INC_DWORD_STAT(STAT_DBS_AsyncSweepsFlushed);
+			Sweep.TraceChannel = CachedTraceChannel;
+			Sweep.QueryParams = &CachedQueryParams;
+			ExecuteSweep(World, Sweep);
+		}
+		CommitSweep(Sweep);
+		SweepBatch.Truncate(SweepIndex);
+	}
+
+	if (bIsHitRegistrationEnabled && HitRegistrationWindow == ConsumedHitRegistrationWindow)
+	{
+		PendingAsyncSweeps.SetNum(FMath::Min(NumKept, PendingAsyncSweeps.Num()), EAllowShrinking::No);
+	}
+	else
+	{
+		PendingAsyncSweeps.Reset();
+	}
+}
+
+void UDBSHitRegistratorBase::CommitSweep(const FDBSHitRegistratorSweep& Sweep)
+{
+	// could be disabled by other hits processing in same frame
+	if (!bIsHitRegistrationEnabled) return;
+
+	if (FDBSCapture::IsCapturing())
+	{
+		FDBSCapture::RecordSweep(Sweep, HitRegistrationWindow);
+	}
+
+#if ENABLE_DRAW_DEBUG
+	// lookup by name builds FString key, do it once
+	static IConsoleVariable* CVarDBSHitBoxes = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
+	bool bIsDebugEnabled = CVarDBSHitBoxes ? CVarDBSHitBoxes->GetBool() : false;
+	if (bIsDebugEnabled)
+	{
+		static IConsoleVariable* CVarDBSHitBoxesHistory = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes.History"));
+		bool bIsHistoryEnabled = CVarDBSHitBoxesHistory ? CVarDBSHitBoxesHistory->GetBool() : false;
+		DrawDebugSweep(
+			GetWorld(),
+			Sweep.HitResults,
+			Sweep.bHasHit,
+			Sweep.Start,
+			Sweep.End,
+			Sweep.CollisionShape,
+			Sweep.Rotation,
+			bIsHistoryEnabled ? 1.0f : -1.0f,
+			ShapeColor,
+			FColor::Yellow,
+			bIsHistoryEnabled ? 0.2f : -1.0f
+		);
+	}
+#endif
+
+	if (Sweep.bHasHit)
+	{
+		if (HitSinks.IsEmpty() && !OnHitRegistered.IsBound()) return;
+
+		FVector Direction = (Sweep.End - Sweep.Start).GetSafeNormal();
+		// one result reused for all hits, sinks get it by const ref
+		FDBSHitRegistratorHitResult HitRegistratorHitResult;
+		HitRegistratorHitResult.Direction = Direction;
+		// Default instigator is Character owning capsule, but don't forget to override it if needed
+		HitRegistratorHitResult.Instigator = GetOwner();
+		for (const FHitResult& HitResult : Sweep.HitResults)
+		{
+			// could be disabled by previous hit processing
+			if (!bIsHitRegistrationEnabled) break;
+			// segments of compound registrator hit same target together, it's one hit
+			if (!ShouldDispatchSegmentsHit(HitResult)) continue;
+
+			HitRegistratorHitResult.HitResult = HitResult;
+			HitRegistratorHitResult.HitActor = HitResult.GetActor();
+			HitRegistratorHitResult.PhysicalSurfaceType = UGameplayStatics::GetSurfaceType(HitResult);
+			DispatchHit(HitRegistratorHitResult);
+		}
+	}
+}
+
+void UDBSHitRegistratorBase::SetIsHitRegistrationEnabled(bool bIsEnabled_In, FDamageBehaviorHitDetectionSettings HitDetectionSettings)
+{
+	// IgnoredActors used for projectiles to avoid low-level(CapsuleHitRegistrator) hitting enemies
+	// if "AttachToCharacter"/"AttachToActors" not set
+	IgnoredActors.Empty();
+
+	CurrentHitDetectionSettings = HitDetectionSettings;
+	bQueryParamsDirty = true;
+	SegmentsHitObjects.Reset();
+	SegmentsHitFrame = 0;
+	// set again by UANS_InvokeDamageBehavior after enabling if its window is baked
+	BakedTrajectory.Reset();
+	LagCompensationDelay = 0.0f;
+
+	// new window - async results from previous one should never be delivered
+	if (bIsEnabled_In)
+	{
+		HitRegistrationWindow++;
+	}
+	PendingAsyncSweeps.Reset();
+	
+	switch (CurrentHitDetectionSettings.HitDetectionType)
+	{
+		case EDamageBehaviorHitDetectionType::ByEntering:
+		{
+			bIsHitRegistrationEnabled = bIsEnabled_In;
+			IConsoleVariable* DBSHitBoxesCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
+			UpdateCapsuleVisibility(DBSHitBoxesCVar && DBSHitBoxesCVar->GetBool());
+
+			if (bIsEnabled_In)
+			{
+				OnComponentBeginOverlap.AddUniqueDynamic(this, &UDBSHitRegistratorBase::OnBegingOverlap);
+				OnComponentEndOverlap.AddUniqueDynamic(this, &UDBSHitRegistratorBase::OnEndOverlap);
+				SetCollisionProfileName(CurrentHitDetectionSettings.CollisionProfileName.Name);
+
+				if (DBSHitBoxesCVar)
+				{
+					DBSHitBoxesCVar->OnChangedDelegate().AddUObject(this, &ThisClass::OnDebugCategoryChanged);
+				}
+				
+				if (CurrentHitDetectionSettings.bCheckOverlappingActorsOnStart)
+				{
+					// TODO check that UpdateOverlapsUpdates it on start
+					UpdateOverlaps();
+				}
+			}
+			else
+			{
+				OnComponentBeginOverlap.RemoveDynamic(this, &UDBSHitRegistratorBase::OnBegingOverlap);
+				OnComponentEndOverlap.RemoveDynamic(this, &UDBSHitRegistratorBase::OnEndOverlap);
+				SetCollisionProfileName(FName("NoCollision"));
+			}
+			break;
+		}
+		case EDamageBehaviorHitDetectionType::ByOverlapQuery:
+		case EDamageBehaviorHitDetectionType::WhileStandingInside:
+		{
+			// capsule stays NoCollision, no physics state changes and overlap events
+			bIsHitRegistrationEnabled = bIsEnabled_In;
+			LastOverlapQueryFrame = 0;
+			PreviousOverlappedComponents.Reset();
+			CurrentOverlappedComponents.Reset();
+			ClearStandingInsideOccupants();
+			if (bIsEnabled_In)
+			{
+				RebuildQueryParams();
+			}
+			break;
+		}
+		case EDamageBehaviorHitDetectionType::ByTrace:
+		case EDamageBehaviorHitDetectionType::ByHurtboxes:
+		{
+			PreviousComponentTransform = GetComponentTransform();
+			SetComponentTickEnabled(false);
+			bIsHitRegistrationEnabled = bIsEnabled_In;
+			NumDeferredSweepFrames = 0;
+			AnimatedMeshComponent = nullptr;
+			if (bIsEnabled_In)
+			{
+				// reused by every sweep of this window
+				RebuildQueryParams();
+
+				USceneComponent* Parent = GetAttachParent();
+				while (Parent && !Parent->IsA<USkeletalMeshComponent>())
+				{
+					Parent = Parent->GetAttachParent();
+				}
+				AnimatedMeshComponent = Cast<USkeletalMeshComponent>(Parent);
+				if (AnimatedMeshComponent.IsValid())
+				{
+					LastBoneTransformRevision = AnimatedMeshComponent->GetBoneTransformRevisionNumber();
+				}
+			}
+			break;
+		}
+	}
+}
+
+void UDBSHitRegistratorBase::AddActorsToIgnoreList(const TArray<AActor*>& Actors_In)
+{
+    IgnoredActors.Append(Actors_In);
+	bQueryParamsDirty = true;
+}
+
+void UDBSHitRegistratorBase::OnBegingOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (!HitSinks.IsEmpty() || OnHitRegistered.IsBound())
+	{
+		FDBSHitRegistratorHitResult HitRegistratorHitResult;
+		HitRegistratorHitResult.HitResult = SweepResult;
+		HitRegistratorHitResult.HitActor = OtherActor;
+		// Default instigator is Character owning capsule, but don't forget to override it if needed
+		HitRegistratorHitResult.Instigator = GetOwner();
+		HitRegistratorHitResult.PhysicalSurfaceType = UGameplayStatics::GetSurfaceType(SweepResult);
+		DispatchHit(HitRegistratorHitResult);
+	}
+}
+
+void UDBSHitRegistratorBase::DispatchHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DBS_DispatchHit);
+	INC_DWORD_STAT(STAT_DBS_HitsDispatched);
+
+	// index loop - sinks could be removed while processing hit
+	for (int32 i = 0; i < HitSinks.Num(); i++)
+	{
+		if (IDBSHitSink* HitSink = HitSinks[i].Get())
+		{
+			HitSink->HandleHit(HitRegistratorHitResult, this);
+		}
+	}
+
+	if (OnHitRegistered.IsBound())
+	{
+		OnHitRegistered.Broadcast(HitRegistratorHitResult, this);
+	}
+}
+
+void UDBSHitRegistratorBase::OnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+}
+
+void UDBSHitRegistratorBase::OnDebugCategoryChanged(IConsoleVariable* Var)
+{
+	UpdateCapsuleVisibility(Var->GetBool());
+}
+
+void UDBSHitRegistratorBase::UpdateCapsuleVisibility(bool bIsVisible_In)
+{
+	if (CurrentHitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::ByEntering)
+	{
+		bool bIsVisible = bIsHitRegistrationEnabled && bIsVisible_In;
+		SetHiddenInGame(!bIsVisible);
+	}
+}
+
+void UDBSHitRegistratorBase::DrawDebugSweep(const UWorld* World, const TArray<FHitResult>& OutHits, bool bResult, const FVector& Start, const FVector& End, const FCollisionShape& CollisionShape, const FQuat& Rot,
+	float DrawTime, FColor TraceColor, FColor HitColor, float FailDrawTime)
+{
+#if ENABLE_DRAW_DEBUG
+	FailDrawTime = FailDrawTime == -1.0f ? DrawTime : FailDrawTime;
+
+	DrawDebugShape(World, Start, Rot, CollisionShape, TraceColor, bResult ? DrawTime : FailDrawTime);
+	DrawDebugShape(World, End, Rot, CollisionShape, TraceColor, bResult ? DrawTime : FailDrawTime);
+	DrawDebugLine(World, Start, End, TraceColor, false, bResult ? DrawTime : FailDrawTime);
+
+	if (bResult)
+	{
+		float ShapeThickness = 0.0f;
+		float Reach = 0.0f;
+		GetShapeThicknessAndReach(CollisionShape, ShapeThickness, Reach);
+		float Thickness = FMath::Clamp(Reach / 100, 1.25, 5);
+		for (const FHitResult& OutHit : OutHits)
+		{
+			// UUnrealHelperLibraryBPLibrary::DebugPrintStrings(FString::Printf(TEXT("%f"), Thickness));
+			DrawDebugPoint(World, OutHit.ImpactPoint, 10.0f, HitColor, false, DrawTime, 0);
+			DrawDebugShape(World, OutHit.Location, Rot, CollisionShape, TraceColor, DrawTime, Thickness);
+		}
+	}
+#endif
+}
+
+void UDBSHitRegistratorBase::DrawDebugShape(const UWorld* World, const FVector& Location, const FQuat& Rot, const FCollisionShape& CollisionShape,
+	FColor Color, float DrawTime, float Thickness)
+{
+#if ENABLE_DRAW_DEBUG
+	switch (CollisionShape.ShapeType)
+	{
+		case ECollisionShape::Box:
+			DrawDebugBox(World, Location, CollisionShape.GetExtent(), Rot, Color, false, DrawTime, 0, Thickness);
+			break;
+		case ECollisionShape::Sphere:
+			DrawDebugSphere(World, Location, CollisionShape.GetSphereRadius(), 16, Color, false, DrawTime, 0, Thickness);
+			break;
+		case ECollisionShape::Capsule:
+			DrawDebugCapsule(World, Location, CollisionShape.GetCapsuleHalfHeight(), CollisionShape.GetCapsuleRadius(), Rot, Color, false, DrawTime, 0, Thickness);
+			break;
+		default:
+			break;
+	}
+#endif
+}
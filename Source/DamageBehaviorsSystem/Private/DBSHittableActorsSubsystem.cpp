@@ -0,0 +1,256 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHittableActorsSubsystem.h"
+
+#include "DamageBehaviorsSystemSettings.h"
+#include "DamageBehaviorsSystemStats.h"
+#include "EngineUtils.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSHittableActorsSubsystem)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hittable actors"), STAT_DBS_HittableActors, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Broadphase queries issued"), STAT_DBS_BroadphaseQueriesIssued, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Broadphase queries skipped"), STAT_DBS_BroadphaseQueriesSkipped, STATGROUP_DamageBehaviorsSystem);
+
+UDBSHittableActorsSubsystem* UDBSHittableActorsSubsystem::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<UDBSHittableActorsSubsystem>() : nullptr;
+}
+
+bool UDBSHittableActorsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	static IConsoleVariable* CVarDBSHittableBroadphase = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HittableBroadphase"));
+	const bool bIsEnabled = CVarDBSHittableBroadphase
+		? CVarDBSHittableBroadphase->GetBool()
+		: GetDefault<UDamageBehaviorsSystemSettings>()->bHittableActorsBroadphase;
+	return bIsEnabled && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UDBSHittableActorsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDBSHittableActorsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+	CellSize = FMath::Max(DamageBehaviorsSystemSettings->HittableActorsCellSize, 50.0f);
+	BoundsExpansion = FMath::Max(DamageBehaviorsSystemSettings->HittableActorsBoundsExpansion, 0.0f);
+}
+
+void UDBSHittableActorsSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!GetDefault<UDamageBehaviorsSystemSettings>()->bRegisterPawnsAsHittable) return;
+
+	for (APawn* Pawn : TActorRange<APawn>(&InWorld))
+	{
+		RegisterHittableActor(Pawn);
+	}
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+}
+
+void UDBSHittableActorsSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	ActorSpawnedHandle.Reset();
+
+	for (const FDBSHittableActor& HittableActor : HittableActors)
+	{
+		if (USceneComponent* RootComponent = HittableActor.RootComponent.Get())
+		{
+			RootComponent->TransformUpdated.Remove(HittableActor.TransformUpdatedHandle);
+		}
+		if (AActor* Actor = HittableActor.Actor.Get())
+		{
+			Actor->OnEndPlay.RemoveDynamic(this, &ThisClass::OnHittableActorEndPlay);
+		}
+	}
+	HittableActors.Empty();
+	HittableActorIndices.Empty();
+	Cells.Empty();
+
+	SET_DWORD_STAT(STAT_DBS_HittableActors, 0);
+
+	Super::Deinitialize();
+}
+
+void UDBSHittableActorsSubsystem::RegisterHittableActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || HittableActorIndices.Contains(Actor)) return;
+
+	USceneComponent* RootComponent = Actor->GetRootComponent();
+	if (!RootComponent) return;
+
+	const int32 Index = HittableActors.Add({});
+	FDBSHittableActor& HittableActor = HittableActors[Index];
+	HittableActor.Actor = Actor;
+	HittableActor.RootComponent = RootComponent;
+	HittableActor.TransformUpdatedHandle = RootComponent->TransformUpdated.AddUObject(this, &ThisClass::OnHittableTransformUpdated, Index);
+	HittableActorIndices.Add(Actor, Index);
+	Actor->OnEndPlay.AddUniqueDynamic(this, &ThisClass::OnHittableActorEndPlay);
+
+	// cells of new entry are empty range, first update adds it to all cells it overlaps
+	HittableActor.Bounds = RootComponent->Bounds.GetBox().ExpandBy(BoundsExpansion);
+	HittableActor.MinCell = GetCell(HittableActor.Bounds.Min);
+	HittableActor.MaxCell = GetCell(HittableActor.Bounds.Max);
+	AddToCells(Index, HittableActor.MinCell, HittableActor.MaxCell);
+
+	SET_DWORD_STAT(STAT_DBS_HittableActors, HittableActors.Num());
+}
+
+void UDBSHittableActorsSubsystem::UnregisterHittableActor(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+	if (!HittableActorIndices.RemoveAndCopyValue(Actor, Index)) return;
+
+	const FDBSHittableActor& HittableActor = HittableActors[Index];
+	if (USceneComponent* RootComponent = HittableActor.RootComponent.Get())
+	{
+		RootComponent->TransformUpdated.Remove(HittableActor.TransformUpdatedHandle);
+	}
+	if (IsValid(Actor))
+	{
+		Actor->OnEndPlay.RemoveDynamic(this, &ThisClass::OnHittableActorEndPlay);
+	}
+	RemoveFromCells(Index, HittableActor.MinCell, HittableActor.MaxCell);
+	HittableActors.RemoveAt(Index);
+
+	SET_DWORD_STAT(STAT_DBS_HittableActors, HittableActors.Num());
+}
+
+bool UDBSHittableActorsSubsystem::HasHittableActorsInBounds(const FBox& Bounds, TConstArrayView<const AActor*> IgnoredActors) const
+{
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+	const FIntVector CellsCount = MaxCell - MinCell + FIntVector(1);
+	if (static_cast<int64>(CellsCount.X) * CellsCount.Y * CellsCount.Z > MaxQueryCells) return true;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const TArray<int32, TInlineAllocator<4>>* Cell = Cells.Find(FIntVector(X, Y, Z));
+				if (!Cell) continue;
+
+				for (const int32 Index : *Cell)
+				{
+					const FDBSHittableActor& HittableActor = HittableActors[Index];
+					if (!HittableActor.Bounds.Intersect(Bounds)) continue;
+					// raw pointer compare only, actor could be pending kill but still in registry
+					if (IgnoredActors.Contains(HittableActor.Actor.GetEvenIfUnreachable())) continue;
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void UDBSHittableActorsSubsystem::RecordQuery(bool bIssued) const
+{
+	if (bIssued)
+	{
+		NumQueriesIssued++;
+		INC_DWORD_STAT(STAT_DBS_BroadphaseQueriesIssued);
+	}
+	else
+	{
+		NumQueriesSkipped++;
+		INC_DWORD_STAT(STAT_DBS_BroadphaseQueriesSkipped);
+	}
+}
+
+FIntVector UDBSHittableActorsSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize)
+	);
+}
+
+void UDBSHittableActorsSubsystem::UpdateHittableActor(int32 Index)
+{
+	FDBSHittableActor& HittableActor = HittableActors[Index];
+	const USceneComponent* RootComponent = HittableActor.RootComponent.Get();
+	if (!RootComponent) return;
+
+	HittableActor.Bounds = RootComponent->Bounds.GetBox().ExpandBy(BoundsExpansion);
+	const FIntVector MinCell = GetCell(HittableActor.Bounds.Min);
+	const FIntVector MaxCell = GetCell(HittableActor.Bounds.Max);
+
+	// most of movement stays in same cells
+	if (MinCell == HittableActor.MinCell && MaxCell == HittableActor.MaxCell) return;
+
+	RemoveFromCells(Index, HittableActor.MinCell, HittableActor.MaxCell);
+	AddToCells(Index, MinCell, MaxCell);
+	HittableActor.MinCell = MinCell;
+	HittableActor.MaxCell = MaxCell;
+}
+
+void UDBSHittableActorsSubsystem::AddToCells(int32 Index, const FIntVector& MinCell, const FIntVector& MaxCell)
+{
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(Index);
+			}
+		}
+	}
+}
+
+void UDBSHittableActorsSubsystem::RemoveFromCells(int32 Index, const FIntVector& MinCell, const FIntVector& MaxCell)
+{
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const FIntVector CellKey(X, Y, Z);
+				TArray<int32, TInlineAllocator<4>>* Cell = Cells.Find(CellKey);
+				if (!Cell) continue;
+
+				Cell->RemoveSingleSwap(Index, EAllowShrinking::No);
+				if (Cell->IsEmpty())
+				{
+					Cells.Remove(CellKey);
+				}
+			}
+		}
+	}
+}
+
+void UDBSHittableActorsSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (Actor && Actor->IsA<APawn>())
+	{
+		RegisterHittableActor(Actor);
+	}
+}
+
+void UDBSHittableActorsSubsystem::OnHittableTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 Index)
+{
+	if (!HittableActors.IsValidIndex(Index)) return;
+	UpdateHittableActor(Index);
+}
+
+void UDBSHittableActorsSubsystem::OnHittableActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterHittableActor(Actor);
+}
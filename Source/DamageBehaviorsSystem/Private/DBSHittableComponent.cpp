@@ -0,0 +1,32 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHittableComponent.h"
+
+#include "DBSHittableActorsSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSHittableComponent)
+
+UDBSHittableComponent::UDBSHittableComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UDBSHittableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UDBSHittableActorsSubsystem* HittableActorsSubsystem = UDBSHittableActorsSubsystem::Get(GetWorld()))
+	{
+		HittableActorsSubsystem->RegisterHittableActor(GetOwner());
+	}
+}
+
+void UDBSHittableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDBSHittableActorsSubsystem* HittableActorsSubsystem = UDBSHittableActorsSubsystem::Get(GetWorld()))
+	{
+		HittableActorsSubsystem->UnregisterHittableActor(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
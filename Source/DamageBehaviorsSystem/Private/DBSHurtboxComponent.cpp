@@ -0,0 +1,47 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHurtboxComponent.h"
+
+#include "DBSHurtboxesSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSHurtboxComponent)
+
+UDBSHurtboxComponent::UDBSHurtboxComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UDBSHurtboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UDBSHurtboxesSubsystem* HurtboxesSubsystem = UDBSHurtboxesSubsystem::Get(GetWorld()))
+	{
+		HurtboxesSubsystem->RegisterHurtbox(this);
+	}
+}
+
+UPrimitiveComponent* UDBSHurtboxComponent::GetHitComponent() const
+{
+	for (USceneComponent* Parent = GetAttachParent(); Parent; Parent = Parent->GetAttachParent())
+	{
+		if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Parent))
+		{
+			return Primitive;
+		}
+	}
+	const AActor* Owner = GetOwner();
+	return Owner ? Cast<UPrimitiveComponent>(Owner->GetRootComponent()) : nullptr;
+}
+
+void UDBSHurtboxComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDBSHurtboxesSubsystem* HurtboxesSubsystem = UDBSHurtboxesSubsystem::Get(GetWorld()))
+	{
+		HurtboxesSubsystem->UnregisterHurtbox(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
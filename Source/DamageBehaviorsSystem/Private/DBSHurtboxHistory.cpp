@@ -0,0 +1,123 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHurtboxHistory.h"
+
+namespace
+{
+	int16 QuantizeLocation(double Value)
+	{
+		return static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(Value * FDBSHurtboxHistory::LocationQuantizationScale), MIN_int16, MAX_int16));
+	}
+
+	int16 QuantizeUnit(double Value)
+	{
+		return static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(Value * MAX_int16), -MAX_int16, MAX_int16));
+	}
+}
+
+void FDBSHurtboxHistory::Init(int32 Capacity_In, int32 NumHurtboxes_In)
+{
+	Capacity = FMath::Max(Capacity_In, 2);
+	NumHurtboxes = FMath::Clamp(NumHurtboxes_In, 0, MaxHurtboxes);
+	Head = 0;
+	NumSamples = 0;
+
+	Times.SetNumZeroed(Capacity);
+	Origins.SetNumZeroed(Capacity);
+	EnabledMasks.SetNumZeroed(Capacity);
+
+	const int32 NumEntries = Capacity * NumHurtboxes;
+	for (TArray<int16>* Channel : { &LocationX, &LocationY, &LocationZ, &RotationX, &RotationY, &RotationZ, &RotationW })
+	{
+		Channel->SetNumZeroed(NumEntries);
+	}
+}
+
+void FDBSHurtboxHistory::Record(double Time, const FVector& Origin, TConstArrayView<FTransform> Transforms, uint32 EnabledMask)
+{
+	if (Capacity == 0 || Transforms.Num() != NumHurtboxes) return;
+
+	Times[Head] = Time;
+	Origins[Head] = Origin;
+	EnabledMasks[Head] = EnabledMask;
+
+	const int32 FirstEntry = Head * NumHurtboxes;
+	for (int32 i = 0; i < NumHurtboxes; i++)
+	{
+		const FVector Location = Transforms[i].GetLocation() - Origin;
+		const FQuat Rotation = Transforms[i].GetRotation().GetNormalized();
+
+		const int32 Entry = FirstEntry + i;
+		LocationX[Entry] = QuantizeLocation(Location.X);
+		LocationY[Entry] = QuantizeLocation(Location.Y);
+		LocationZ[Entry] = QuantizeLocation(Location.Z);
+		RotationX[Entry] = QuantizeUnit(Rotation.X);
+		RotationY[Entry] = QuantizeUnit(Rotation.Y);
+		RotationZ[Entry] = QuantizeUnit(Rotation.Z);
+		RotationW[Entry] = QuantizeUnit(Rotation.W);
+	}
+
+	Head = (Head + 1) % Capacity;
+	NumSamples = FMath::Min(NumSamples + 1, Capacity);
+}
+
+bool FDBSHurtboxHistory::Rewind(double Time, TArrayView<FTransform> OutTransforms, uint32& OutEnabledMask) const
+{
+	if (NumSamples == 0 || OutTransforms.Num() != NumHurtboxes) return false;
+
+	// first sample newer than Time, samples are sorted by age
+	int32 First = 0;
+	int32 Count = NumSamples;
+	while (Count > 0)
+	{
+		const int32 Step = Count / 2;
+		if (Times[GetSampleIndex(First + Step)] <= Time)
+		{
+			First += Step + 1;
+			Count -= Step + 1;
+		}
+		else
+		{
+			Count = Step;
+		}
+	}
+
+	const int32 OlderIndex = GetSampleIndex(FMath::Max(First - 1, 0));
+	const int32 NewerIndex = GetSampleIndex(FMath::Min(First, NumSamples - 1));
+	const double TimeRange = Times[NewerIndex] - Times[OlderIndex];
+	const float Alpha = TimeRange > UE_SMALL_NUMBER
+		? static_cast<float>(FMath::Clamp((Time - Times[OlderIndex]) / TimeRange, 0.0, 1.0))
+		: 0.0f;
+
+	// disabled at any of two samples counts as disabled, no hits on dodge frames edges
+	OutEnabledMask = EnabledMasks[OlderIndex] & EnabledMasks[NewerIndex];
+	for (int32 i = 0; i < NumHurtboxes; i++)
+	{
+		const FTransform Older = GetTransform(OlderIndex, i);
+		const FTransform Newer = GetTransform(NewerIndex, i);
+		OutTransforms[i] = FTransform(
+			FQuat::Slerp(Older.GetRotation(), Newer.GetRotation(), Alpha),
+			FMath::Lerp(Older.GetLocation(), Newer.GetLocation(), Alpha));
+	}
+	return true;
+}
+
+double FDBSHurtboxHistory::GetOldestTime() const
+{
+	return NumSamples > 0 ? Times[GetSampleIndex(0)] : 0.0;
+}
+
+SIZE_T FDBSHurtboxHistory::GetAllocatedSize() const
+{
+	return Times.GetAllocatedSize() + Origins.GetAllocatedSize() + EnabledMasks.GetAllocatedSize()
+		+ LocationX.GetAllocatedSize() + LocationY.GetAllocatedSize() + LocationZ.GetAllocatedSize()
+		+ RotationX.GetAllocatedSize() + RotationY.GetAllocatedSize() + RotationZ.GetAllocatedSize() + RotationW.GetAllocatedSize();
+}
+
+FTransform FDBSHurtboxHistory::GetTransform(int32 SampleIndex, int32 HurtboxIndex) const
+{
+	const int32 Entry = SampleIndex * NumHurtboxes + HurtboxIndex;
+	const FVector Location = Origins[SampleIndex] + FVector(LocationX[Entry], LocationY[Entry], LocationZ[Entry]) / LocationQuantizationScale;
+	const FQuat Rotation = FQuat(RotationX[Entry], RotationY[Entry], RotationZ[Entry], RotationW[Entry]).GetNormalized();
+	return FTransform(Rotation, Location);
+}
@@ -0,0 +1,288 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHurtboxesSubsystem.h"
+
+#include "DBSHitRegistratorSweep.h"
+#include "DBSHurtboxComponent.h"
+#include "DamageBehaviorsSystemSettings.h"
+#include "DamageBehaviorsSystemStats.h"
+#include "DrawDebugHelpers.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DBSHurtboxesSubsystem)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hurtboxes"), STAT_DBS_Hurtboxes, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hurtbox sweeps"), STAT_DBS_HurtboxSweeps, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Rebuild hurtboxes snapshot"), STAT_DBS_RebuildHurtboxesSnapshot, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Record hurtboxes history"), STAT_DBS_RecordHurtboxesHistory, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Rewind hurtboxes"), STAT_DBS_RewindHurtboxes, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rewound hurtboxes snapshots"), STAT_DBS_RewoundHurtboxesSnapshots, STATGROUP_DamageBehaviorsSystem);
+DECLARE_MEMORY_STAT(TEXT("Hurtboxes history memory"), STAT_DBS_HurtboxesHistoryMemory, STATGROUP_DamageBehaviorsSystem);
+
+UDBSHurtboxesSubsystem* UDBSHurtboxesSubsystem::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<UDBSHurtboxesSubsystem>() : nullptr;
+}
+
+bool UDBSHurtboxesSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDBSHurtboxesSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	static IConsoleVariable* CVarDBSLagCompensation = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.LagCompensation"));
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+	bIsLagCompensationEnabled = CVarDBSLagCompensation
+		? CVarDBSLagCompensation->GetBool()
+		: DamageBehaviorsSystemSettings->bLagCompensation;
+	LagCompensationHistorySize = FMath::Max(DamageBehaviorsSystemSettings->LagCompensationHistorySize, 2);
+
+	if (bIsLagCompensationEnabled)
+	{
+		// after all actors ticked, hurtboxes are where clients will see them
+		WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::RecordHurtboxesHistory);
+	}
+}
+
+void UDBSHurtboxesSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	WorldPostActorTickHandle.Reset();
+
+	Hurtboxes.Empty();
+	HurtboxesSnapshot = {};
+	HurtboxesHistory.Empty();
+	RewoundSnapshots.Empty();
+	RewoundSnapshotsTimes.Empty();
+	SET_DWORD_STAT(STAT_DBS_Hurtboxes, 0);
+	SET_MEMORY_STAT(STAT_DBS_HurtboxesHistoryMemory, 0);
+
+	Super::Deinitialize();
+}
+
+void UDBSHurtboxesSubsystem::RegisterHurtbox(UDBSHurtboxComponent* Hurtbox)
+{
+	if (!IsValid(Hurtbox)) return;
+
+	if (Hurtboxes.Contains(Hurtbox)) return;
+
+	Hurtboxes.Add(Hurtbox);
+	bIsHurtboxesSnapshotDirty = true;
+	AddToHurtboxesHistory(Hurtbox);
+	SET_DWORD_STAT(STAT_DBS_Hurtboxes, Hurtboxes.Num());
+}
+
+void UDBSHurtboxesSubsystem::UnregisterHurtbox(UDBSHurtboxComponent* Hurtbox)
+{
+	if (Hurtboxes.RemoveSingleSwap(Hurtbox, EAllowShrinking::No) == 0) return;
+
+	// removed hurtbox shouldn't be hit even in current frame
+	bIsHurtboxesSnapshotDirty = true;
+	RemoveFromHurtboxesHistory(Hurtbox);
+	SET_DWORD_STAT(STAT_DBS_Hurtboxes, Hurtboxes.Num());
+}
+
+const FDBSHurtboxesSnapshot& UDBSHurtboxesSubsystem::GetHurtboxesSnapshot()
+{
+	// hurtboxes follow animated bones, gather them once per frame after animation
+	if (bIsHurtboxesSnapshotDirty || HurtboxesSnapshotFrame != GFrameCounter)
+	{
+		RebuildHurtboxesSnapshot();
+	}
+	return HurtboxesSnapshot;
+}
+
+void UDBSHurtboxesSubsystem::RebuildHurtboxesSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DBS_RebuildHurtboxesSnapshot);
+
+	HurtboxesSnapshotFrame = GFrameCounter;
+	bIsHurtboxesSnapshotDirty = false;
+
+	// floats in snapshot are relative to first hurtbox, keeps precision in large worlds
+	HurtboxesSnapshot.Capsules.Reset(Hurtboxes.Num() > 0 && Hurtboxes[0] ? Hurtboxes[0]->GetComponentLocation() : FVector::ZeroVector);
+	HurtboxesSnapshot.Hurtboxes.Reset();
+	HurtboxesSnapshot.Owners.Reset();
+	HurtboxesSnapshot.HitComponents.Reset();
+
+#if ENABLE_DRAW_DEBUG
+	static IConsoleVariable* CVarDBSHitBoxes = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
+	const bool bIsDebugEnabled = CVarDBSHitBoxes && CVarDBSHitBoxes->GetBool();
+#endif
+
+	for (const UDBSHurtboxComponent* Hurtbox : Hurtboxes)
+	{
+		if (!IsValid(Hurtbox) || !Hurtbox->bIsHurtboxEnabled) continue;
+
+		const FTransform& Transform = Hurtbox->GetComponentTransform();
+		const float Radius = Hurtbox->GetScaledCapsuleRadius();
+		const float HalfHeight = Hurtbox->GetScaledCapsuleHalfHeight();
+		HurtboxesSnapshot.Capsules.Add(Transform.GetLocation(), Transform.GetRotation(), Radius, HalfHeight);
+		HurtboxesSnapshot.Hurtboxes.Add(Hurtbox);
+		HurtboxesSnapshot.Owners.Add(Hurtbox->GetOwner());
+		HurtboxesSnapshot.HitComponents.Add(Hurtbox->GetHitComponent());
+
+#if ENABLE_DRAW_DEBUG
+		if (bIsDebugEnabled)
+		{
+			DrawDebugCapsule(GetWorld(), Transform.GetLocation(), HalfHeight, Radius, Transform.GetRotation(), FColor::Green);
+		}
+#endif
+	}
+}
+
+const FDBSHurtboxesSnapshot& UDBSHurtboxesSubsystem::GetRewoundHurtboxesSnapshot(double Time)
+{
+	if (!bIsLagCompensationEnabled) return GetHurtboxesSnapshot();
+
+	if (RewoundSnapshotsFrame != GFrameCounter)
+	{
+		RewoundSnapshotsFrame = GFrameCounter;
+		RewoundSnapshotsTimes.Reset();
+	}
+
+	const int32 ExistingIndex = RewoundSnapshotsTimes.Find(Time);
+	if (ExistingIndex != INDEX_NONE) return *RewoundSnapshots[ExistingIndex];
+
+	const int32 Index = RewoundSnapshotsTimes.Add(Time);
+	if (!RewoundSnapshots.IsValidIndex(Index))
+	{
+		RewoundSnapshots.Add(MakeUnique<FDBSHurtboxesSnapshot>());
+	}
+	RebuildRewoundHurtboxesSnapshot(Time, *RewoundSnapshots[Index]);
+	SET_DWORD_STAT(STAT_DBS_RewoundHurtboxesSnapshots, RewoundSnapshotsTimes.Num());
+	return *RewoundSnapshots[Index];
+}
+
+void UDBSHurtboxesSubsystem::AddToHurtboxesHistory(const UDBSHurtboxComponent* Hurtbox)
+{
+	AActor* Owner = Hurtbox->GetOwner();
+	if (!bIsLagCompensationEnabled || !Owner) return;
+
+	FDBSHurtboxesHistoryEntry& Entry = HurtboxesHistory.FindOrAdd(Owner);
+	Entry.Owner = Owner;
+	Entry.Hurtboxes.Add(Hurtbox);
+	// samples layout depends on hurtboxes count, hurtboxes are added on BeginPlay so nothing valuable lost
+	Entry.History.Init(LagCompensationHistorySize, Entry.Hurtboxes.Num());
+}
+
+void UDBSHurtboxesSubsystem::RemoveFromHurtboxesHistory(const UDBSHurtboxComponent* Hurtbox)
+{
+	if (!bIsLagCompensationEnabled) return;
+
+	for (auto It = HurtboxesHistory.CreateIterator(); It; ++It)
+	{
+		FDBSHurtboxesHistoryEntry& Entry = It.Value();
+		if (Entry.Hurtboxes.Remove(Hurtbox) == 0) continue;
+
+		if (Entry.Hurtboxes.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+		else
+		{
+			Entry.History.Init(LagCompensationHistorySize, Entry.Hurtboxes.Num());
+		}
+		break;
+	}
+}
+
+void UDBSHurtboxesSubsystem::RecordHurtboxesHistory(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// clients never validate hits of others
+	if (World != GetWorld() || World->GetNetMode() == NM_Client) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_DBS_RecordHurtboxesHistory);
+
+	const double Time = World->GetTimeSeconds();
+	SIZE_T HistoryMemory = 0;
+	for (TPair<TObjectKey<AActor>, FDBSHurtboxesHistoryEntry>& Pair : HurtboxesHistory)
+	{
+		FDBSHurtboxesHistoryEntry& Entry = Pair.Value;
+		const int32 NumRecorded = Entry.History.GetNumHurtboxes();
+		HistoryTransforms.SetNum(NumRecorded, EAllowShrinking::No);
+
+		uint32 EnabledMask = 0;
+		for (int32 i = 0; i < NumRecorded; i++)
+		{
+			const UDBSHurtboxComponent* Hurtbox = Entry.Hurtboxes[i];
+			HistoryTransforms[i] = Hurtbox->GetComponentTransform();
+			if (Hurtbox->bIsHurtboxEnabled)
+			{
+				EnabledMask |= 1u << i;
+			}
+		}
+		// offsets from owner stay small, quantized in int16
+		Entry.History.Record(Time, Entry.Owner->GetActorLocation(), HistoryTransforms, EnabledMask);
+		HistoryMemory += Entry.History.GetAllocatedSize();
+	}
+	SET_MEMORY_STAT(STAT_DBS_HurtboxesHistoryMemory, HistoryMemory);
+}
+
+void UDBSHurtboxesSubsystem::RebuildRewoundHurtboxesSnapshot(double Time, FDBSHurtboxesSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DBS_RewindHurtboxes);
+
+	Snapshot.Capsules.Reset(Hurtboxes.Num() > 0 && Hurtboxes[0] ? Hurtboxes[0]->GetComponentLocation() : FVector::ZeroVector);
+	Snapshot.Hurtboxes.Reset();
+	Snapshot.Owners.Reset();
+	Snapshot.HitComponents.Reset();
+
+	for (const TPair<TObjectKey<AActor>, FDBSHurtboxesHistoryEntry>& Pair : HurtboxesHistory)
+	{
+		const FDBSHurtboxesHistoryEntry& Entry = Pair.Value;
+		HistoryTransforms.SetNum(Entry.History.GetNumHurtboxes(), EAllowShrinking::No);
+		uint32 EnabledMask = 0;
+		const bool bIsRewound = Entry.History.Rewind(Time, HistoryTransforms, EnabledMask);
+
+		for (int32 i = 0; i < Entry.Hurtboxes.Num(); i++)
+		{
+			const UDBSHurtboxComponent* Hurtbox = Entry.Hurtboxes[i];
+			if (!IsValid(Hurtbox)) continue;
+
+			const bool bIsRecorded = bIsRewound && i < HistoryTransforms.Num();
+			const bool bIsEnabled = bIsRecorded ? (EnabledMask & (1u << i)) != 0 : Hurtbox->bIsHurtboxEnabled;
+			if (!bIsEnabled) continue;
+
+			const FTransform& Transform = bIsRecorded ? HistoryTransforms[i] : Hurtbox->GetComponentTransform();
+			Snapshot.Capsules.Add(Transform.GetLocation(), Transform.GetRotation(), Hurtbox->GetScaledCapsuleRadius(), Hurtbox->GetScaledCapsuleHalfHeight());
+			Snapshot.Hurtboxes.Add(Hurtbox);
+			Snapshot.Owners.Add(Entry.Owner);
+			Snapshot.HitComponents.Add(Hurtbox->GetHitComponent());
+		}
+	}
+}
+
+void UDBSHurtboxesSubsystem::ExecuteSweep(FDBSHitRegistratorSweep& Sweep)
+{
+	INC_DWORD_STAT(STAT_DBS_HurtboxSweeps);
+
+	const FDBSHurtboxesSnapshot& Snapshot = *Sweep.Hurtboxes;
+
+	// per thread scratch, sweeps could run in parallel
+	static thread_local TArray<FDBSCapsuleSweepHit> SweepHits;
+	SweepHits.Reset();
+	FDBSCapsuleSweepKernel::SweepCapsuleAgainstCapsules(Sweep, Snapshot.Capsules, SweepHits);
+
+	for (const FDBSCapsuleSweepHit& SweepHit : SweepHits)
+	{
+		AActor* Owner = Snapshot.Owners[SweepHit.TargetIndex];
+		if (Sweep.IgnoredActors.Contains(Owner)) continue;
+
+		const UDBSHurtboxComponent* Hurtbox = Snapshot.Hurtboxes[SweepHit.TargetIndex];
+		FHitResult& HitResult = Sweep.HitResults.AddDefaulted_GetRef();
+		FDBSCapsuleSweepKernel::MakeHitResult(Sweep, SweepHit, HitResult);
+		HitResult.HitObjectHandle = FActorInstanceHandle(Owner);
+		// hurtbox is not a primitive, mesh it's attached to reported as Component,
+		// bone lets ProcessHit know which body part was hit
+		HitResult.Component = Snapshot.HitComponents[SweepHit.TargetIndex];
+		HitResult.BoneName = Hurtbox->GetAttachSocketName();
+		HitResult.PhysMaterial = Hurtbox->PhysicalMaterial;
+	}
+	Sweep.bHasHit = Sweep.HitResults.Num() > 0;
+}
@@ -4,7 +4,9 @@
 #include "DamageBehavior.h"
 
 #include "Kismet/GameplayStatics.h"
-#include "CapsuleHitRegistrator.h"
+#include "DBSCapture.h"
+#include "DBSHitRegistratorBase.h"
+#include "DamageBehaviorsSubsystem.h"
 #include "DamageBehaviorsSystemSettings.h"
 #include "Engine/SCS_Node.h"
 #include "Engine/SimpleConstructionScript.h"
@@ -14,8 +16,7 @@
 
 UDamageBehavior::UDamageBehavior()
 {
-	// by default FTickableGameObject use TG_PostPhysics
-	// SetTickGroup(TG_PostPhysics);
+	// ticked by UDamageBehaviorsSubsystem in settings "ActiveBehaviorsTickGroup"
 }
 
 void UDamageBehavior::Init(
@@ -30,10 +31,11 @@ void UDamageBehavior::Init(
 	{
 		if (IsValid(CapsuleHitRegistratorsSource.Actor) && CapsuleHitRegistratorsSource.CapsuleHitRegistrators.Num() > 0)
 		{
-			for (UCapsuleHitRegistrator* CapsuleHitRegistrator : CapsuleHitRegistratorsSource.CapsuleHitRegistrators)
+			for (UDBSHitRegistratorBase* CapsuleHitRegistrator : CapsuleHitRegistratorsSource.CapsuleHitRegistrators)
 			{
-				// TODO check that "AddUniqueDynamic" correctly works
-				CapsuleHitRegistrator->OnHitRegistered.AddUniqueDynamic(this, &UDamageBehavior::HandleHitInternally);
+				if (!IsValid(CapsuleHitRegistrator)) continue;
+				// native direct call, no reflection on hit
+				CapsuleHitRegistrator->AddHitSink(this);
 			}	
 		}
 		else
@@ -46,7 +48,7 @@ void UDamageBehavior::Init(
 AActor* UDamageBehavior::GetHitTarget_Implementation(
 	AActor* HitActor_In,
 	const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
-	UCapsuleHitRegistrator* CapsuleHitRegistrator) const
+	UDBSHitRegistratorBase* CapsuleHitRegistrator) const
 {
 	return GetRootAttachedActor(HitActor_In);
 }
@@ -56,10 +58,10 @@ AActor* UDamageBehavior::GetInstigator_Implementation() const
 	return GetOwningActor();
 }
 
-TArray<UCapsuleHitRegistrator*> UDamageBehavior::GetCapsuleHitRegistratorsFromAllSources() const
+TArray<UDBSHitRegistratorBase*> UDamageBehavior::GetCapsuleHitRegistratorsFromAllSources() const
 {
-	TArray<UCapsuleHitRegistrator*> Result = {};
-	for (FDBSHitRegistratorsSource CapsuleHitRegistratorsSource : HitRegistratorsSources)
+	TArray<UDBSHitRegistratorBase*> Result = {};
+	for (const FDBSHitRegistratorsSource& CapsuleHitRegistratorsSource : HitRegistratorsSources)
 	{
 		Result.Append(CapsuleHitRegistratorsSource.CapsuleHitRegistrators);
 	}
@@ -168,29 +170,45 @@ TArray<FString> UDamageBehavior::GetHitRegistratorsNameOptions() const
 {
 	TArray<FString> Result = {};
 	UObject* Outer = GetOuter();
-	Result = GetNamesOfComponentsOnObject(Outer, UCapsuleHitRegistrator::StaticClass());
+	Result = GetNamesOfComponentsOnObject(Outer, UDBSHitRegistratorBase::StaticClass());
 	return Result;
 }
 
-void UDamageBehavior::HandleHitInternally(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UCapsuleHitRegistrator* CapsuleHitRegistrator)
+void UDamageBehavior::HandleHitInternally(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator)
 {
-    if (!bIsActive) return;
-
     AActor* HitActor = HitRegistratorHitResult.HitActor.Get();
-    if (!IsValid(HitActor) || this->HitActors.Contains(HitActor)) return;
+	const double HitTime = GetHitPolicyTime();
+	const EDBSHitPolicyResult HitPolicyResult = bIsActive && IsValid(HitActor)
+		? CheckHitPolicy(HitActor, HitTime)
+		: EDBSHitPolicyResult::Accepted;
+	if (!bIsActive || !IsValid(HitActor) || HitPolicyResult != EDBSHitPolicyResult::Accepted)
+	{
+		if (FDBSCapture::IsCapturing())
+		{
+			FDBSCapture::RecordHitDecision(this, HitActor,
+				!bIsActive ? EDBSCaptureHitDecision::RejectedInactive
+				: !IsValid(HitActor) ? EDBSCaptureHitDecision::RejectedInvalidActor
+				: HitPolicyResult == EDBSHitPolicyResult::RejectedReHitInterval ? EDBSCaptureHitDecision::RejectedReHitInterval
+				: HitPolicyResult == EDBSHitPolicyResult::RejectedMaxHitsPerTarget ? EDBSCaptureHitDecision::RejectedMaxHitsPerTarget
+				: HitPolicyResult == EDBSHitPolicyResult::RejectedMaxTargets ? EDBSCaptureHitDecision::RejectedMaxTargets
+				: EDBSCaptureHitDecision::RejectedAlreadyHit);
+		}
+		return;
+	}
 
-	auto CVarDBSHitLog = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitLog"));
+	// lookup by name builds FString key, do it once. Log strings are built only when HitLog enabled
+	static IConsoleVariable* CVarDBSHitLog = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitLog"));
 	bool bIsDebugEnabled = CVarDBSHitLog ? CVarDBSHitLog->GetBool() : false;
 	if (bIsDebugEnabled && OwnerActor.IsValid())
 	{
 		FString HitActorsStr = "";
-		for (TWeakObjectPtr<AActor> Actor : this->HitActors)
+		this->HitActors.ForEach([&HitActorsStr](const FDBSHitActorsSet::FEntry& Entry)
 		{
-			if (Actor.IsValid())
+			if (const UObject* Actor = Entry.Key.ResolveObjectPtr())
 			{
-				HitActorsStr += Actor.Get()->GetName() + ", ";
+				HitActorsStr += Actor->GetName() + ", ";
 			}
-		}
+		});
 
 		int32 Seconds = 0;
 		double Milliseconds = 0;
@@ -216,8 +234,14 @@ void UDamageBehavior::HandleHitInternally(const FDBSHitRegistratorHitResult& Hit
 	}
 
 	AActor* HitTargetActor = HitActor;
+	HitSerial++;
     if (CanBeAddedToHittedActors(HitRegistratorHitResult, CapsuleHitRegistrator))
     {
+    	if (!this->HitActors.Contains(HitActor))
+    	{
+    		NumHitTargets++;
+    	}
+
     	// UObject* HitTarget = IHittableInterface::Execute_GetHitTarget(HitActor);
     	HitTargetActor = GetHitTarget(HitActor, HitRegistratorHitResult, CapsuleHitRegistrator);
     	if (IsValid(HitTargetActor) && IsValid(HitActor) && HitTargetActor != HitActor)
@@ -239,9 +263,17 @@ void UDamageBehavior::HandleHitInternally(const FDBSHitRegistratorHitResult& Hit
 
 	FInstancedStruct Payload_Out = {};
 	bool bResult = ProcessHit(HitRegistratorHitResult, CapsuleHitRegistrator, Payload_Out);
+	if (FDBSCapture::IsCapturing())
+	{
+		FDBSCapture::RecordHitDecision(this, HitActor, bResult ? EDBSCaptureHitDecision::Accepted : EDBSCaptureHitDecision::RejectedByProcessHit);
+	}
 
 	if (bResult)
 	{
+		if (IDBSDamageBehaviorHitSink* HitSink = DamageBehaviorHitSink.Get())
+		{
+			HitSink->HandleDamageBehaviorHit(HitRegistratorHitResult, this, CapsuleHitRegistrator, Payload_Out);
+		}
 		if (OnHitRegistered.IsBound())
 		{
 			OnHitRegistered.Broadcast(HitRegistratorHitResult, this, CapsuleHitRegistrator, Payload_Out);
@@ -249,108 +281,193 @@ void UDamageBehavior::HandleHitInternally(const FDBSHitRegistratorHitResult& Hit
 	}
 }
 
-void UDamageBehavior::Tick(float DeltaTime)
+void UDamageBehavior::HandleHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator)
+{
+	HandleHitInternally(HitRegistratorHitResult, CapsuleHitRegistrator);
+}
+
+void UDamageBehavior::Tick(float DeltaTime, FDBSHitRegistratorSweepBatch* SweepBatch)
 {
 	if (!bIsActive)
 	{
 		return;
 	}
 
-	if (HitDetectionSettings.HitDetectionType != EDamageBehaviorHitDetectionType::ByTrace)
+	if (!DBSIsTickedHitDetectionType(HitDetectionSettings.HitDetectionType))
 	{
 		return;
 	}
 
-	for (const FDBSHitRegistratorsSource& CapsuleHitRegistratorsSource : HitRegistratorsSources)
+	// cleave cap reached and nobody can be hit again, no reason to sweep until window ends
+	if (HitPolicy.MaxTargets > 0 && NumHitTargets >= HitPolicy.MaxTargets && !CanReHitTargets())
 	{
-		const FDBSHitRegistratorsToActivateSource* HitRegistratorsToActivate = HitRegistratorsToActivateBySource.FindByPredicate(
-			[&](const FDBSHitRegistratorsToActivateSource& Source)
-			{
-				return Source.SourceName == CapsuleHitRegistratorsSource.SourceName;
-			}
-		);
+		return;
+	}
 
-		if (!HitRegistratorsToActivate)
+	bool bHasTickedSimplifiedHitRegistrator = false;
+	// resolved by MakeActive, no sources/names lookups per frame
+	for (UDBSHitRegistratorBase* CapsuleHitRegistrator : ActiveHitRegistrators)
+	{
+		// registrator could be destroyed or disabled/switched by other behavior sharing it
+		if (!IsValid(CapsuleHitRegistrator)
+			|| !CapsuleHitRegistrator->IsHitRegistrationEnabled()
+			|| !DBSIsTickedHitDetectionType(CapsuleHitRegistrator->GetHitDetectionType()))
 		{
 			continue;
 		}
 
-		for (UCapsuleHitRegistrator* CapsuleHitRegistrator : CapsuleHitRegistratorsSource.CapsuleHitRegistrators)
+		// single capsule mode, others just follow so they don't sweep stale path when LOD raised
+		if (bHasTickedSimplifiedHitRegistrator)
 		{
-			if (!IsValid(CapsuleHitRegistrator))
-			{
-				continue;
-			}
-
-			if (CapsuleHitRegistrator->GetHitDetectionType() != EDamageBehaviorHitDetectionType::ByTrace)
-			{
-				continue;
-			}
+			CapsuleHitRegistrator->DeliverAsyncSweeps();
+			CapsuleHitRegistrator->ResyncHitRegistration();
+			continue;
+		}
 
-			if (!HitRegistratorsToActivate->HitRegistratorsNames.Contains(CapsuleHitRegistrator->GetName()))
-			{
-				continue;
-			}
+		CapsuleHitRegistrator->TickHitRegistration(DeltaTime, SweepBatch);
+		bHasTickedSimplifiedHitRegistrator = DetectionLOD == EDBSDetectionLOD::Simplified;
+	}
+}
 
-			if (!CapsuleHitRegistrator->IsHitRegistrationEnabled())
-			{
-				continue;
-			}
+void UDamageBehavior::DeliverAsyncHits()
+{
+	if (!bIsActive) return;
 
-			CapsuleHitRegistrator->TickHitRegistration(DeltaTime);
+	for (UDBSHitRegistratorBase* CapsuleHitRegistrator : ActiveHitRegistrators)
+	{
+		if (IsValid(CapsuleHitRegistrator) && CapsuleHitRegistrator->IsHitRegistrationEnabled())
+		{
+			CapsuleHitRegistrator->DeliverAsyncSweeps();
 		}
 	}
 }
 
-bool UDamageBehavior::IsTickable() const
+bool UDamageBehavior::ShouldBeScheduled() const
+{
+	return bIsActive && DBSIsTickedHitDetectionType(HitDetectionSettings.HitDetectionType);
+}
+
+void UDamageBehavior::UpdateScheduling()
 {
-	return bIsActive && HitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::ByTrace;
+	UDamageBehaviorsSubsystem* DamageBehaviorsSubsystem = OwnerActor.IsValid()
+		? UDamageBehaviorsSubsystem::Get(OwnerActor->GetWorld())
+		: nullptr;
+	if (!DamageBehaviorsSubsystem) return;
+
+	if (ShouldBeScheduled())
+	{
+		DamageBehaviorsSubsystem->RegisterActiveBehavior(this);
+	}
+	else
+	{
+		DamageBehaviorsSubsystem->UnregisterActiveBehavior(this);
+	}
 }
 
 void UDamageBehavior::MakeActive_Implementation(bool bShouldActivate, const FInstancedStruct& Payload)
 {
-    bIsActive = bShouldActivate;
-	CurrentInvokePayload = Payload;
+	if (FDBSCapture::IsCapturing())
+	{
+		FDBSCapture::RecordActivation(this, bShouldActivate, Payload);
+	}
 
-	for (const FDBSHitRegistratorsSource& CapsuleHitRegistratorsSource : HitRegistratorsSources)
+	// sweeps of last active frame still in flight, delivered while behavior accepts hits
+	if (!bShouldActivate && bIsActive)
 	{
-		if (IsValid(CapsuleHitRegistratorsSource.Actor) && CapsuleHitRegistratorsSource.CapsuleHitRegistrators.Num() > 0)
+		for (UDBSHitRegistratorBase* CapsuleHitRegistrator : ActiveHitRegistrators)
 		{
-			FDBSHitRegistratorsToActivateSource* HitRegistratorsToActivate = HitRegistratorsToActivateBySource.FindByPredicate([=](const FDBSHitRegistratorsToActivateSource& Source) {
-				return Source.SourceName == CapsuleHitRegistratorsSource.SourceName;
-			});
-			if (!HitRegistratorsToActivate) continue;
-			
-			for (UCapsuleHitRegistrator* CapsuleHitRegistrator : CapsuleHitRegistratorsSource.CapsuleHitRegistrators)
+			if (IsValid(CapsuleHitRegistrator) && CapsuleHitRegistrator->IsHitRegistrationEnabled())
 			{
-				if (HitRegistratorsToActivate->HitRegistratorsNames.Contains(CapsuleHitRegistrator->GetName()))
-				{
-					CapsuleHitRegistrator->SetIsHitRegistrationEnabled(bShouldActivate, HitDetectionSettings);
-				}
-			}	
+				CapsuleHitRegistrator->FlushAsyncSweeps();
+			}
 		}
-		else
+	}
+
+    bIsActive = bShouldActivate;
+	CurrentInvokePayload = Payload;
+
+	ResolveActiveHitRegistrators();
+	for (UDBSHitRegistratorBase* CapsuleHitRegistrator : ActiveHitRegistrators)
+	{
+		CapsuleHitRegistrator->SetIsHitRegistrationEnabled(bShouldActivate, HitDetectionSettings);
+		if (bShouldActivate)
 		{
-			// TODO: validation failed message
+			CapsuleHitRegistrator->SetLagCompensationDelay(LagCompensationDelay);
 		}
 	}
 
+	UpdateScheduling();
+
     if (!bShouldActivate)
     {
         ClearHittedActors();
+        LagCompensationDelay = 0.0f;
+        ActiveHitRegistrators.Reset();
     }
 }
 
+void UDamageBehavior::ResolveActiveHitRegistrators()
+{
+	ActiveHitRegistrators.Reset();
+	for (const FDBSHitRegistratorsSource& CapsuleHitRegistratorsSource : HitRegistratorsSources)
+	{
+		if (!IsValid(CapsuleHitRegistratorsSource.Actor) || CapsuleHitRegistratorsSource.CapsuleHitRegistrators.IsEmpty())
+		{
+			// TODO: validation failed message
+			continue;
+		}
+
+		const FDBSHitRegistratorsToActivateSource* HitRegistratorsToActivate = HitRegistratorsToActivateBySource.FindByPredicate(
+			[&](const FDBSHitRegistratorsToActivateSource& Source)
+			{
+				return Source.SourceName == CapsuleHitRegistratorsSource.SourceName;
+			}
+		);
+		if (!HitRegistratorsToActivate) continue;
+
+		for (UDBSHitRegistratorBase* CapsuleHitRegistrator : CapsuleHitRegistratorsSource.CapsuleHitRegistrators)
+		{
+			if (!IsValid(CapsuleHitRegistrator)) continue;
+
+			// compare with FName directly, GetName() allocates string
+			const FName HitRegistratorName = CapsuleHitRegistrator->GetFName();
+			if (HitRegistratorsToActivate->HitRegistratorsNames.ContainsByPredicate(
+				[HitRegistratorName](const FString& Name) { return HitRegistratorName == *Name; }))
+			{
+				ActiveHitRegistrators.AddUnique(CapsuleHitRegistrator);
+			}
+		}
+	}
+}
+
+void UDamageBehavior::SetLagCompensationTimestamp(double Timestamp)
+{
+	const UWorld* World = OwnerActor.IsValid() ? OwnerActor->GetWorld() : nullptr;
+	if (!World) return;
+
+	const float MaxRewindTime = GetDefault<UDamageBehaviorsSystemSettings>()->LagCompensationMaxRewindTime;
+	LagCompensationDelay = static_cast<float>(FMath::Clamp(World->GetTimeSeconds() - Timestamp, 0.0, static_cast<double>(MaxRewindTime)));
+	if (!bIsActive) return;
+
+	for (UDBSHitRegistratorBase* CapsuleHitRegistrator : ActiveHitRegistrators)
+	{
+		if (IsValid(CapsuleHitRegistrator) && CapsuleHitRegistrator->IsHitRegistrationEnabled())
+		{
+			CapsuleHitRegistrator->SetLagCompensationDelay(LagCompensationDelay);
+		}
+	}
+}
+
 bool UDamageBehavior::CanBeAddedToHittedActors_Implementation(
 	const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
-	UCapsuleHitRegistrator* CapsuleHitRegistrator)
+	UDBSHitRegistratorBase* CapsuleHitRegistrator)
 {
 	return HitRegistratorHitResult.HitActor.IsValid();
 }
 
 bool UDamageBehavior::ProcessHit_Implementation(
 	const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
-	UCapsuleHitRegistrator* CapsuleHitRegistrator,
+	UDBSHitRegistratorBase* CapsuleHitRegistrator,
 	FInstancedStruct& Payload_Out)
 {
 	
@@ -371,25 +488,28 @@ bool UDamageBehavior::ProcessHit_Implementation(
 
 void UDamageBehavior::AddHittedActor_Implementation(AActor* Actor_In, bool bCanBeAttached, bool bAddAttachedActorsToActorAlso = true)
 {
-	if (HitDetectionSettings.HitDetectionType == EDamageBehaviorHitDetectionType::ByEntering) return;
-
-    this->HitActors.Add(Actor_In);
+	const double HitTime = GetHitPolicyTime();
+    this->HitActors.Add(Actor_In, HitTime, HitSerial);
 
 	if (bAddAttachedActorsToActorAlso)
 	{
-		// add all attached actors also
-		TArray<AActor*> AttachedActorsToActor;
-		Actor_In->GetAttachedActors(AttachedActorsToActor);
-		for (AActor* AttachedActor : AttachedActorsToActor)
+		// add all attached actors also, without gathering them into temporary array
+		Actor_In->ForEachAttachedActors([this, HitTime](AActor* AttachedActor)
 		{
-			this->HitActors.Add(AttachedActor);
-		}	
+			this->HitActors.Add(AttachedActor, HitTime, HitSerial);
+			return true;
+		});
 	}
+
+	// entering types hit again on every enter(see CheckHitPolicy), same as overlap events, nothing to attach
+	if (DBSIsEnteringHitDetectionType(HitDetectionSettings.HitDetectionType)) return;
 	
-    if (bCanBeAttached && this->bAttachEnemiesToCapsuleWhileActive)
+    // re-hits(see HitPolicy) don't attach again
+    if (bCanBeAttached && this->bAttachEnemiesToCapsuleWhileActive && !this->AttachedActors.Contains(Actor_In))
     {
         Actor_In->AttachToActor(OwnerActor.Get(), FAttachmentTransformRules(EAttachmentRule::KeepWorld, EAttachmentRule::KeepWorld, EAttachmentRule::KeepWorld, true), NAME_None);
         this->AttachedActors.Add(Actor_In);
+        NotifyAttachmentsChanged();
     }
 }
 
@@ -400,10 +520,78 @@ void UDamageBehavior::ClearHittedActors_Implementation()
     	if (!HitActor.IsValid()) continue;
         HitActor->K2_DetachFromActor(EDetachmentRule::KeepWorld, EDetachmentRule::KeepWorld, EDetachmentRule::KeepWorld);
     }
-    this->HitActors.Empty();
-    this->AttachedActors.Empty();
+    if (this->AttachedActors.Num() > 0)
+    {
+        NotifyAttachmentsChanged();
+    }
+    // keep capacity for next hit window
+    this->HitActors.Reset();
+    this->AttachedActors.Reset();
+    NumHitTargets = 0;
+}
+
+void UDamageBehavior::NotifyAttachmentsChanged()
+{
+	for (UDBSHitRegistratorBase* CapsuleHitRegistrator : ActiveHitRegistrators)
+	{
+		if (IsValid(CapsuleHitRegistrator))
+		{
+			CapsuleHitRegistrator->NotifyAttachmentsChanged();
+		}
+	}
+}
+
+EDBSHitPolicyResult UDamageBehavior::CheckHitPolicy(const AActor* HitActor, double Time) const
+{
+	const bool bIsTargetsCapReached = HitPolicy.MaxTargets > 0 && NumHitTargets >= HitPolicy.MaxTargets;
+	// window is over, no lookup required
+	if (bIsTargetsCapReached && !CanReHitTargets()) return EDBSHitPolicyResult::RejectedMaxTargets;
+
+	const FDBSHitActorsSet::FEntry* Entry = HitActors.Find(HitActor);
+	if (!Entry)
+	{
+		return bIsTargetsCapReached ? EDBSHitPolicyResult::RejectedMaxTargets : EDBSHitPolicyResult::Accepted;
+	}
+
+	if (HitPolicy.MaxHitsPerTarget > 0 && Entry->Hits >= HitPolicy.MaxHitsPerTarget)
+	{
+		return EDBSHitPolicyResult::RejectedMaxHitsPerTarget;
+	}
+	if (HitPolicy.ReHitInterval > 0.0f)
+	{
+		return Time - Entry->LastHitTime < HitPolicy.ReHitInterval
+			? EDBSHitPolicyResult::RejectedReHitInterval
+			: EDBSHitPolicyResult::Accepted;
+	}
+	return DBSIsEnteringHitDetectionType(HitDetectionSettings.HitDetectionType)
+		? EDBSHitPolicyResult::Accepted
+		: EDBSHitPolicyResult::RejectedAlreadyHit;
 }
 
+bool UDamageBehavior::CanReHitTargets() const
+{
+	return (HitPolicy.ReHitInterval > 0.0f || DBSIsEnteringHitDetectionType(HitDetectionSettings.HitDetectionType))
+		&& HitPolicy.MaxHitsPerTarget != 1;
+}
+
+double UDamageBehavior::GetHitPolicyTime() const
+{
+	const UWorld* World = OwnerActor.IsValid() ? OwnerActor->GetWorld() : nullptr;
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+void UDamageBehavior::AddAcceptedHitForTests(AActor* HitActor)
+{
+	HitSerial++;
+	if (!HitActors.Contains(HitActor))
+	{
+		NumHitTargets++;
+	}
+	AddHittedActor(HitActor, false, true);
+}
+#endif
+
 AActor* UDamageBehavior::GetRootAttachedActor(AActor* Actor_In) const
 {
 	AActor* Current = Actor_In;
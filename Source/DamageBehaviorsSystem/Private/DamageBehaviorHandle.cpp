@@ -0,0 +1,46 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DamageBehaviorHandle.h"
+
+#include "DamageBehavior.h"
+#include "DamageBehaviorsComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DamageBehaviorHandle)
+
+bool FDamageBehaviorHandle::IsValid() const
+{
+	if (!bIsResolved) return false;
+
+	const UDamageBehaviorsComponent* Owner = OwnerComponent.Get();
+	if (!Owner || Owner->GetDamageBehaviorHandlesSerial() != OwnerHandlesSerial) return false;
+
+	for (const FResolvedSource& ResolvedSource : ResolvedSources)
+	{
+		if (Owner->GetDamageBehaviorsSourceComponent(ResolvedSource.SourceIndex) != ResolvedSource.DamageBehaviorsComponent.Get()) return false;
+	}
+
+	for (const FResolvedDamageBehavior& ResolvedDamageBehavior : ResolvedDamageBehaviors)
+	{
+		const UDamageBehaviorsComponent* DamageBehaviorsComponent = ResolvedDamageBehavior.DamageBehaviorsComponent.Get();
+		if (!DamageBehaviorsComponent || DamageBehaviorsComponent->GetDamageBehaviorHandlesSerial() != ResolvedDamageBehavior.HandlesSerial) return false;
+		if (!ResolvedDamageBehavior.DamageBehavior.IsValid()) return false;
+	}
+	return true;
+}
+
+void FDamageBehaviorHandle::Reset()
+{
+	*this = FDamageBehaviorHandle();
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+TArray<UDamageBehavior*> FDamageBehaviorHandle::GetResolvedDamageBehaviorsForTests() const
+{
+	TArray<UDamageBehavior*> Result;
+	for (const FResolvedDamageBehavior& ResolvedDamageBehavior : ResolvedDamageBehaviors)
+	{
+		Result.Add(ResolvedDamageBehavior.DamageBehavior.Get());
+	}
+	return Result;
+}
+#endif
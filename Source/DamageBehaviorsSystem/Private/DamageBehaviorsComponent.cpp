@@ -3,14 +3,18 @@
 
 #include "DamageBehaviorsComponent.h"
 
-#include "CapsuleHitRegistrator.h"
+#include "DBSHitRegistratorBase.h"
 #include "DamageBehaviorsSource.h"
+#include "DamageBehaviorsSubsystem.h"
 #include "DamageBehaviorsSystemSettings.h"
+#include "DamageBehaviorsSystemStats.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(DamageBehaviorsComponent)
 
 DEFINE_LOG_CATEGORY(LogDamageBehaviorsSystem);
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DamageBehavior handles resolved"), STAT_DBS_DamageBehaviorHandlesResolved, STATGROUP_DamageBehaviorsSystem);
+
 
 void UDamageBehaviorsComponent::BeginPlay()
 {
@@ -19,6 +23,7 @@ void UDamageBehaviorsComponent::BeginPlay()
     OwnerActor = GetOwningActor();
 
 	PrepareDamageBehaviorsSources();
+	RebuildDamageBehaviorsLookup();
 	
 	// Now activate the ones that need to start active
 	for (UDamageBehavior* DamageBehavior : DamageBehaviorsList)
@@ -33,13 +38,31 @@ void UDamageBehaviorsComponent::BeginPlay()
 		
 		// if (DamageBehavior->bAutoHandleDamage)
 		// {
-			DamageBehavior->OnHitRegistered.AddUniqueDynamic(this, &ThisClass::DefaultOnHitAnything);
+			// native direct call instead of dynamic delegate binding
+			DamageBehavior->SetDamageBehaviorHitSink(this);
 		// }
 		if (DamageBehavior->bInvokeDamageBehaviorOnStart)
 		{
-			InvokeDamageBehavior(DamageBehavior->Name, true, {}, {});
+			InvokeDamageBehaviorByName(FName(*DamageBehavior->Name), true, {}, {});
+		}
+	}
+}
+
+void UDamageBehaviorsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	InvalidateDamageBehaviorHandles();
+
+	// stop ticking behaviors that were active when owner gone
+	if (UDamageBehaviorsSubsystem* DamageBehaviorsSubsystem = UDamageBehaviorsSubsystem::Get(GetWorld()))
+	{
+		for (UDamageBehavior* DamageBehavior : DamageBehaviorsList)
+		{
+			if (!DamageBehavior) continue;
+			DamageBehaviorsSubsystem->UnregisterActiveBehavior(DamageBehavior);
 		}
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 AActor* UDamageBehaviorsComponent::GetOwningActor_Implementation() const
@@ -60,29 +83,55 @@ void UDamageBehaviorsComponent::InvokeDamageBehavior(
 		return;
 	}
 
-	TArray<FString> ResultDamageBehaviorsSourcesToUse = DamageBehaviorsSourcesToUse;
-	if (DamageBehaviorsSourcesToUse.Num() == 0)
+	// FNAME_Find - unknown strings not added to names table, they can't match anything anyway
+	const FName DamageBehaviorFName(*DamageBehaviorName, FNAME_Find);
+	if (DamageBehaviorFName.IsNone())
 	{
-		ResultDamageBehaviorsSourcesToUse = {
-			DEFAULT_DAMAGE_BEHAVIOR_SOURCE,
-		};
+		UE_LOG(LogDamageBehaviorsSystem, Verbose, TEXT("UDamageBehaviorsComponent::InvokeDamageBehavior() DamageBehavior \"%s\" not found"), *DamageBehaviorName);
+		return;
+	}
+
+	TArray<FName> DamageBehaviorsSourcesNames;
+	DamageBehaviorsSourcesNames.Reserve(DamageBehaviorsSourcesToUse.Num());
+	for (const FString& DamageBehaviorsSourceToUse : DamageBehaviorsSourcesToUse)
+	{
+		DamageBehaviorsSourcesNames.Add(FName(*DamageBehaviorsSourceToUse, FNAME_Find));
+	}
+
+	InvokeDamageBehaviorByName(DamageBehaviorFName, bShouldActivate, DamageBehaviorsSourcesNames, Payload);
+}
+
+void UDamageBehaviorsComponent::InvokeDamageBehaviorByName(
+	const FName DamageBehaviorName,
+	const bool bShouldActivate,
+	const TArray<FName>& DamageBehaviorsSourcesToUse,
+	const FInstancedStruct& Payload
+)
+{
+	if (DamageBehaviorName.IsNone())
+	{
+		UE_LOG(LogDamageBehaviorsSystem, Warning, TEXT("UDamageBehaviorsComponent::InvokeDamageBehaviorByName() called with empty DamageBehaviorName"));
+		return;
 	}
-	
-	auto CVarDBSHitBoxes = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
-    bool bIsDebugEnabled = CVarDBSHitBoxes ? CVarDBSHitBoxes->GetBool() : false;
 
-	const FString LocalDamageBehaviorName = DamageBehaviorName; // Create a local copy to ensure string stability
+	static IConsoleVariable* CVarDBSHitBoxes = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
+	const bool bIsDebugEnabled = CVarDBSHitBoxes ? CVarDBSHitBoxes->GetBool() : false;
 
-	for (const FString& BehaviorsSourcesToUse : ResultDamageBehaviorsSourcesToUse)
+	static const TArray<FName> DefaultDamageBehaviorsSourcesToUse = { DEFAULT_DAMAGE_BEHAVIOR_SOURCE_NAME };
+	const TArray<FName>& ResultDamageBehaviorsSourcesToUse = DamageBehaviorsSourcesToUse.Num() > 0
+		? DamageBehaviorsSourcesToUse
+		: DefaultDamageBehaviorsSourcesToUse;
+
+	for (const FName BehaviorsSourceToUse : ResultDamageBehaviorsSourcesToUse)
 	{
-		if (BehaviorsSourcesToUse == DEFAULT_DAMAGE_BEHAVIOR_SOURCE)
+		if (BehaviorsSourceToUse == DEFAULT_DAMAGE_BEHAVIOR_SOURCE_NAME)
 		{
-			UDamageBehavior* DamageBehavior = GetDamageBehavior(LocalDamageBehaviorName);
+			UDamageBehavior* DamageBehavior = GetDamageBehaviorByName(DamageBehaviorName);
 			if (!DamageBehavior)
 			{
 				if (bIsDebugEnabled)
 				{
-					UE_LOG(LogDamageBehaviorsSystem, Warning, TEXT("UDamageBehaviorsComponent::InvokeDamageBehavior() DamageBehavior \"%s\" not found on character looking for weapon"), *LocalDamageBehaviorName);
+					UE_LOG(LogDamageBehaviorsSystem, Warning, TEXT("UDamageBehaviorsComponent::InvokeDamageBehavior() DamageBehavior \"%s\" not found on character looking for weapon"), *DamageBehaviorName.ToString());
 				}
 			}
 			else
@@ -92,20 +141,18 @@ void UDamageBehaviorsComponent::InvokeDamageBehavior(
 		}
 		else
 		{
-			FDamageBehaviorsSource* DamageBehaviorsSource = DamageBehaviorsSources.FindByKey(BehaviorsSourcesToUse);
-			UDamageBehaviorsComponent* DBSSourceDBComponent = DamageBehaviorsSource->GetDamageBehaviorsComponent();
-			if (!DamageBehaviorsSource || !DBSSourceDBComponent)
-			{
-				continue;
-			}
-			if (DBSSourceDBComponent != this)  // Prevent recursion to self
+			const int32* DamageBehaviorsSourceIndex = DamageBehaviorsSourcesIndices.Find(BehaviorsSourceToUse);
+			if (!DamageBehaviorsSourceIndex) continue;
+
+			UDamageBehaviorsComponent* DBSSourceDBComponent = DamageBehaviorsSources[*DamageBehaviorsSourceIndex].GetDamageBehaviorsComponent();
+			if (DBSSourceDBComponent && DBSSourceDBComponent != this)  // Prevent recursion to self
 			{
 				// When forwarding to another component, we only want to try the default source there
 				// to prevent potential cycles between components
-				DBSSourceDBComponent->InvokeDamageBehavior(
-					LocalDamageBehaviorName,
+				DBSSourceDBComponent->InvokeDamageBehaviorByName(
+					DamageBehaviorName,
 					bShouldActivate,
-					{ DEFAULT_DAMAGE_BEHAVIOR_SOURCE },
+					DefaultDamageBehaviorsSourcesToUse,
 					Payload);
 			}
 		}
@@ -114,16 +161,143 @@ void UDamageBehaviorsComponent::InvokeDamageBehavior(
 
 UDamageBehavior* UDamageBehaviorsComponent::GetDamageBehavior(const FString Name) const
 {
-	TObjectPtr<UDamageBehavior> const* DamageBehaviorSearch = DamageBehaviorsList.FindByPredicate(
-		[&](const UDamageBehavior* Behavior)
+	if (!bIsDamageBehaviorsLookupBuilt)
+	{
+		// not begun play yet e.g. editor preview actors
+		TObjectPtr<UDamageBehavior> const* DamageBehaviorSearch = DamageBehaviorsList.FindByPredicate(
+			[&](const UDamageBehavior* Behavior)
+			{
+				if (!Behavior)
+				{
+					return false;
+				}
+				return Behavior->Name == Name;
+			});
+		return DamageBehaviorSearch ? *DamageBehaviorSearch : nullptr;
+	}
+
+	const FName NameToFind(*Name, FNAME_Find);
+	return NameToFind.IsNone() ? nullptr : GetDamageBehaviorByName(NameToFind);
+}
+
+UDamageBehavior* UDamageBehaviorsComponent::GetDamageBehaviorByName(const FName Name) const
+{
+	if (!bIsDamageBehaviorsLookupBuilt)
+	{
+		return GetDamageBehavior(Name.ToString());
+	}
+
+	const TObjectPtr<UDamageBehavior>* DamageBehaviorSearch = DamageBehaviorsByName.Find(Name);
+	return DamageBehaviorSearch ? DamageBehaviorSearch->Get() : nullptr;
+}
+
+void UDamageBehaviorsComponent::RebuildDamageBehaviorsLookup()
+{
+	DamageBehaviorsByName.Reset();
+	for (UDamageBehavior* DamageBehavior : DamageBehaviorsList)
+	{
+		if (!DamageBehavior || DamageBehavior->Name.IsEmpty()) continue;
+
+		const FName DamageBehaviorName(*DamageBehavior->Name);
+		if (!DamageBehaviorsByName.Contains(DamageBehaviorName))
 		{
-			if (!Behavior)
+			DamageBehaviorsByName.Add(DamageBehaviorName, DamageBehavior);
+		}
+	}
+	bIsDamageBehaviorsLookupBuilt = true;
+	InvalidateDamageBehaviorHandles();
+}
+
+FDamageBehaviorHandle UDamageBehaviorsComponent::MakeDamageBehaviorHandle(
+	const FName DamageBehaviorName,
+	const TArray<FName>& DamageBehaviorsSourcesToUse
+)
+{
+	FDamageBehaviorHandle Handle;
+	Handle.DamageBehaviorName = DamageBehaviorName;
+	Handle.DamageBehaviorsSourcesNames = DamageBehaviorsSourcesToUse;
+	ResolveDamageBehaviorHandle(Handle);
+	return Handle;
+}
+
+void UDamageBehaviorsComponent::InvokeDamageBehaviorByHandle(
+	FDamageBehaviorHandle& Handle,
+	const bool bShouldActivate,
+	const FInstancedStruct& Payload
+)
+{
+	// handle made by other component resolved again for this one
+	if (Handle.OwnerComponent.Get() != this || !Handle.IsValid())
+	{
+		if (Handle.DamageBehaviorName.IsNone())
+		{
+			UE_LOG(LogDamageBehaviorsSystem, Warning, TEXT("UDamageBehaviorsComponent::InvokeDamageBehaviorByHandle() called with empty handle"));
+			return;
+		}
+		ResolveDamageBehaviorHandle(Handle);
+	}
+
+	for (const FDamageBehaviorHandle::FResolvedDamageBehavior& ResolvedDamageBehavior : Handle.ResolvedDamageBehaviors)
+	{
+		if (UDamageBehavior* DamageBehavior = ResolvedDamageBehavior.DamageBehavior.Get())
+		{
+			DamageBehavior->MakeActive(bShouldActivate, Payload);
+		}
+	}
+}
+
+void UDamageBehaviorsComponent::ResolveDamageBehaviorHandle(FDamageBehaviorHandle& Handle)
+{
+	INC_DWORD_STAT(STAT_DBS_DamageBehaviorHandlesResolved);
+
+	Handle.OwnerComponent = this;
+	Handle.OwnerHandlesSerial = DamageBehaviorHandlesSerial;
+	Handle.ResolvedDamageBehaviors.Reset();
+	Handle.ResolvedSources.Reset();
+	Handle.bIsResolved = true;
+
+	static IConsoleVariable* CVarDBSHitBoxes = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.HitBoxes"));
+	const bool bIsDebugEnabled = CVarDBSHitBoxes ? CVarDBSHitBoxes->GetBool() : false;
+
+	// same resolution as InvokeDamageBehaviorByName
+	auto AddResolvedDamageBehavior = [&Handle](UDamageBehaviorsComponent* DamageBehaviorsComponent)
+	{
+		UDamageBehavior* DamageBehavior = DamageBehaviorsComponent->GetDamageBehaviorByName(Handle.DamageBehaviorName);
+		if (!DamageBehavior) return false;
+
+		Handle.ResolvedDamageBehaviors.Add({ DamageBehavior, DamageBehaviorsComponent, DamageBehaviorsComponent->GetDamageBehaviorHandlesSerial() });
+		return true;
+	};
+
+	if (Handle.DamageBehaviorsSourcesNames.IsEmpty())
+	{
+		Handle.DamageBehaviorsSourcesNames.Add(DEFAULT_DAMAGE_BEHAVIOR_SOURCE_NAME);
+	}
+
+	for (const FName BehaviorsSourceToUse : Handle.DamageBehaviorsSourcesNames)
+	{
+		if (BehaviorsSourceToUse == DEFAULT_DAMAGE_BEHAVIOR_SOURCE_NAME)
+		{
+			if (!AddResolvedDamageBehavior(this) && bIsDebugEnabled)
 			{
-				return false;
+				UE_LOG(LogDamageBehaviorsSystem, Warning, TEXT("UDamageBehaviorsComponent::ResolveDamageBehaviorHandle() DamageBehavior \"%s\" not found on character looking for weapon"), *Handle.DamageBehaviorName.ToString());
 			}
-			return Behavior->Name == Name;
-		});
-	return DamageBehaviorSearch ? *DamageBehaviorSearch : nullptr;
+		}
+		else
+		{
+			const int32* DamageBehaviorsSourceIndex = DamageBehaviorsSourcesIndices.Find(BehaviorsSourceToUse);
+			if (!DamageBehaviorsSourceIndex) continue;
+
+			UDamageBehaviorsComponent* DBSSourceDBComponent = DamageBehaviorsSources[*DamageBehaviorsSourceIndex].GetDamageBehaviorsComponent();
+			// kept even without component, handle becomes stale once source actor appears or changes
+			Handle.ResolvedSources.Add({ *DamageBehaviorsSourceIndex, DBSSourceDBComponent });
+			if (DBSSourceDBComponent && DBSSourceDBComponent != this)  // Prevent recursion to self
+			{
+				// forwarded components resolve only their default source same as InvokeDamageBehaviorByName
+				AddResolvedDamageBehavior(DBSSourceDBComponent);
+			}
+		}
+	}
 }
 
 const TArray<FDBSHitRegistratorsSource> UDamageBehaviorsComponent::GetHitRegistratorsSources(
@@ -195,19 +369,54 @@ void UDamageBehaviorsComponent::PrepareDamageBehaviorsSources()
 	{
 		DamageBehaviorsSources.Add(FDamageBehaviorsSource(DamageBehaviorsSourceEvaluator->SourceName, OwnerActor, DamageBehaviorsSourceEvaluator));
 	}
+
+	DamageBehaviorsSourcesIndices.Reset();
+	for (int32 i = 0; i < DamageBehaviorsSources.Num(); i++)
+	{
+		const FString& SourceName = DamageBehaviorsSources[i].SourceName;
+		if (SourceName.IsEmpty()) continue;
+		// first one wins same as FindByKey
+		const FName SourceFName(*SourceName);
+		if (!DamageBehaviorsSourcesIndices.Contains(SourceFName))
+		{
+			DamageBehaviorsSourcesIndices.Add(SourceFName, i);
+		}
+	}
+	// source indices of resolved handles may point to other sources now
+	InvalidateDamageBehaviorHandles();
 }
 
-TMap<FString, UCapsuleHitRegistrator*> UDamageBehaviorsComponent::FindCapsuleHitRegistrators(AActor* Actor) const
+#if WITH_DEV_AUTOMATION_TESTS
+void UDamageBehaviorsComponent::SetDamageBehaviorsSourceForTests(const FString& SourceName, AActor* SourceActor)
 {
-	TMap<FString, UCapsuleHitRegistrator*> Result;
+	const FName SourceFName(*SourceName);
+	if (const int32* DamageBehaviorsSourceIndex = DamageBehaviorsSourcesIndices.Find(SourceFName))
+	{
+		DamageBehaviorsSources[*DamageBehaviorsSourceIndex] = FDamageBehaviorsSource(SourceName, SourceActor, nullptr);
+		return;
+	}
+	DamageBehaviorsSourcesIndices.Add(SourceFName, DamageBehaviorsSources.Add(FDamageBehaviorsSource(SourceName, SourceActor, nullptr)));
+	InvalidateDamageBehaviorHandles();
+}
+#endif
+
+UDamageBehaviorsComponent* UDamageBehaviorsComponent::GetDamageBehaviorsSourceComponent(int32 SourceIndex) const
+{
+	return DamageBehaviorsSources.IsValidIndex(SourceIndex) ? DamageBehaviorsSources[SourceIndex].GetDamageBehaviorsComponent() : nullptr;
+}
+
+TMap<FName, UDBSHitRegistratorBase*> UDamageBehaviorsComponent::FindCapsuleHitRegistrators(AActor* Actor) const
+{
+	TMap<FName, UDBSHitRegistratorBase*> Result;
 
 	TArray<UActorComponent*> CapsuleHitRegistratorsActorComponents;
-	Actor->GetComponents(UCapsuleHitRegistrator::StaticClass(), CapsuleHitRegistratorsActorComponents, true);
+	Actor->GetComponents(UDBSHitRegistratorBase::StaticClass(), CapsuleHitRegistratorsActorComponents, true);
 
 	for (UActorComponent* ActorComponent : CapsuleHitRegistratorsActorComponents)
 	{
-		UCapsuleHitRegistrator* CapsuleHitRegistrator = StaticCast<UCapsuleHitRegistrator*>(ActorComponent);
-		Result.Add(CapsuleHitRegistrator->GetName(), CapsuleHitRegistrator);
+		UDBSHitRegistratorBase* CapsuleHitRegistrator = StaticCast<UDBSHitRegistratorBase*>(ActorComponent);
+		// GetFName - no string allocation per component
+		Result.Add(CapsuleHitRegistrator->GetFName(), CapsuleHitRegistrator);
 	}
 
 	return Result;
@@ -230,10 +439,19 @@ void UDamageBehaviorsComponent::SyncAllBehaviorSources()
 	}
 }
 
+void UDamageBehaviorsComponent::HandleDamageBehaviorHit(
+	const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
+	const UDamageBehavior* DamageBehavior,
+	const UDBSHitRegistratorBase* CapsuleHitRegistrator,
+	const FInstancedStruct& Payload)
+{
+	DefaultOnHitAnything(HitRegistratorHitResult, DamageBehavior, CapsuleHitRegistrator, Payload);
+}
+
 void UDamageBehaviorsComponent::DefaultOnHitAnything(
 	const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
 	const class UDamageBehavior* DamageBehavior,
-	const UCapsuleHitRegistrator* CapsuleHitRegistrator,
+	const UDBSHitRegistratorBase* CapsuleHitRegistrator,
 	const FInstancedStruct& Payload)
 {
 	if (OnHitAnything.IsBound())
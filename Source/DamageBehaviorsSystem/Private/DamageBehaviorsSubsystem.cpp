@@ -0,0 +1,425 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DamageBehaviorsSubsystem.h"
+
+#include "DBSHitRegistratorBase.h"
+#include "DamageBehavior.h"
+#include "DamageBehaviorsSystemSettings.h"
+#include "DamageBehaviorsSystemStats.h"
+#include "AIController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DamageBehaviorsSubsystem)
+
+DEFINE_STAT(STAT_DBS_ActiveBehaviors);
+DECLARE_CYCLE_STAT(TEXT("Tick active DamageBehaviors"), STAT_DBS_TickActiveBehaviors, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Execute parallel sweeps"), STAT_DBS_ExecuteParallelSweeps, STATGROUP_DamageBehaviorsSystem);
+DECLARE_CYCLE_STAT(TEXT("Commit parallel sweeps"), STAT_DBS_CommitParallelSweeps, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Parallel sweeps"), STAT_DBS_ParallelSweeps, STATGROUP_DamageBehaviorsSystem);
+// sum of all sweeps durations(as if they were executed serially) minus wall-clock time of ParallelFor
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Parallel sweeps saved (ms)"), STAT_DBS_ParallelSweepsSavedMs, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("WhileStandingInside timers"), STAT_DBS_StandingInsideTimers, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("WhileStandingInside re-hits"), STAT_DBS_StandingInsideHits, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detection LOD Full"), STAT_DBS_DetectionLODFull, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detection LOD Reduced"), STAT_DBS_DetectionLODReduced, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detection LOD Simplified"), STAT_DBS_DetectionLODSimplified, STATGROUP_DamageBehaviorsSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detection LOD skipped ticks"), STAT_DBS_DetectionLODSkippedTicks, STATGROUP_DamageBehaviorsSystem);
+
+void FDBSActiveBehaviorsTickFunction::ExecuteTick(
+	float DeltaTime,
+	ELevelTick TickType,
+	ENamedThreads::Type CurrentThread,
+	const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->TickActiveBehaviors(DeltaTime);
+	}
+}
+
+FString FDBSActiveBehaviorsTickFunction::DiagnosticMessage()
+{
+	return TEXT("FDBSActiveBehaviorsTickFunction");
+}
+
+FName FDBSActiveBehaviorsTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("DamageBehaviorsSubsystem"));
+}
+
+UDamageBehaviorsSubsystem* UDamageBehaviorsSubsystem::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<UDamageBehaviorsSubsystem>() : nullptr;
+}
+
+bool UDamageBehaviorsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// editor preview worlds never invoke DamageBehaviors, see UANS_InvokeDamageBehavior
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDamageBehaviorsSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const UDamageBehaviorsSystemSettings* DamageBehaviorsSystemSettings = GetDefault<UDamageBehaviorsSystemSettings>();
+
+	ActiveBehaviorsTickFunction.Target = this;
+	ActiveBehaviorsTickFunction.bCanEverTick = true;
+	ActiveBehaviorsTickFunction.bStartWithTickEnabled = false;
+	ActiveBehaviorsTickFunction.bTickEvenWhenPaused = false;
+	ActiveBehaviorsTickFunction.TickGroup = DamageBehaviorsSystemSettings->ActiveBehaviorsTickGroup;
+	ActiveBehaviorsTickFunction.EndTickGroup = DamageBehaviorsSystemSettings->ActiveBehaviorsTickGroup;
+	ActiveBehaviorsTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+
+	DetectionLODReducedDistanceSquared = FMath::Square(DamageBehaviorsSystemSettings->DetectionLODReducedDistance);
+	DetectionLODSimplifiedDistanceSquared = FMath::Square(DamageBehaviorsSystemSettings->DetectionLODSimplifiedDistance);
+	DetectionLODReducedInterval = FMath::Max(1, DamageBehaviorsSystemSettings->DetectionLODReducedInterval);
+	DetectionLODSimplifiedInterval = FMath::Max(1, DamageBehaviorsSystemSettings->DetectionLODSimplifiedInterval);
+
+	UpdateTickFunctionEnabled();
+}
+
+void UDamageBehaviorsSubsystem::Deinitialize()
+{
+	for (const FDBSActiveBehavior& ActiveBehavior : ActiveBehaviors)
+	{
+		if (UDamageBehavior* DamageBehavior = ActiveBehavior.DamageBehavior.Get())
+		{
+			DamageBehavior->ActiveBehaviorIndex = INDEX_NONE;
+		}
+	}
+	ActiveBehaviors.Empty();
+	PrerequisiteMeshesRefCount.Empty();
+
+	if (ActiveBehaviorsTickFunction.IsTickFunctionRegistered())
+	{
+		ActiveBehaviorsTickFunction.UnRegisterTickFunction();
+	}
+	ActiveBehaviorsTickFunction.Target = nullptr;
+
+	SET_DWORD_STAT(STAT_DBS_ActiveBehaviors, 0);
+
+	Super::Deinitialize();
+}
+
+void UDamageBehaviorsSubsystem::RegisterActiveBehavior(UDamageBehavior* DamageBehavior)
+{
+	if (!IsValid(DamageBehavior) || DamageBehavior->ActiveBehaviorIndex != INDEX_NONE) return;
+
+	FDBSActiveBehavior& ActiveBehavior = ActiveBehaviors.AddDefaulted_GetRef();
+	ActiveBehavior.DamageBehavior = DamageBehavior;
+	ActiveBehavior.DetectionLODPhase = NextDetectionLODPhase++;
+	DamageBehavior->ActiveBehaviorIndex = ActiveBehaviors.Num() - 1;
+
+	// wait for animation of every skeletal mesh driven hit registrators attached to, resolved by MakeActive
+	for (UDBSHitRegistratorBase* CapsuleHitRegistrator : DamageBehavior->ActiveHitRegistrators)
+	{
+		if (!IsValid(CapsuleHitRegistrator)) continue;
+
+		USceneComponent* Parent = CapsuleHitRegistrator->GetAttachParent();
+		while (Parent && !Parent->IsA<USkeletalMeshComponent>())
+		{
+			Parent = Parent->GetAttachParent();
+		}
+
+		USkeletalMeshComponent* MeshComponent = Cast<USkeletalMeshComponent>(Parent);
+		if (MeshComponent && !ActiveBehavior.PrerequisiteMeshes.Contains(MeshComponent))
+		{
+			ActiveBehavior.PrerequisiteMeshes.Add(MeshComponent);
+			AddMeshPrerequisite(MeshComponent);
+		}
+	}
+
+	UpdateTickFunctionEnabled();
+}
+
+void UDamageBehaviorsSubsystem::UnregisterActiveBehavior(UDamageBehavior* DamageBehavior)
+{
+	if (!DamageBehavior) return;
+
+	const int32 Index = DamageBehavior->ActiveBehaviorIndex;
+	if (!ActiveBehaviors.IsValidIndex(Index) || ActiveBehaviors[Index].DamageBehavior.Get() != DamageBehavior) return;
+
+	for (const TWeakObjectPtr<USkeletalMeshComponent>& MeshComponent : ActiveBehaviors[Index].PrerequisiteMeshes)
+	{
+		RemoveMeshPrerequisite(MeshComponent);
+	}
+	DamageBehavior->ActiveBehaviorIndex = INDEX_NONE;
+
+	if (bIsTickingActiveBehaviors)
+	{
+		// keep indices stable while iterating, compacted after tick
+		ActiveBehaviors[Index] = {};
+		bHasPendingRemovals = true;
+		return;
+	}
+
+	ActiveBehaviors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (ActiveBehaviors.IsValidIndex(Index))
+	{
+		if (UDamageBehavior* MovedDamageBehavior = ActiveBehaviors[Index].DamageBehavior.Get())
+		{
+			MovedDamageBehavior->ActiveBehaviorIndex = Index;
+		}
+	}
+
+	UpdateTickFunctionEnabled();
+}
+
+void UDamageBehaviorsSubsystem::TickActiveBehaviors(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DBS_TickActiveBehaviors);
+	SET_DWORD_STAT(STAT_DBS_ActiveBehaviors, ActiveBehaviors.Num());
+
+	static IConsoleVariable* CVarDBSParallelSweeps = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.ParallelSweeps"));
+	const bool bParallelSweeps = CVarDBSParallelSweeps && CVarDBSParallelSweeps->GetBool();
+	static IConsoleVariable* CVarDBSDetectionLOD = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.DetectionLOD"));
+	const bool bDetectionLOD = CVarDBSDetectionLOD && CVarDBSDetectionLOD->GetBool();
+	if (bDetectionLOD)
+	{
+		GatherPlayerLocations();
+	}
+	int32 NumBehaviorsByDetectionLOD[3] = { 0, 0, 0 };
+
+	// scratch owned by subsystem for the whole world lifetime, serial sweeps use it too
+	SweepBatch.Reset();
+	SweepBatch.bDeferExecution = bParallelSweeps;
+
+	bIsTickingActiveBehaviors = true;
+	// index loop on purpose - behaviors activated during tick are appended and ticked this frame
+	for (int32 i = 0; i < ActiveBehaviors.Num(); i++)
+	{
+		UDamageBehavior* DamageBehavior = ActiveBehaviors[i].DamageBehavior.Get();
+		if (!DamageBehavior)
+		{
+			bHasPendingRemovals = true;
+			continue;
+		}
+
+		DamageBehavior->DetectionLOD = bDetectionLOD ? CalculateDetectionLOD(*DamageBehavior) : EDBSDetectionLOD::Full;
+		NumBehaviorsByDetectionLOD[static_cast<int32>(DamageBehavior->DetectionLOD)]++;
+		if (!ShouldTickAtDetectionLOD(DamageBehavior->DetectionLOD, ActiveBehaviors[i].DetectionLODPhase))
+		{
+			// HitRegistrators keep previous transform, next tick sweeps longer segment
+			INC_DWORD_STAT(STAT_DBS_DetectionLODSkippedTicks);
+			DamageBehavior->DeliverAsyncHits();
+			continue;
+		}
+		DamageBehavior->Tick(DeltaTime, &SweepBatch);
+	}
+	SET_DWORD_STAT(STAT_DBS_DetectionLODFull, NumBehaviorsByDetectionLOD[0]);
+	SET_DWORD_STAT(STAT_DBS_DetectionLODReduced, NumBehaviorsByDetectionLOD[1]);
+	SET_DWORD_STAT(STAT_DBS_DetectionLODSimplified, NumBehaviorsByDetectionLOD[2]);
+
+	if (bParallelSweeps && SweepBatch.Num() > 0)
+	{
+		ExecuteSweepBatch();
+		CommitSweepBatch();
+	}
+	// after occupancy of this frame updated, occupants that left are already cancelled
+	TickStandingInsideHits();
+	bIsTickingActiveBehaviors = false;
+
+	if (bHasPendingRemovals)
+	{
+		CompactActiveBehaviors();
+	}
+}
+
+void UDamageBehaviorsSubsystem::ExecuteSweepBatch()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DBS_ExecuteParallelSweeps);
+	INC_DWORD_STAT_BY(STAT_DBS_ParallelSweeps, SweepBatch.Num());
+
+	const UWorld* World = GetWorld();
+	const TArrayView<FDBSHitRegistratorSweep> Sweeps = SweepBatch.GetSweeps();
+
+	// physics scene is read-only until we commit, each sweep writes only to its own HitResults
+	int64 SerialCycles = 0;
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	ParallelFor(TEXT("DBS.ParallelSweeps"), Sweeps.Num(), 1, [World, Sweeps, &SerialCycles](int32 Index)
+	{
+		const uint64 SweepStartCycles = FPlatformTime::Cycles64();
+		UDBSHitRegistratorBase::ExecuteSweep(World, Sweeps[Index]);
+		FPlatformAtomics::InterlockedAdd(&SerialCycles, static_cast<int64>(FPlatformTime::Cycles64() - SweepStartCycles));
+	});
+	const uint64 WallCycles = FPlatformTime::Cycles64() - StartCycles;
+
+	SET_FLOAT_STAT(STAT_DBS_ParallelSweepsSavedMs, FPlatformTime::ToMilliseconds64(SerialCycles) - FPlatformTime::ToMilliseconds64(WallCycles));
+}
+
+void UDamageBehaviorsSubsystem::CommitSweepBatch()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DBS_CommitParallelSweeps);
+
+	// HitRegistrators can't be garbage collected during frame, but could be destroyed/disabled by hits processing
+	for (const FDBSHitRegistratorSweep& Sweep : SweepBatch.GetSweeps())
+	{
+		if (!IsValid(Sweep.HitRegistrator)) continue;
+		Sweep.HitRegistrator->CommitSweep(Sweep);
+	}
+	SweepBatch.Reset();
+}
+
+FDBSTimerWheelHandle UDamageBehaviorsSubsystem::ScheduleStandingInsideHit(UDBSHitRegistratorBase* HitRegistrator, UPrimitiveComponent* Occupant, float Delay)
+{
+	return StandingInsideHitsWheel.Schedule(GetWorld()->GetTimeSeconds() + Delay, { HitRegistrator, Occupant });
+}
+
+void UDamageBehaviorsSubsystem::CancelStandingInsideHit(FDBSTimerWheelHandle& Handle)
+{
+	StandingInsideHitsWheel.Cancel(Handle);
+}
+
+void UDamageBehaviorsSubsystem::TickStandingInsideHits()
+{
+	ExpiredStandingInsideHits.Reset();
+	StandingInsideHitsWheel.Advance(GetWorld()->GetTimeSeconds(), ExpiredStandingInsideHits);
+	SET_DWORD_STAT(STAT_DBS_StandingInsideTimers, StandingInsideHitsWheel.Num());
+	INC_DWORD_STAT_BY(STAT_DBS_StandingInsideHits, ExpiredStandingInsideHits.Num());
+
+	for (const FDBSStandingInsideHit& StandingInsideHit : ExpiredStandingInsideHits)
+	{
+		if (UDBSHitRegistratorBase* HitRegistrator = StandingInsideHit.HitRegistrator.Get())
+		{
+			HitRegistrator->HandleStandingInsideHit(StandingInsideHit.Occupant);
+		}
+	}
+}
+
+void UDamageBehaviorsSubsystem::GatherPlayerLocations()
+{
+	PlayerLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr)
+		{
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+}
+
+EDBSDetectionLOD UDamageBehaviorsSubsystem::CalculateDetectionLOD(const UDamageBehavior& DamageBehavior) const
+{
+	EDBSDetectionLOD DetectionLOD = EDBSDetectionLOD::Full;
+
+	const AActor* OwnerActor = DamageBehavior.GetOwningActor();
+	// weapons are owned by characters, instigator is the one attacking
+	const APawn* AttackerPawn = OwnerActor ? OwnerActor->GetInstigator() : nullptr;
+	if (!AttackerPawn)
+	{
+		AttackerPawn = Cast<APawn>(OwnerActor);
+	}
+
+	const AAIController* AIController = AttackerPawn ? Cast<AAIController>(AttackerPawn->GetController()) : nullptr;
+	const APawn* FocusPawn = AIController ? Cast<APawn>(AIController->GetFocusActor()) : nullptr;
+	const bool bIsPlayerAttack = AttackerPawn && AttackerPawn->IsPlayerControlled();
+	const bool bIsAttackOnPlayer = FocusPawn && FocusPawn->IsPlayerControlled();
+
+	if (OwnerActor && DamageBehavior.HitDetectionSettings.bAllowDetectionLOD && !bIsPlayerAttack && !bIsAttackOnPlayer)
+	{
+		const FVector Location = OwnerActor->GetActorLocation();
+		float MinDistanceSquared = UE_MAX_FLT;
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, static_cast<float>(FVector::DistSquared(Location, PlayerLocation)));
+		}
+
+		if (MinDistanceSquared >= DetectionLODSimplifiedDistanceSquared)
+		{
+			DetectionLOD = EDBSDetectionLOD::Simplified;
+		}
+		else if (MinDistanceSquared >= DetectionLODReducedDistanceSquared)
+		{
+			DetectionLOD = EDBSDetectionLOD::Reduced;
+		}
+	}
+
+	return DetectionLODOverride.IsBound() ? DetectionLODOverride.Execute(&DamageBehavior, DetectionLOD) : DetectionLOD;
+}
+
+bool UDamageBehaviorsSubsystem::ShouldTickAtDetectionLOD(EDBSDetectionLOD DetectionLOD, uint32 DetectionLODPhase) const
+{
+	int32 Interval = 1;
+	switch (DetectionLOD)
+	{
+		case EDBSDetectionLOD::Reduced:
+			Interval = DetectionLODReducedInterval;
+			break;
+		case EDBSDetectionLOD::Simplified:
+			Interval = DetectionLODSimplifiedInterval;
+			break;
+		default:
+			break;
+	}
+	// spread behaviors of same LOD over frames instead of ticking all of them on same frame,
+	// phase doesn't follow index so RemoveAtSwap can't make a behavior skip or repeat a tick
+	return Interval == 1 || (GFrameCounter + DetectionLODPhase) % Interval == 0;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+bool UDamageBehaviorsSubsystem::ShouldTickAtDetectionLODForTests(const UDamageBehavior* DamageBehavior, EDBSDetectionLOD DetectionLOD) const
+{
+	if (!IsValid(DamageBehavior) || !ActiveBehaviors.IsValidIndex(DamageBehavior->ActiveBehaviorIndex)) return false;
+	return ShouldTickAtDetectionLOD(DetectionLOD, ActiveBehaviors[DamageBehavior->ActiveBehaviorIndex].DetectionLODPhase);
+}
+#endif
+
+void UDamageBehaviorsSubsystem::AddMeshPrerequisite(USkeletalMeshComponent* MeshComponent)
+{
+	int32& RefCount = PrerequisiteMeshesRefCount.FindOrAdd(MeshComponent);
+	if (RefCount++ == 0)
+	{
+		ActiveBehaviorsTickFunction.AddPrerequisite(MeshComponent, MeshComponent->PrimaryComponentTick);
+	}
+}
+
+void UDamageBehaviorsSubsystem::RemoveMeshPrerequisite(const TWeakObjectPtr<USkeletalMeshComponent>& MeshComponent)
+{
+	int32* RefCount = PrerequisiteMeshesRefCount.Find(MeshComponent);
+	if (!RefCount || --(*RefCount) > 0) return;
+
+	PrerequisiteMeshesRefCount.Remove(MeshComponent);
+	if (USkeletalMeshComponent* Mesh = MeshComponent.Get())
+	{
+		ActiveBehaviorsTickFunction.RemovePrerequisite(Mesh, Mesh->PrimaryComponentTick);
+	}
+}
+
+void UDamageBehaviorsSubsystem::CompactActiveBehaviors()
+{
+	bHasPendingRemovals = false;
+
+	for (int32 i = ActiveBehaviors.Num() - 1; i >= 0; i--)
+	{
+		if (ActiveBehaviors[i].DamageBehavior.IsValid()) continue;
+
+		// behavior was garbage collected while active, release its prerequisites
+		for (const TWeakObjectPtr<USkeletalMeshComponent>& MeshComponent : ActiveBehaviors[i].PrerequisiteMeshes)
+		{
+			RemoveMeshPrerequisite(MeshComponent);
+		}
+		ActiveBehaviors.RemoveAtSwap(i, 1, EAllowShrinking::No);
+	}
+
+	for (int32 i = 0; i < ActiveBehaviors.Num(); i++)
+	{
+		ActiveBehaviors[i].DamageBehavior->ActiveBehaviorIndex = i;
+	}
+
+	UpdateTickFunctionEnabled();
+}
+
+void UDamageBehaviorsSubsystem::UpdateTickFunctionEnabled()
+{
+	if (ActiveBehaviorsTickFunction.IsTickFunctionRegistered())
+	{
+		ActiveBehaviorsTickFunction.SetTickFunctionEnable(ActiveBehaviors.Num() > 0);
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "DamageBehaviorsSystemModule.h"
 
+#include "DBSCapture.h"
 #include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "FDamageBehaviorsSystemModule"
@@ -34,6 +35,68 @@ static TAutoConsoleVariable<int32> CVarDBSHitLog(
 	ECVF_Default
 );
 
+static TAutoConsoleVariable<bool> CVarDBSParallelSweeps(
+	TEXT("DamageBehaviorsSystem.ParallelSweeps"),
+	false,
+	TEXT("Run ByTrace sweeps of all active DamageBehaviors on worker threads, hits are still processed on game thread"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarDBSHittableBroadphase(
+	TEXT("DamageBehaviorsSystem.HittableBroadphase"),
+	false,
+	TEXT("Skip ByTrace sweeps when no registered hittable actor is near swept capsule, hittable actors registry created only if enabled on world start"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarDBSAnimSkippedFramesSweeps(
+	TEXT("DamageBehaviorsSystem.AnimSkippedFramesSweeps"),
+	true,
+	TEXT("Don't sweep HitRegistrators on frames their skeletal mesh skipped animation(URO/VisibilityBasedAnimTickOption), sweep frozen frames together with next evaluated pose"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarDBSDetectionLOD(
+	TEXT("DamageBehaviorsSystem.DetectionLOD"),
+	false,
+	TEXT("Tick active DamageBehaviors far from players at reduced rate or with single HitRegistrator, attacks of/on players always at full rate"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarDBSBakedHitWindows(
+	TEXT("DamageBehaviorsSystem.BakedHitWindows"),
+	false,
+	TEXT("Sweep HitRegistrators of baked montage hit windows along baked trajectories instead of animated pose"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarDBSLagCompensation(
+	TEXT("DamageBehaviorsSystem.LagCompensation"),
+	false,
+	TEXT("Record hurtboxes transforms history on server so ByHurtboxes sweeps can be rewound to attacker client time, read on world start"),
+	ECVF_Default
+);
+
+static void OnDBSCaptureChanged(IConsoleVariable* Variable)
+{
+	if (Variable->GetBool())
+	{
+		FDBSCapture::Start();
+	}
+	else
+	{
+		FDBSCapture::Stop();
+	}
+}
+
+static TAutoConsoleVariable<bool> CVarDBSCapture(
+	TEXT("DamageBehaviorsSystem.Capture"),
+	false,
+	TEXT("Write activations, sweeps, raw hits and hit decisions to binary capture in Saved/DamageBehaviorsSystem/Captures, convert with -run=DBSCaptureConvert"),
+	FConsoleVariableDelegate::CreateStatic(&OnDBSCaptureChanged),
+	ECVF_Default
+);
+
 void FDamageBehaviorsSystemModule::StartupModule()
 {
 }
@@ -42,6 +105,7 @@ void FDamageBehaviorsSystemModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FDBSCapture::Stop();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,16 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "SphereHitRegistrator.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(SphereHitRegistrator)
+
+FCollisionShape USphereHitRegistrator::GetUnscaledShape() const
+{
+	return FCollisionShape::MakeSphere(SphereRadius);
+}
+
+void USphereHitRegistrator::SetSphereRadius(float Radius_In, bool bUpdateOverlaps)
+{
+	SphereRadius = FMath::Max(0.0f, Radius_In);
+	NotifyShapeChanged(bUpdateOverlaps);
+}
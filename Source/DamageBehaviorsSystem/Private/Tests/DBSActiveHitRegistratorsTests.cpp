@@ -0,0 +1,91 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "CapsuleHitRegistrator.h"
+#include "DamageBehavior.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSActiveHitRegistratorsTest, "DamageBehaviorsSystem.DamageBehavior.ActiveHitRegistrators",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSActiveHitRegistratorsTest::RunTest(const FString& Parameters)
+{
+	AActor* Weapon = NewObject<AActor>(GetTransientPackage());
+	UCapsuleHitRegistrator* Blade = NewObject<UCapsuleHitRegistrator>(Weapon, TEXT("Blade"));
+	UCapsuleHitRegistrator* Handle = NewObject<UCapsuleHitRegistrator>(Weapon, TEXT("Handle"));
+	UCapsuleHitRegistrator* Tip = NewObject<UCapsuleHitRegistrator>(Weapon, TEXT("Tip"));
+	AActor* Character = NewObject<AActor>(GetTransientPackage());
+	UCapsuleHitRegistrator* Fist = NewObject<UCapsuleHitRegistrator>(Character, TEXT("Fist"));
+
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	DamageBehavior->HitRegistratorsSources = {
+		{ TEXT("Weapon"), Weapon, { Blade, nullptr, Handle, Tip } },
+		{ TEXT("Character"), Character, { Fist } },
+		{ TEXT("Dropped"), nullptr, { Fist } }
+	};
+	// names compared with registrators FName, missing names and sources ignored
+	DamageBehavior->HitRegistratorsToActivateBySource = {
+		{ TEXT("Weapon"), { TEXT("Tip"), TEXT("Blade"), TEXT("Blade"), TEXT("Missing") } },
+		{ TEXT("Shield"), { TEXT("Fist") } }
+	};
+
+	DamageBehavior->ResolveActiveHitRegistratorsForTests();
+	const TArray<TObjectPtr<UDBSHitRegistratorBase>>& ActiveHitRegistrators = DamageBehavior->GetActiveHitRegistratorsForTests();
+	if (!TestEqual(TEXT("only listed registrators of listed sources"), ActiveHitRegistrators.Num(), 2)) return false;
+	TestTrue(TEXT("sources order kept"), ActiveHitRegistrators[0] == Blade && ActiveHitRegistrators[1] == Tip);
+
+	// same registrator reachable from several sources driven once, source without actor skipped
+	DamageBehavior->HitRegistratorsToActivateBySource.Add({ TEXT("Character"), { TEXT("Fist") } });
+	DamageBehavior->HitRegistratorsToActivateBySource.Add({ TEXT("Dropped"), { TEXT("Fist") } });
+	DamageBehavior->HitRegistratorsSources.Add({ TEXT("Character"), Character, { Fist } });
+	DamageBehavior->ResolveActiveHitRegistratorsForTests();
+	TestEqual(TEXT("registrator added once"), ActiveHitRegistrators.Num(), 3);
+	TestTrue(TEXT("character registrator resolved"), ActiveHitRegistrators.Contains(Fist));
+
+	// resolved again on every activation, destroyed registrators dropped
+	Blade->MarkAsGarbage();
+	DamageBehavior->ResolveActiveHitRegistratorsForTests();
+	TestFalse(TEXT("destroyed registrator dropped"), ActiveHitRegistrators.Contains(Blade));
+	TestEqual(TEXT("rest resolved"), ActiveHitRegistrators.Num(), 2);
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSAttachmentsChangedTest, "DamageBehaviorsSystem.DamageBehavior.AttachmentsChanged",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSAttachmentsChangedTest::RunTest(const FString& Parameters)
+{
+	AActor* Weapon = NewObject<AActor>(GetTransientPackage());
+	UCapsuleHitRegistrator* Blade = NewObject<UCapsuleHitRegistrator>(Weapon, TEXT("Blade"));
+	AActor* Target = NewObject<AActor>(GetTransientPackage());
+
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	DamageBehavior->bAttachEnemiesToCapsuleWhileActive = true;
+	DamageBehavior->HitRegistratorsSources = { { TEXT("Weapon"), Weapon, { Blade } } };
+	DamageBehavior->HitRegistratorsToActivateBySource = { { TEXT("Weapon"), { TEXT("Blade") } } };
+	DamageBehavior->ResolveActiveHitRegistratorsForTests();
+
+	Blade->RebuildQueryParamsForTests();
+	TestFalse(TEXT("query params built"), Blade->IsQueryParamsDirtyForTests());
+
+	// hit actor attached to owner, sweeps should ignore it from now on
+	DamageBehavior->AddHittedActor(Target, true, false);
+	TestTrue(TEXT("attach rebuilds query params"), Blade->IsQueryParamsDirtyForTests());
+
+	Blade->RebuildQueryParamsForTests();
+	DamageBehavior->AddHittedActor(Target, true, false);
+	TestFalse(TEXT("re-hit doesn't attach again"), Blade->IsQueryParamsDirtyForTests());
+
+	DamageBehavior->ClearHittedActors();
+	TestTrue(TEXT("detach rebuilds query params"), Blade->IsQueryParamsDirtyForTests());
+
+	Blade->RebuildQueryParamsForTests();
+	DamageBehavior->ClearHittedActors();
+	TestFalse(TEXT("nothing detached"), Blade->IsQueryParamsDirtyForTests());
+	return true;
+}
+
+#endif
@@ -0,0 +1,77 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSBakedTrajectory.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSBakedTrajectoryTest, "DamageBehaviorsSystem.BakedTrajectory",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSBakedTrajectoryTest::RunTest(const FString& Parameters)
+{
+	FDBSBakedTrajectoryTrack Track;
+	TestTrue(TEXT("empty track is identity"), Track.Evaluate(0.5f).Equals(FTransform::Identity));
+
+	Track.SourceName = TEXT("Weapon");
+	Track.HitRegistratorName = TEXT("Blade");
+	Track.KeyTimes = { 0.0f, 0.5f, 1.0f };
+	Track.KeyLocations = { FVector3f(0.0f, 0.0f, 0.0f), FVector3f(100.0f, 0.0f, 0.0f), FVector3f(100.0f, 200.0f, 0.0f) };
+	Track.KeyRotations = { FQuat4f::Identity, FQuat4f(FVector3f::UpVector, UE_HALF_PI), FQuat4f(FVector3f::UpVector, UE_PI) };
+
+	// sampled between keys
+	const FTransform Quarter = Track.Evaluate(0.25f);
+	TestTrue(TEXT("location interpolated"), Quarter.GetLocation().Equals(FVector(50.0, 0.0, 0.0), 0.01));
+	TestTrue(TEXT("rotation interpolated"), Quarter.GetRotation().AngularDistance(FQuat(FVector::UpVector, UE_HALF_PI * 0.5)) < 1e-3);
+	TestTrue(TEXT("second segment"), Track.Evaluate(0.75f).GetLocation().Equals(FVector(100.0, 100.0, 0.0), 0.01));
+
+	// exactly on key
+	TestTrue(TEXT("key location"), Track.Evaluate(0.5f).GetLocation().Equals(FVector(100.0, 0.0, 0.0), 0.01));
+	TestTrue(TEXT("key rotation"), Track.Evaluate(0.5f).GetRotation().AngularDistance(FQuat(FVector::UpVector, UE_HALF_PI)) < 1e-3);
+
+	// clamped to first/last key
+	TestTrue(TEXT("before window clamped"), Track.Evaluate(-1.0f).GetLocation().Equals(FVector::ZeroVector, 0.01));
+	TestTrue(TEXT("after window clamped"), Track.Evaluate(5.0f).GetLocation().Equals(FVector(100.0, 200.0, 0.0), 0.01));
+
+	// single key
+	FDBSBakedTrajectoryTrack SingleKeyTrack;
+	SingleKeyTrack.KeyTimes = { 0.3f };
+	SingleKeyTrack.KeyLocations = { FVector3f(1.0f, 2.0f, 3.0f) };
+	SingleKeyTrack.KeyRotations = { FQuat4f::Identity };
+	TestTrue(TEXT("single key before"), SingleKeyTrack.Evaluate(0.0f).GetLocation().Equals(FVector(1.0, 2.0, 3.0), 0.01));
+	TestTrue(TEXT("single key after"), SingleKeyTrack.Evaluate(1.0f).GetLocation().Equals(FVector(1.0, 2.0, 3.0), 0.01));
+
+	// tracks found by source and registrator names
+	FDBSBakedHitWindow HitWindow;
+	TestFalse(TEXT("window without tracks invalid"), HitWindow.IsValid());
+	HitWindow.StartTime = 0.4f;
+	HitWindow.Duration = 1.0f;
+	HitWindow.Tracks.Add(Track);
+	HitWindow.Tracks.Add(SingleKeyTrack);
+	TestTrue(TEXT("window with tracks valid"), HitWindow.IsValid());
+	TestTrue(TEXT("track found"), HitWindow.FindTrack(TEXT("Weapon"), TEXT("Blade")) == &HitWindow.Tracks[0]);
+	TestNull(TEXT("other source not found"), HitWindow.FindTrack(TEXT("Character"), TEXT("Blade")));
+
+	// serialization round trip
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	Writer << HitWindow;
+	FDBSBakedHitWindow LoadedHitWindow;
+	FMemoryReader Reader(Data);
+	Reader << LoadedHitWindow;
+	TestEqual(TEXT("loaded start"), LoadedHitWindow.StartTime, HitWindow.StartTime);
+	TestEqual(TEXT("loaded duration"), LoadedHitWindow.Duration, HitWindow.Duration);
+	if (TestEqual(TEXT("loaded tracks"), LoadedHitWindow.Tracks.Num(), 2))
+	{
+		const FDBSBakedTrajectoryTrack* LoadedTrack = LoadedHitWindow.FindTrack(TEXT("Weapon"), TEXT("Blade"));
+		if (TestNotNull(TEXT("loaded track found"), LoadedTrack))
+		{
+			TestTrue(TEXT("loaded track sampled same"), LoadedTrack->Evaluate(0.25f).Equals(Quarter));
+		}
+	}
+	return true;
+}
+
+#endif
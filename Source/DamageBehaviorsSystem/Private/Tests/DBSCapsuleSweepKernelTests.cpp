@@ -0,0 +1,311 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSCapsuleSweepKernel.h"
+#include "DBSHitRegistratorSweep.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DBSCapsuleSweepKernelTests
+{
+	struct FTargetCapsule
+	{
+		FVector Center;
+		FQuat Rotation;
+		float Radius;
+		float HalfHeight;
+	};
+
+	FDBSHitRegistratorSweep MakeSweep(const FVector& Start, const FVector& End, const FQuat& Rotation, float Radius, float HalfHeight)
+	{
+		FDBSHitRegistratorSweep Sweep;
+		Sweep.Start = Start;
+		Sweep.End = End;
+		Sweep.Rotation = Rotation;
+		Sweep.CollisionShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+		return Sweep;
+	}
+
+	TArray<FDBSCapsuleSweepHit> Sweep(const FDBSHitRegistratorSweep& Sweep, TConstArrayView<FTargetCapsule> Targets)
+	{
+		FDBSCapsulesSoA Capsules;
+		Capsules.Reset(Sweep.Start);
+		for (const FTargetCapsule& Target : Targets)
+		{
+			Capsules.Add(Target.Center, Target.Rotation, Target.Radius, Target.HalfHeight);
+		}
+		TArray<FDBSCapsuleSweepHit> Hits;
+		FDBSCapsuleSweepKernel::SweepCapsuleAgainstCapsules(Sweep, Capsules, Hits);
+		return Hits;
+	}
+
+	// capsule lying along X
+	const FQuat AlongX = FQuat(FVector::YAxisVector, UE_HALF_PI);
+
+	// minimum over sweep of distance between capsule segments minus radii, sampled densely
+	float MinimumGap(const FDBSHitRegistratorSweep& Sweep, const FTargetCapsule& Target)
+	{
+		const float SweepRadius = Sweep.CollisionShape.GetCapsuleRadius();
+		const FVector SweepSegment = Sweep.Rotation.GetUpVector() * (Sweep.CollisionShape.GetCapsuleHalfHeight() - SweepRadius);
+		const FVector TargetSegment = Target.Rotation.GetUpVector() * (Target.HalfHeight - Target.Radius);
+
+		float Minimum = TNumericLimits<float>::Max();
+		for (int32 i = 0; i <= 2048; i++)
+		{
+			const FVector Center = FMath::Lerp(Sweep.Start, Sweep.End, i / 2048.0);
+			FVector Closest1;
+			FVector Closest2;
+			FMath::SegmentDistToSegmentSafe(Center - SweepSegment, Center + SweepSegment,
+				Target.Center - TargetSegment, Target.Center + TargetSegment, Closest1, Closest2);
+			Minimum = FMath::Min(Minimum, FVector::Dist(Closest1, Closest2) - SweepRadius - Target.Radius);
+		}
+		return Minimum;
+	}
+
+	// world with query only capsules, overlapping SweepMultiByChannel returns every touched capsule
+	struct FTestWorld
+	{
+		UWorld* World = nullptr;
+		TArray<UCapsuleComponent*> Components;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		void Add(const FTargetCapsule& Target)
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+			UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(Actor);
+			Capsule->SetCapsuleSize(Target.Radius, Target.HalfHeight);
+			Capsule->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+			Capsule->SetCollisionObjectType(ECC_WorldDynamic);
+			Capsule->SetCollisionResponseToAllChannels(ECR_Overlap);
+			Capsule->SetWorldLocationAndRotation(Target.Center, Target.Rotation);
+			Actor->SetRootComponent(Capsule);
+			Capsule->RegisterComponent();
+			Components.Add(Capsule);
+		}
+
+		void Sweep(const FDBSHitRegistratorSweep& Sweep, TArray<FHitResult>& OutHits) const
+		{
+			World->SweepMultiByChannel(OutHits, Sweep.Start, Sweep.End, Sweep.Rotation, ECC_WorldDynamic, Sweep.CollisionShape);
+		}
+	};
+
+	FTargetCapsule MakeRandomCapsule(FRandomStream& Random, float Extent)
+	{
+		FTargetCapsule Target;
+		Target.Center = FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent));
+		Target.Rotation = FQuat(Random.GetUnitVector(), Random.FRandRange(0.0f, UE_PI));
+		Target.Radius = Random.FRandRange(5.0f, 40.0f);
+		Target.HalfHeight = Target.Radius + Random.FRandRange(0.0f, 80.0f);
+		return Target;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSCapsuleSweepKernelCasesTest, "DamageBehaviorsSystem.CapsuleSweepKernel.Cases",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSCapsuleSweepKernelCasesTest::RunTest(const FString& Parameters)
+{
+	using namespace DBSCapsuleSweepKernelTests;
+
+	const FDBSHitRegistratorSweep Horizontal = MakeSweep(FVector(-200.0, 0.0, 0.0), FVector(200.0, 0.0, 0.0), FQuat::Identity, 10.0f, 40.0f);
+
+	// grazing - radii sum is 30
+	{
+		const TArray<FDBSCapsuleSweepHit> Hits = Sweep(Horizontal, { { FVector(0.0, 30.0 - 0.05, 0.0), FQuat::Identity, 20.0f, 60.0f } });
+		TestEqual(TEXT("grazing inside tolerance hits"), Hits.Num(), 1);
+		if (Hits.Num() == 1)
+		{
+			TestNearlyEqual(TEXT("grazing hit at closest approach"), Hits[0].Time, 0.5f, 0.01f);
+			TestTrue(TEXT("grazing normal points to sweep"), Hits[0].ImpactNormal.Y < -0.99);
+		}
+		TestEqual(TEXT("grazing outside tolerance misses"),
+			Sweep(Horizontal, { { FVector(0.0, 31.0, 0.0), FQuat::Identity, 20.0f, 60.0f } }).Num(), 0);
+	}
+
+	// tunneling - thin target, sweep many times longer than both capsules
+	{
+		const FDBSHitRegistratorSweep Fast = MakeSweep(FVector(-10000.0, 0.0, 0.0), FVector(10000.0, 0.0, 0.0), FQuat::Identity, 10.0f, 40.0f);
+		const TArray<FDBSCapsuleSweepHit> Hits = Sweep(Fast, { { FVector::ZeroVector, FQuat::Identity, 1.0f, 100.0f } });
+		if (TestEqual(TEXT("thin target not tunneled"), Hits.Num(), 1))
+		{
+			TestNearlyEqual(TEXT("tunneling time of impact"), Hits[0].Time * 20000.0f, 10000.0f - 11.0f, 0.5f);
+			TestFalse(TEXT("not start penetrating"), Hits[0].bStartPenetrating);
+		}
+	}
+
+	// shallow approach along long target - conservative advancement steps shrink with gap,
+	// lane is still active after MaxIterations and resolved by fallback
+	{
+		const FTargetCapsule Long = { FVector(5000.0, 0.0, 0.0), AlongX, 10.0f, 5000.0f };
+		const FDBSHitRegistratorSweep Shallow = MakeSweep(FVector(0.0, 100.0, 0.0), FVector(10000.0, 0.0, 0.0), FQuat::Identity, 10.0f, 10.0f);
+		const TArray<FDBSCapsuleSweepHit> Hits = Sweep(Shallow, { Long });
+		if (TestEqual(TEXT("shallow approach past MaxIterations hits"), Hits.Num(), 1))
+		{
+			// gap is 80 - 100 * Time
+			TestNearlyEqual(TEXT("shallow approach time of impact"), Hits[0].Time, 0.8f, 0.002f);
+		}
+
+		// parallel at constant gap of 30 - never touches, also goes through fallback
+		const FDBSHitRegistratorSweep Parallel = MakeSweep(FVector(0.0, 50.0, 0.0), FVector(10000.0, 50.0, 0.0), FQuat::Identity, 10.0f, 10.0f);
+		TestEqual(TEXT("parallel sweep past MaxIterations misses"), Sweep(Parallel, { Long }).Num(), 0);
+	}
+
+	// padding lanes never reported, hits sorted by time
+	{
+		TArray<FTargetCapsule> Targets;
+		Targets.Add({ FVector(100.0, 0.0, 0.0), FQuat::Identity, 20.0f, 60.0f });
+		Targets.Add({ FVector(0.0, 5000.0, 0.0), FQuat::Identity, 20.0f, 60.0f });
+		Targets.Add({ FVector(0.0, 5000.0, 0.0), FQuat::Identity, 20.0f, 60.0f });
+		Targets.Add({ FVector(0.0, 5000.0, 0.0), FQuat::Identity, 20.0f, 60.0f });
+		Targets.Add({ FVector(-100.0, 0.0, 0.0), FQuat::Identity, 20.0f, 60.0f });
+		const TArray<FDBSCapsuleSweepHit> Hits = Sweep(Horizontal, Targets);
+		if (TestEqual(TEXT("only real targets hit"), Hits.Num(), 2))
+		{
+			TestEqual(TEXT("earlier hit first"), Hits[0].TargetIndex, 4);
+			TestEqual(TEXT("later hit second"), Hits[1].TargetIndex, 0);
+		}
+
+		// zero length sweep against padding lanes only checks overlap
+		const FDBSHitRegistratorSweep Still = MakeSweep(FVector::ZeroVector, FVector::ZeroVector, FQuat::Identity, 10.0f, 40.0f);
+		TestEqual(TEXT("zero length sweep misses far targets"), Sweep(Still, { Targets[1] }).Num(), 0);
+	}
+
+	// start penetrating
+	{
+		const TArray<FDBSCapsuleSweepHit> Hits = Sweep(Horizontal, { { FVector(-190.0, 0.0, 0.0), FQuat::Identity, 20.0f, 60.0f } });
+		if (TestEqual(TEXT("initial overlap hits"), Hits.Num(), 1))
+		{
+			TestTrue(TEXT("initial overlap start penetrating"), Hits[0].bStartPenetrating);
+			TestEqual(TEXT("initial overlap at time 0"), Hits[0].Time, 0.0f);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSCapsuleSweepKernelRandomizedTest, "DamageBehaviorsSystem.CapsuleSweepKernel.MatchesSweepMultiByChannel",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSCapsuleSweepKernelRandomizedTest::RunTest(const FString& Parameters)
+{
+	using namespace DBSCapsuleSweepKernelTests;
+
+	FRandomStream Random(2025);
+	FTestWorld TestWorld;
+	TArray<FTargetCapsule> Targets;
+	for (int32 i = 0; i < 64; i++)
+	{
+		TestWorld.Add(Targets.Add_GetRef(MakeRandomCapsule(Random, 1000.0f)));
+	}
+
+	FDBSCapsulesSoA Capsules;
+	TArray<FDBSCapsuleSweepHit> KernelHits;
+	TArray<FHitResult> PhysicsHits;
+	int32 NumCompared = 0;
+	for (int32 SweepIndex = 0; SweepIndex < 256; SweepIndex++)
+	{
+		const FTargetCapsule Shape = MakeRandomCapsule(Random, 1000.0f);
+		const FVector End = Shape.Center + Random.GetUnitVector() * Random.FRandRange(0.0f, 3000.0f);
+		const FDBSHitRegistratorSweep Sweep = MakeSweep(Shape.Center, End, Shape.Rotation, Shape.Radius, Shape.HalfHeight);
+
+		Capsules.Reset(Sweep.Start);
+		for (const FTargetCapsule& Target : Targets)
+		{
+			Capsules.Add(Target.Center, Target.Rotation, Target.Radius, Target.HalfHeight);
+		}
+		KernelHits.Reset();
+		FDBSCapsuleSweepKernel::SweepCapsuleAgainstCapsules(Sweep, Capsules, KernelHits);
+		TestWorld.Sweep(Sweep, PhysicsHits);
+
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); TargetIndex++)
+		{
+			// physics has own contact offsets, grazing targets may go either way
+			const float Gap = MinimumGap(Sweep, Targets[TargetIndex]);
+			if (FMath::Abs(Gap) < 1.0f) continue;
+
+			const FDBSCapsuleSweepHit* KernelHit = KernelHits.FindByPredicate([TargetIndex](const FDBSCapsuleSweepHit& Hit) { return Hit.TargetIndex == TargetIndex; });
+			const FHitResult* PhysicsHit = PhysicsHits.FindByPredicate([&TestWorld, TargetIndex](const FHitResult& Hit) { return Hit.GetComponent() == TestWorld.Components[TargetIndex]; });
+			NumCompared++;
+
+			if (!TestEqual(FString::Printf(TEXT("sweep %d target %d hit"), SweepIndex, TargetIndex), KernelHit != nullptr, PhysicsHit != nullptr)) continue;
+			if (!KernelHit || KernelHit->bStartPenetrating || PhysicsHit->bStartPenetrating) continue;
+
+			const double SweepLength = FVector::Dist(Sweep.Start, Sweep.End);
+			TestNearlyEqual(FString::Printf(TEXT("sweep %d target %d distance"), SweepIndex, TargetIndex),
+				KernelHit->Time * SweepLength, static_cast<double>(PhysicsHit->Time) * SweepLength, 1.0);
+		}
+	}
+	AddInfo(FString::Printf(TEXT("%d sweep-target pairs compared"), NumCompared));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSCapsuleSweepKernelBenchmark, "DamageBehaviorsSystem.CapsuleSweepKernel.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FDBSCapsuleSweepKernelBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace DBSCapsuleSweepKernelTests;
+
+	constexpr int32 NumTargets = 128;
+	constexpr int32 NumSweeps = 2000;
+
+	FRandomStream Random(7);
+	FTestWorld TestWorld;
+	FDBSCapsulesSoA Capsules;
+	Capsules.Reset(FVector::ZeroVector);
+	for (int32 i = 0; i < NumTargets; i++)
+	{
+		const FTargetCapsule Target = MakeRandomCapsule(Random, 1500.0f);
+		TestWorld.Add(Target);
+		Capsules.Add(Target.Center, Target.Rotation, Target.Radius, Target.HalfHeight);
+	}
+
+	TArray<FDBSHitRegistratorSweep> Sweeps;
+	for (int32 i = 0; i < NumSweeps; i++)
+	{
+		const FTargetCapsule Shape = MakeRandomCapsule(Random, 1500.0f);
+		Sweeps.Add(MakeSweep(Shape.Center, Shape.Center + Random.GetUnitVector() * 300.0f, Shape.Rotation, Shape.Radius, Shape.HalfHeight));
+	}
+
+	TArray<FDBSCapsuleSweepHit> KernelHits;
+	int32 NumKernelHits = 0;
+	const double KernelStart = FPlatformTime::Seconds();
+	for (const FDBSHitRegistratorSweep& Sweep : Sweeps)
+	{
+		KernelHits.Reset();
+		FDBSCapsuleSweepKernel::SweepCapsuleAgainstCapsules(Sweep, Capsules, KernelHits);
+		NumKernelHits += KernelHits.Num();
+	}
+	const double KernelSeconds = FPlatformTime::Seconds() - KernelStart;
+
+	TArray<FHitResult> PhysicsHits;
+	int32 NumPhysicsHits = 0;
+	const double PhysicsStart = FPlatformTime::Seconds();
+	for (const FDBSHitRegistratorSweep& Sweep : Sweeps)
+	{
+		TestWorld.Sweep(Sweep, PhysicsHits);
+		NumPhysicsHits += PhysicsHits.Num();
+	}
+	const double PhysicsSeconds = FPlatformTime::Seconds() - PhysicsStart;
+
+	AddInfo(FString::Printf(TEXT("%d sweeps vs %d capsules: kernel %.2fus/sweep(%d hits), SweepMultiByChannel %.2fus/sweep(%d hits)"),
+		NumSweeps, NumTargets, KernelSeconds * 1e6 / NumSweeps, NumKernelHits, PhysicsSeconds * 1e6 / NumSweeps, NumPhysicsHits));
+	return true;
+}
+
+#endif
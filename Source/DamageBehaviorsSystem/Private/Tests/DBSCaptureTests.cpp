@@ -0,0 +1,181 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSCapture.h"
+#include "DamageBehavior.h"
+#include "DBSHitRegistratorSweep.h"
+#include "Engine/EngineTypes.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "StructUtils/InstancedStruct.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSCaptureRoundTripTest, "DamageBehaviorsSystem.Capture.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSCaptureRoundTripTest::RunTest(const FString& Parameters)
+{
+	// enough records for several chunks handed to writer thread and recycled
+	constexpr int32 NumActivations = 20000;
+
+	const FString CapturePath = FPaths::AutomationTransientDir() / TEXT("DBSCaptureRoundTrip.dbscap");
+	const FString TruncatedPath = FPaths::AutomationTransientDir() / TEXT("DBSCaptureRoundTripTruncated.dbscap");
+	if (FDBSCapture::IsCapturing())
+	{
+		AddError(TEXT("capture already running"));
+		return false;
+	}
+	if (!TestTrue(TEXT("capture started"), FDBSCapture::Start(CapturePath))) return false;
+
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	AActor* HitActor = NewObject<AActor>(GetTransientPackage());
+
+	FDBSCapture::RecordActivation(DamageBehavior, true, FInstancedStruct());
+
+	FDBSHitRegistratorSweep Sweep;
+	Sweep.Start = FVector(1.0, 2.0, 3.0);
+	Sweep.End = FVector(4.0, 5.0, 6.0);
+	Sweep.Rotation = FQuat(FVector::UpVector, 0.5);
+	Sweep.CollisionShape = FCollisionShape::MakeCapsule(10.0f, 40.0f);
+	Sweep.TraceChannel = ECC_Pawn;
+	FHitResult& HitResult = Sweep.HitResults.AddDefaulted_GetRef();
+	HitResult.HitObjectHandle = FActorInstanceHandle(HitActor);
+	HitResult.ImpactPoint = FVector(7.0, 8.0, 9.0);
+	HitResult.Time = 0.25f;
+	HitResult.bStartPenetrating = true;
+	FDBSCapture::RecordSweep(Sweep, 3);
+
+	FDBSCapture::RecordHitDecision(DamageBehavior, HitActor, EDBSCaptureHitDecision::RejectedMaxTargets);
+	for (int32 i = 0; i < NumActivations; i++)
+	{
+		FDBSCapture::RecordActivation(DamageBehavior, i % 2 == 0, FInstancedStruct());
+	}
+	FDBSCapture::Stop();
+	TestFalse(TEXT("capture stopped"), FDBSCapture::IsCapturing());
+
+	TArray<FDBSCaptureRecord> Records;
+	const bool bIsRead = FDBSCapture::ReadCapture(CapturePath, [&Records](const FDBSCaptureRecord& Record) { Records.Add(Record); });
+	if (!TestTrue(TEXT("capture read"), bIsRead)) return false;
+	// frame, behavior name, activation, hit actor name, sweep, sweep hit, decision, activations
+	if (!TestEqual(TEXT("every record read"), Records.Num(), 7 + NumActivations)) return false;
+
+	TestTrue(TEXT("frame first"), Records[0].Type == EDBSCaptureRecordType::Frame);
+	TestEqual(TEXT("frame counter"), Records[0].Frame, static_cast<uint64>(GFrameCounter));
+
+	TestTrue(TEXT("behavior name before its first record"), Records[1].Type == EDBSCaptureRecordType::Name);
+	TestEqual(TEXT("behavior path"), Records[1].Name, DamageBehavior->GetPathName(nullptr));
+	const uint32 BehaviorId = Records[1].Id;
+
+	TestTrue(TEXT("activation"), Records[2].Type == EDBSCaptureRecordType::Activation);
+	TestEqual(TEXT("activation behavior"), Records[2].BehaviorId, BehaviorId);
+	TestEqual(TEXT("null owner has id 0"), Records[2].OwnerId, 0u);
+	TestTrue(TEXT("activation active"), Records[2].bIsActive);
+	TestEqual(TEXT("empty payload hash"), Records[2].PayloadHash, 0u);
+
+	TestTrue(TEXT("hit actor name before sweep"), Records[3].Type == EDBSCaptureRecordType::Name);
+	TestEqual(TEXT("hit actor path"), Records[3].Name, HitActor->GetPathName(nullptr));
+	const uint32 HitActorId = Records[3].Id;
+
+	const FDBSCaptureRecord& SweepRecord = Records[4];
+	TestTrue(TEXT("sweep"), SweepRecord.Type == EDBSCaptureRecordType::Sweep);
+	TestEqual(TEXT("sweep window"), SweepRecord.HitRegistrationWindow, 3u);
+	TestEqual(TEXT("sweep start"), SweepRecord.Start, FVector3f(Sweep.Start));
+	TestEqual(TEXT("sweep end"), SweepRecord.End, FVector3f(Sweep.End));
+	TestTrue(TEXT("sweep rotation"), SweepRecord.Rotation.Equals(FQuat4f(Sweep.Rotation)));
+	TestEqual(TEXT("sweep shape"), SweepRecord.ShapeType, static_cast<uint8>(ECollisionShape::Capsule));
+	TestEqual(TEXT("sweep extent"), SweepRecord.ShapeExtent, FVector3f(10.0f, 10.0f, 40.0f));
+	TestEqual(TEXT("sweep channel"), SweepRecord.TraceChannel, static_cast<uint8>(ECC_Pawn));
+	TestFalse(TEXT("sweep not by hurtboxes"), SweepRecord.bByHurtboxes);
+	TestEqual(TEXT("sweep hits"), SweepRecord.NumHits, static_cast<uint16>(1));
+
+	const FDBSCaptureRecord& SweepHitRecord = Records[5];
+	TestTrue(TEXT("sweep hit"), SweepHitRecord.Type == EDBSCaptureRecordType::SweepHit);
+	TestEqual(TEXT("sweep hit actor"), SweepHitRecord.HitActorId, HitActorId);
+	TestEqual(TEXT("sweep hit without component"), SweepHitRecord.HitComponentId, 0u);
+	TestEqual(TEXT("sweep hit impact point"), SweepHitRecord.ImpactPoint, FVector3f(7.0f, 8.0f, 9.0f));
+	TestEqual(TEXT("sweep hit time"), SweepHitRecord.Time, 0.25f);
+	TestTrue(TEXT("sweep hit start penetrating"), SweepHitRecord.bStartPenetrating);
+
+	TestTrue(TEXT("hit decision"), Records[6].Type == EDBSCaptureRecordType::HitDecision);
+	TestEqual(TEXT("hit decision behavior"), Records[6].BehaviorId, BehaviorId);
+	TestEqual(TEXT("hit decision actor"), Records[6].HitActorId, HitActorId);
+	TestTrue(TEXT("hit decision value"), Records[6].Decision == EDBSCaptureHitDecision::RejectedMaxTargets);
+
+	bool bIsActivationsOrdered = true;
+	for (int32 i = 0; i < NumActivations && bIsActivationsOrdered; i++)
+	{
+		const FDBSCaptureRecord& Record = Records[7 + i];
+		bIsActivationsOrdered = Record.Type == EDBSCaptureRecordType::Activation && Record.bIsActive == (i % 2 == 0);
+	}
+	TestTrue(TEXT("activations written in order across chunks"), bIsActivationsOrdered);
+
+	// truncated tail ignored
+	TArray<uint8> Data;
+	FFileHelper::LoadFileToArray(Data, *CapturePath);
+	Data.SetNum(Data.Num() - 3);
+	FFileHelper::SaveArrayToFile(Data, *TruncatedPath);
+	int32 NumTruncatedRecords = 0;
+	TestTrue(TEXT("truncated capture read"), FDBSCapture::ReadCapture(TruncatedPath, [&NumTruncatedRecords](const FDBSCaptureRecord&) { NumTruncatedRecords++; }));
+	TestEqual(TEXT("truncated record dropped"), NumTruncatedRecords, Records.Num() - 1);
+
+	// other version rejected
+	Data[4] = static_cast<uint8>(FDBSCapture::Version + 1);
+	FFileHelper::SaveArrayToFile(Data, *TruncatedPath);
+	TestFalse(TEXT("unknown version rejected"), FDBSCapture::ReadCapture(TruncatedPath, [](const FDBSCaptureRecord&) {}));
+	TestFalse(TEXT("missing file rejected"), FDBSCapture::ReadCapture(TruncatedPath + TEXT(".missing"), [](const FDBSCaptureRecord&) {}));
+
+	IFileManager::Get().Delete(*CapturePath);
+	IFileManager::Get().Delete(*TruncatedPath);
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSCapturePayloadHashTest, "DamageBehaviorsSystem.Capture.PayloadHash",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSCapturePayloadHashTest::RunTest(const FString& Parameters)
+{
+	const FString CapturePath = FPaths::AutomationTransientDir() / TEXT("DBSCapturePayloadHash.dbscap");
+	if (FDBSCapture::IsCapturing())
+	{
+		AddError(TEXT("capture already running"));
+		return false;
+	}
+	if (!TestTrue(TEXT("capture started"), FDBSCapture::Start(CapturePath))) return false;
+
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	FCollisionProfileName PawnProfile;
+	PawnProfile.Name = TEXT("Pawn");
+	FCollisionProfileName OtherCaseProfile;
+	OtherCaseProfile.Name = TEXT("PAWN");
+	FCollisionProfileName OtherProfile;
+	OtherProfile.Name = TEXT("BlockAll");
+	FDBSCapture::RecordActivation(DamageBehavior, true, FInstancedStruct::Make(PawnProfile));
+	FDBSCapture::RecordActivation(DamageBehavior, true, FInstancedStruct::Make(OtherCaseProfile));
+	FDBSCapture::RecordActivation(DamageBehavior, true, FInstancedStruct::Make(OtherProfile));
+	FDBSCapture::Stop();
+
+	TArray<uint32> PayloadHashes;
+	FDBSCapture::ReadCapture(CapturePath, [&PayloadHashes](const FDBSCaptureRecord& Record)
+	{
+		if (Record.Type == EDBSCaptureRecordType::Activation)
+		{
+			PayloadHashes.Add(Record.PayloadHash);
+		}
+	});
+	IFileManager::Get().Delete(*CapturePath);
+	if (!TestEqual(TEXT("every activation read"), PayloadHashes.Num(), 3)) return false;
+
+	// built only from literals, same in every run whatever FName indices and object addresses are
+	const uint32 ExpectedPawnHash = HashCombine(FCrc::StrCrc32(TEXT("/Script/Engine.CollisionProfileName")), FCrc::StrCrc32(TEXT("pawn")));
+	TestEqual(TEXT("payload hash stable between runs"), PayloadHashes[0], ExpectedPawnHash);
+	TestEqual(TEXT("name case doesn't change payload hash"), PayloadHashes[1], PayloadHashes[0]);
+	TestNotEqual(TEXT("other name changes payload hash"), PayloadHashes[2], PayloadHashes[0]);
+	return true;
+}
+
+#endif
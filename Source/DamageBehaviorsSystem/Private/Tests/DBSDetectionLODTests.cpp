@@ -0,0 +1,84 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DamageBehavior.h"
+#include "DamageBehaviorsSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSDetectionLODCadenceTest, "DamageBehaviorsSystem.DetectionLOD.Cadence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSDetectionLODCadenceTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	UDamageBehaviorsSubsystem* DamageBehaviorsSubsystem = UDamageBehaviorsSubsystem::Get(World);
+	constexpr int32 ReducedInterval = 4;
+	DamageBehaviorsSubsystem->SetDetectionLODIntervalsForTests(ReducedInterval, 2);
+
+	TArray<UDamageBehavior*> DamageBehaviors;
+	for (int32 i = 0; i < ReducedInterval; i++)
+	{
+		UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(World);
+		DamageBehaviorsSubsystem->RegisterActiveBehavior(DamageBehavior);
+		DamageBehaviors.Add(DamageBehavior);
+	}
+
+	// first behavior is removed mid-run, RemoveAtSwap moves last one to its index
+	constexpr int32 NumFrames = 48;
+	constexpr int32 RemoveFrame = 17;
+	TArray<TArray<int32>> TickFrames;
+	TickFrames.SetNum(DamageBehaviors.Num());
+	bool bSpreadOverFrames = true;
+
+	const uint64 StartFrameCounter = GFrameCounter;
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		GFrameCounter++;
+		if (Frame == RemoveFrame)
+		{
+			DamageBehaviorsSubsystem->UnregisterActiveBehavior(DamageBehaviors[0]);
+		}
+
+		int32 NumTicked = 0;
+		for (int32 i = 0; i < DamageBehaviors.Num(); i++)
+		{
+			if (DamageBehaviorsSubsystem->ShouldTickAtDetectionLODForTests(DamageBehaviors[i], EDBSDetectionLOD::Reduced))
+			{
+				TickFrames[i].Add(Frame);
+				NumTicked++;
+			}
+		}
+		// one phase per behavior registered in a row, no frame ticks them together
+		bSpreadOverFrames &= NumTicked <= 1;
+	}
+	GFrameCounter = StartFrameCounter;
+
+	TestTrue(TEXT("Behaviors of same LOD spread over frames"), bSpreadOverFrames);
+	TestTrue(TEXT("Removed behavior stops ticking"), TickFrames[0].Num() > 0 && TickFrames[0].Last() < RemoveFrame);
+	for (int32 i = 1; i < DamageBehaviors.Num(); i++)
+	{
+		TestEqual(FString::Printf(TEXT("Behavior %d ticks once per interval"), i), TickFrames[i].Num(), NumFrames / ReducedInterval);
+		for (int32 j = 1; j < TickFrames[i].Num(); j++)
+		{
+			TestEqual(FString::Printf(TEXT("Behavior %d keeps cadence at frame %d"), i, TickFrames[i][j]),
+				TickFrames[i][j] - TickFrames[i][j - 1], ReducedInterval);
+		}
+	}
+	TestTrue(TEXT("Full LOD ticks every frame"), DamageBehaviorsSubsystem->ShouldTickAtDetectionLODForTests(DamageBehaviors[1], EDBSDetectionLOD::Full));
+
+	for (int32 i = 1; i < DamageBehaviors.Num(); i++)
+	{
+		DamageBehaviorsSubsystem->UnregisterActiveBehavior(DamageBehaviors[i]);
+	}
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
@@ -0,0 +1,130 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHitPolicy.h"
+#include "DamageBehavior.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitActorsSetTest, "DamageBehaviorsSystem.HitPolicy.HitActorsSet",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHitActorsSetTest::RunTest(const FString& Parameters)
+{
+	FDBSHitActorsSet Set;
+	UObject* Target = NewObject<AActor>(GetTransientPackage());
+
+	TestNull(TEXT("empty set finds nothing"), Set.Find(Target));
+	Set.Add(nullptr, 0.0, 1);
+	TestEqual(TEXT("nullptr not added"), Set.Num(), 0);
+
+	// target and actors attached to it added by one hit
+	Set.Add(Target, 1.0, 1);
+	Set.Add(Target, 1.0, 1);
+	TestEqual(TEXT("same serial counted once"), Set.Find(Target)->Hits, 1);
+	// two hits in same frame are two hits
+	Set.Add(Target, 1.0, 2);
+	TestEqual(TEXT("same time with new serial counted"), Set.Find(Target)->Hits, 2);
+	TestEqual(TEXT("one key"), Set.Num(), 1);
+
+	// growth keeps every key findable
+	TArray<UObject*> Targets;
+	for (int32 i = 0; i < 200; i++)
+	{
+		UObject* Object = Targets.Add_GetRef(NewObject<AActor>(GetTransientPackage()));
+		Set.Add(Object, 2.0, 3 + i);
+	}
+	TestEqual(TEXT("all keys added"), Set.Num(), 201);
+	for (UObject* Object : Targets)
+	{
+		const FDBSHitActorsSet::FEntry* Entry = Set.Find(Object);
+		if (!TestNotNull(TEXT("key found after growth"), Entry)) return false;
+		TestEqual(TEXT("one hit per key"), Entry->Hits, 1);
+	}
+	TestEqual(TEXT("first key survived growth"), Set.Find(Target)->Hits, 2);
+
+	// re-adding existing keys doesn't add or grow
+	for (UObject* Object : Targets)
+	{
+		Set.Add(Object, 3.0, 1000);
+	}
+	TestEqual(TEXT("existing keys not added again"), Set.Num(), 201);
+
+	int32 NumVisited = 0;
+	Set.ForEach([&NumVisited](const FDBSHitActorsSet::FEntry&) { NumVisited++; });
+	TestEqual(TEXT("ForEach visits every key"), NumVisited, 201);
+
+	// new window
+	Set.Reset();
+	TestEqual(TEXT("reset empties set"), Set.Num(), 0);
+	TestFalse(TEXT("previous window keys gone"), Set.Contains(Target));
+	NumVisited = 0;
+	Set.ForEach([&NumVisited](const FDBSHitActorsSet::FEntry&) { NumVisited++; });
+	TestEqual(TEXT("ForEach skips previous window"), NumVisited, 0);
+
+	Set.Add(Target, 4.0, 1001);
+	TestEqual(TEXT("hits start over in new window"), Set.Find(Target)->Hits, 1);
+	TestEqual(TEXT("LastHitTime updated"), Set.Find(Target)->LastHitTime, 4.0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitPolicyTest, "DamageBehaviorsSystem.HitPolicy.Policy",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHitPolicyTest::RunTest(const FString& Parameters)
+{
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	AActor* Target = NewObject<AActor>(GetTransientPackage());
+	AActor* OtherTarget = NewObject<AActor>(GetTransientPackage());
+
+	auto Hit = [DamageBehavior](AActor* Actor) { DamageBehavior->AddAcceptedHitForTests(Actor); };
+	auto NewWindow = [DamageBehavior](EDamageBehaviorHitDetectionType HitDetectionType, const FDBSHitPolicySettings& HitPolicy)
+	{
+		DamageBehavior->ClearHittedActors();
+		DamageBehavior->HitDetectionSettings.HitDetectionType = HitDetectionType;
+		DamageBehavior->HitPolicy = HitPolicy;
+	};
+
+	// defaults, target hit once per window
+	NewWindow(EDamageBehaviorHitDetectionType::ByTrace, {});
+	TestTrue(TEXT("first hit accepted"), DamageBehavior->CheckHitPolicyForTests(Target, 0.0) == EDBSHitPolicyResult::Accepted);
+	Hit(Target);
+	TestTrue(TEXT("second hit rejected"), DamageBehavior->CheckHitPolicyForTests(Target, 1.0) == EDBSHitPolicyResult::RejectedAlreadyHit);
+	TestTrue(TEXT("other target accepted"), DamageBehavior->CheckHitPolicyForTests(OtherTarget, 1.0) == EDBSHitPolicyResult::Accepted);
+
+	NewWindow(EDamageBehaviorHitDetectionType::ByTrace, {});
+	TestTrue(TEXT("target accepted in new window"), DamageBehavior->CheckHitPolicyForTests(Target, 0.0) == EDBSHitPolicyResult::Accepted);
+
+	// entering types hit on every enter, enters in same frame still count towards MaxHitsPerTarget
+	FDBSHitPolicySettings MaxHitsPolicy;
+	MaxHitsPolicy.MaxHitsPerTarget = 2;
+	NewWindow(EDamageBehaviorHitDetectionType::ByEntering, MaxHitsPolicy);
+	Hit(Target);
+	TestTrue(TEXT("second enter accepted"), DamageBehavior->CheckHitPolicyForTests(Target, 0.0) == EDBSHitPolicyResult::Accepted);
+	Hit(Target);
+	TestTrue(TEXT("third enter in same frame rejected"), DamageBehavior->CheckHitPolicyForTests(Target, 0.0) == EDBSHitPolicyResult::RejectedMaxHitsPerTarget);
+
+	FDBSHitPolicySettings ReHitPolicy;
+	ReHitPolicy.ReHitInterval = 0.5f;
+	NewWindow(EDamageBehaviorHitDetectionType::ByTrace, ReHitPolicy);
+	Hit(Target);
+	TestTrue(TEXT("re-hit inside interval rejected"), DamageBehavior->CheckHitPolicyForTests(Target, 0.2) == EDBSHitPolicyResult::RejectedReHitInterval);
+	TestTrue(TEXT("re-hit after interval accepted"), DamageBehavior->CheckHitPolicyForTests(Target, 0.6) == EDBSHitPolicyResult::Accepted);
+
+	FDBSHitPolicySettings MaxTargetsPolicy;
+	MaxTargetsPolicy.MaxTargets = 1;
+	NewWindow(EDamageBehaviorHitDetectionType::ByTrace, MaxTargetsPolicy);
+	Hit(Target);
+	TestTrue(TEXT("new target over cap rejected"), DamageBehavior->CheckHitPolicyForTests(OtherTarget, 0.0) == EDBSHitPolicyResult::RejectedMaxTargets);
+	TestFalse(TEXT("nobody can be hit again"), DamageBehavior->CanReHitTargetsForTests());
+
+	// cap reached but already hit targets still re-hit
+	MaxTargetsPolicy.ReHitInterval = 0.5f;
+	NewWindow(EDamageBehaviorHitDetectionType::ByTrace, MaxTargetsPolicy);
+	Hit(Target);
+	TestTrue(TEXT("new target over cap rejected with re-hits"), DamageBehavior->CheckHitPolicyForTests(OtherTarget, 1.0) == EDBSHitPolicyResult::RejectedMaxTargets);
+	TestTrue(TEXT("hit target re-hit over cap"), DamageBehavior->CheckHitPolicyForTests(Target, 1.0) == EDBSHitPolicyResult::Accepted);
+	return true;
+}
+
+#endif
@@ -0,0 +1,136 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DamageBehavior.h"
+#include "DBSHurtboxComponent.h"
+#include "DBSHurtboxesSubsystem.h"
+#include "SphereHitRegistrator.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/AutomationTest.h"
+#include "StructUtils/InstancedStruct.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DBSHitRegistrationAllocationsTests
+{
+	// forwards to engine allocator, counts game thread allocations while enabled
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InnerMalloc_In) : InnerMalloc(InnerMalloc_In) {}
+
+		bool bIsCounting = false;
+		int32 NumAllocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("DBSCountingMalloc"); }
+
+	private:
+		FMalloc* InnerMalloc;
+
+		void CountAllocation()
+		{
+			if (bIsCounting && IsInGameThread())
+			{
+				NumAllocations++;
+			}
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitRegistrationAllocationsTest, "DamageBehaviorsSystem.HitRegistration.Allocations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHitRegistrationAllocationsTest::RunTest(const FString& Parameters)
+{
+	using namespace DBSHitRegistrationAllocationsTests;
+
+	constexpr int32 NumWarmUpFrames = 100;
+	constexpr int32 NumHitFrames = 1000;
+	constexpr float DeltaTime = 1.0f / 30.0f;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// hurtboxes sweeps are resolved by DBS itself, so every allocation counted is plugin's own
+	AActor* Target = World->SpawnActor<AActor>();
+	UDBSHurtboxComponent* Hurtbox = NewObject<UDBSHurtboxComponent>(Target);
+	Target->SetRootComponent(Hurtbox);
+	Hurtbox->RegisterComponent();
+	UDBSHurtboxesSubsystem::Get(World)->RegisterHurtbox(Hurtbox);
+
+	AActor* Weapon = World->SpawnActor<AActor>();
+	USphereHitRegistrator* HitRegistrator = NewObject<USphereHitRegistrator>(Weapon, TEXT("Blade"));
+	HitRegistrator->SetSphereRadius(20.0f, false);
+	Weapon->SetRootComponent(HitRegistrator);
+	HitRegistrator->RegisterComponent();
+
+	// target hit again on every frame
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(Weapon);
+	DamageBehavior->HitDetectionSettings.HitDetectionType = EDamageBehaviorHitDetectionType::ByHurtboxes;
+	DamageBehavior->HitPolicy.ReHitInterval = DeltaTime * 0.5f;
+	DamageBehavior->HitRegistratorsToActivateBySource = { { DEFAULT_DAMAGE_BEHAVIOR_SOURCE, { TEXT("Blade") } } };
+	DamageBehavior->Init(Weapon, { { DEFAULT_DAMAGE_BEHAVIOR_SOURCE, Weapon, { HitRegistrator } } });
+	DamageBehavior->MakeActive(true, FInstancedStruct());
+
+	FCountingMalloc CountingMalloc(GMalloc);
+	FMalloc* EngineMalloc = GMalloc;
+	GMalloc = &CountingMalloc;
+
+	// weapon swings through target every frame
+	int32 NumFramesWithHit = 0;
+	for (int32 i = 0; i < NumWarmUpFrames + NumHitFrames; i++)
+	{
+		GFrameCounter++;
+		World->TimeSeconds += DeltaTime;
+		Weapon->SetActorLocation(FVector(i % 2 == 0 ? 100.0 : -100.0, 0.0, 0.0));
+
+		// warm up frames grow scratch buffers
+		CountingMalloc.bIsCounting = i >= NumWarmUpFrames;
+		DamageBehavior->Tick(DeltaTime);
+		CountingMalloc.bIsCounting = false;
+
+		if (i >= NumWarmUpFrames
+			&& DamageBehavior->CheckHitPolicyForTests(Target, World->GetTimeSeconds()) == EDBSHitPolicyResult::RejectedReHitInterval)
+		{
+			NumFramesWithHit++;
+		}
+	}
+
+	GMalloc = EngineMalloc;
+
+	TestEqual(TEXT("target hit on every frame"), NumFramesWithHit, NumHitFrames);
+	TestEqual(TEXT("hit frames don't allocate"), CountingMalloc.NumAllocations, 0);
+	AddInfo(FString::Printf(TEXT("%d allocations over %d hit frames"), CountingMalloc.NumAllocations, NumHitFrames));
+
+	DamageBehavior->MakeActive(false, FInstancedStruct());
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
@@ -0,0 +1,132 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "BoxHitRegistrator.h"
+#include "CapsuleHitRegistrator.h"
+#include "SphereHitRegistrator.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitRegistratorShapesTest, "DamageBehaviorsSystem.HitRegistrator.Shapes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHitRegistratorShapesTest::RunTest(const FString& Parameters)
+{
+	USphereHitRegistrator* SphereHitRegistrator = NewObject<USphereHitRegistrator>(GetTransientPackage());
+	SphereHitRegistrator->GetHitDetectionSettingsForTests().MaxSubsteps = 16;
+	SphereHitRegistrator->SetSphereRadius(10.0f, false);
+	UBoxHitRegistrator* BoxHitRegistrator = NewObject<UBoxHitRegistrator>(GetTransientPackage());
+	BoxHitRegistrator->GetHitDetectionSettingsForTests().MaxSubsteps = 16;
+	BoxHitRegistrator->SetBoxExtent(FVector(2.0f, 20.0f, 40.0f), false);
+
+	const FCollisionShape Sphere = SphereHitRegistrator->GetUnscaledShape();
+	const FCollisionShape Box = BoxHitRegistrator->GetUnscaledShape();
+	TestTrue(TEXT("sphere registrator sweeps sphere"), Sphere.IsSphere());
+	TestEqual(TEXT("sphere radius"), Sphere.GetSphereRadius(), 10.0f);
+	TestTrue(TEXT("box registrator sweeps box"), Box.IsBox());
+	TestEqual(TEXT("box extent"), Box.GetExtent(), FVector(2.0, 20.0, 40.0));
+
+	// capsule size API kept from UCapsuleComponent, half height never less than radius
+	UCapsuleHitRegistrator* CapsuleHitRegistrator = NewObject<UCapsuleHitRegistrator>(GetTransientPackage());
+	CapsuleHitRegistrator->SetCapsuleSize(10.0f, 50.0f, false);
+	CapsuleHitRegistrator->SetCapsuleRadius(20.0f, false);
+	TestEqual(TEXT("capsule radius set"), CapsuleHitRegistrator->GetUnscaledCapsuleRadius(), 20.0f);
+	TestEqual(TEXT("capsule half height kept"), CapsuleHitRegistrator->GetUnscaledCapsuleHalfHeight(), 50.0f);
+	CapsuleHitRegistrator->SetCapsuleHalfHeight(5.0f, false);
+	TestEqual(TEXT("capsule half height clamped to radius"), CapsuleHitRegistrator->GetUnscaledCapsuleHalfHeight(), 20.0f);
+	float CapsuleRadius = 0.0f;
+	float CapsuleHalfHeight = 0.0f;
+	CapsuleHitRegistrator->GetUnscaledCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+	TestTrue(TEXT("capsule shape from size"), CapsuleHitRegistrator->GetUnscaledShape().GetExtent().Equals(FVector(CapsuleRadius, CapsuleRadius, CapsuleHalfHeight)));
+
+	// rotating sphere doesn't move
+	const FTransform Origin = FTransform::Identity;
+	const FTransform HalfTurn(FQuat(FVector::XAxisVector, UE_PI));
+	TestEqual(TEXT("sphere rotating in place"), SphereHitRegistrator->CalculateSubstepsCountForTests(Origin, HalfTurn, Sphere), 1);
+
+	// box corner 44.8 away swings by 10 degrees = 7.8, thinnest side 2 per substep
+	const FTransform Turned(FQuat(FVector::XAxisVector, FMath::DegreesToRadians(10.0f)));
+	TestEqual(TEXT("box by thinnest side"), BoxHitRegistrator->CalculateSubstepsCountForTests(Origin, Turned, Box), 4);
+
+	// sphere on weapon orbiting pivot 5000 away by 10 degrees - arc deviates from chord by 19
+	const FVector Pivot(-5000.0, 0.0, 0.0);
+	const FQuat Orbit(FVector::UpVector, FMath::DegreesToRadians(10.0f));
+	const FTransform Orbited(Orbit, Pivot + Orbit.RotateVector(-Pivot));
+	TestEqual(TEXT("sphere orbiting pivot"), SphereHitRegistrator->CalculateSubstepsCountForTests(Origin, Orbited, Sphere), 2);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitRegistratorShapesBenchmark, "DamageBehaviorsSystem.HitRegistrator.ShapesBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FDBSHitRegistratorShapesBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumTargets = 128;
+	constexpr int32 NumSweeps = 2000;
+	constexpr float Extent = 1500.0f;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// same scene of character capsules for every shape
+	FRandomStream Random(11);
+	for (int32 i = 0; i < NumTargets; i++)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(Actor);
+		Capsule->SetCapsuleSize(Random.FRandRange(20.0f, 40.0f), Random.FRandRange(60.0f, 90.0f));
+		Capsule->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Capsule->SetCollisionObjectType(ECC_WorldDynamic);
+		Capsule->SetCollisionResponseToAllChannels(ECR_Overlap);
+		Capsule->SetWorldLocation(FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent)));
+		Actor->SetRootComponent(Capsule);
+		Capsule->RegisterComponent();
+	}
+
+	struct FSweepPath
+	{
+		FVector Start;
+		FVector End;
+		FQuat Rotation;
+	};
+	TArray<FSweepPath> Paths;
+	for (int32 i = 0; i < NumSweeps; i++)
+	{
+		const FVector Start(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent));
+		Paths.Add({Start, Start + Random.GetUnitVector() * 300.0f, FQuat(Random.GetUnitVector(), Random.FRandRange(0.0f, UE_PI))});
+	}
+
+	// default shapes of every registrator, all of weapon size
+	const UDBSHitRegistratorBase* HitRegistrators[] = {
+		GetDefault<USphereHitRegistrator>(),
+		GetDefault<UBoxHitRegistrator>(),
+		GetDefault<UCapsuleHitRegistrator>()
+	};
+	TArray<FHitResult> Hits;
+	for (const UDBSHitRegistratorBase* HitRegistrator : HitRegistrators)
+	{
+		const FCollisionShape CollisionShape = HitRegistrator->GetUnscaledShape();
+		int32 NumHits = 0;
+		const double Start = FPlatformTime::Seconds();
+		for (const FSweepPath& Path : Paths)
+		{
+			World->SweepMultiByChannel(Hits, Path.Start, Path.End, CollisionShape.IsSphere() ? FQuat::Identity : Path.Rotation,
+				ECC_WorldDynamic, CollisionShape);
+			NumHits += Hits.Num();
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+		AddInfo(FString::Printf(TEXT("%s: %.2fus/sweep(%d hits) over %d sweeps vs %d capsules"),
+			*HitRegistrator->GetClass()->GetName(), Seconds * 1e6 / NumSweeps, NumHits, NumSweeps, NumTargets));
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
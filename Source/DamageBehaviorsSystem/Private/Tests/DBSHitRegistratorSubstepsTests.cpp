@@ -0,0 +1,51 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "CapsuleHitRegistrator.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitRegistratorSubstepsTest, "DamageBehaviorsSystem.HitRegistrator.Substeps",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHitRegistratorSubstepsTest::RunTest(const FString& Parameters)
+{
+	UCapsuleHitRegistrator* HitRegistrator = NewObject<UCapsuleHitRegistrator>(GetTransientPackage());
+	HitRegistrator->GetHitDetectionSettingsForTests().MaxSubsteps = 16;
+
+	// radius - thickness, half height - reach
+	const FCollisionShape Capsule = FCollisionShape::MakeCapsule(10.0f, 50.0f);
+	const FTransform Origin = FTransform::Identity;
+
+	// straight movement covered by swept shape no matter how fast
+	TestEqual(TEXT("no movement"), HitRegistrator->CalculateSubstepsCountForTests(Origin, Origin, Capsule), 1);
+	TestEqual(TEXT("long straight movement single sweep"),
+		HitRegistrator->CalculateSubstepsCountForTests(Origin, FTransform(FVector(5000.0, 0.0, 0.0)), Capsule), 1);
+
+	// tip swings by 90 degrees * 50 = 78.5, radius 10 per substep
+	const FTransform Turned(FQuat(FVector::XAxisVector, UE_HALF_PI));
+	TestEqual(TEXT("rotation in place by tip travel"), HitRegistrator->CalculateSubstepsCountForTests(Origin, Turned, Capsule), 8);
+	TestEqual(TEXT("translation doesn't add substeps to rotation"),
+		HitRegistrator->CalculateSubstepsCountForTests(Origin, FTransform(Turned.GetRotation(), FVector(0.0, 0.0, 60.0)), Capsule), 8);
+
+	// origin orbiting pivot 5000 away by 10 degrees - arc deviates from chord by 19, tip swings only by 8.7
+	const FVector Pivot(-5000.0, 0.0, 0.0);
+	const FQuat Orbit(FVector::UpVector, FMath::DegreesToRadians(10.0f));
+	const FTransform Orbited(Orbit, Pivot + Orbit.RotateVector(-Pivot));
+	const int32 OrbitSubsteps = HitRegistrator->CalculateSubstepsCountForTests(Origin, Orbited, Capsule);
+	TestEqual(TEXT("arc around far pivot"), OrbitSubsteps, 2);
+	TestTrue(TEXT("arc around far pivot needs more than tip travel"), OrbitSubsteps > HitRegistrator->CalculateSubstepsCountForTests(Origin, FTransform(Orbit), Capsule));
+
+	// capped by MaxSubsteps, deferred frames keep their budgets
+	HitRegistrator->GetHitDetectionSettingsForTests().MaxSubsteps = 4;
+	const FTransform HalfTurn(FQuat(FVector::XAxisVector, UE_PI));
+	TestEqual(TEXT("capped by MaxSubsteps"), HitRegistrator->CalculateSubstepsCountForTests(Origin, HalfTurn, Capsule), 4);
+	HitRegistrator->SetNumDeferredSweepFramesForTests(1);
+	TestEqual(TEXT("deferred frame adds its budget"), HitRegistrator->CalculateSubstepsCountForTests(Origin, HalfTurn, Capsule), 8);
+	HitRegistrator->SetNumDeferredSweepFramesForTests(0);
+	HitRegistrator->GetHitDetectionSettingsForTests().MaxSubsteps = 1;
+	TestEqual(TEXT("substeps disabled"), HitRegistrator->CalculateSubstepsCountForTests(Origin, HalfTurn, Capsule), 1);
+	return true;
+}
+
+#endif
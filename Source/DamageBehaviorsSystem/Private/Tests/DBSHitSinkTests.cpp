@@ -0,0 +1,113 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "CapsuleHitRegistrator.h"
+#include "DamageBehavior.h"
+#include "DBSCapture.h"
+#include "DBSHitSink.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitSinkTest, "DamageBehaviorsSystem.HitSink.Dispatch",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHitSinkTest::RunTest(const FString& Parameters)
+{
+	UCapsuleHitRegistrator* HitRegistrator = NewObject<UCapsuleHitRegistrator>(GetTransientPackage());
+	UDamageBehavior* FirstDamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	UDamageBehavior* SecondDamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+
+	const TDBSHitSinkRef<IDBSHitSink> FirstRef(FirstDamageBehavior);
+	TestTrue(TEXT("sink resolved"), FirstRef.Get() == static_cast<IDBSHitSink*>(FirstDamageBehavior));
+	TestTrue(TEXT("same sink equal"), FirstRef == TDBSHitSinkRef<IDBSHitSink>(FirstDamageBehavior));
+	TestFalse(TEXT("other sink not equal"), FirstRef == TDBSHitSinkRef<IDBSHitSink>(SecondDamageBehavior));
+	TestNull(TEXT("empty sink"), TDBSHitSinkRef<IDBSHitSink>().Get());
+
+	HitRegistrator->AddHitSink(FirstDamageBehavior);
+	HitRegistrator->AddHitSink(FirstDamageBehavior);
+	HitRegistrator->AddHitSink(SecondDamageBehavior);
+	TestEqual(TEXT("sink added once"), HitRegistrator->GetNumHitSinksForTests(), 2);
+
+	// inactive behaviors record their rejected hits, so capture shows who was called
+	const FString CapturePath = FPaths::AutomationTransientDir() / TEXT("DBSHitSinkDispatch.dbscap");
+	if (FDBSCapture::IsCapturing())
+	{
+		AddError(TEXT("capture already running"));
+		return false;
+	}
+	if (!TestTrue(TEXT("capture started"), FDBSCapture::Start(CapturePath))) return false;
+
+	FDBSHitRegistratorHitResult HitRegistratorHitResult;
+	HitRegistratorHitResult.HitActor = NewObject<AActor>(GetTransientPackage());
+	HitRegistrator->DispatchHitForTests(HitRegistratorHitResult);
+
+	// removed and destroyed sinks are not called
+	HitRegistrator->RemoveHitSink(SecondDamageBehavior);
+	TestEqual(TEXT("sink removed"), HitRegistrator->GetNumHitSinksForTests(), 1);
+	FirstDamageBehavior->MarkAsGarbage();
+	TestNull(TEXT("sink of destroyed object"), FirstRef.Get());
+	HitRegistrator->DispatchHitForTests(HitRegistratorHitResult);
+	FDBSCapture::Stop();
+
+	TMap<uint32, FString> Names;
+	TArray<FString> HitBehaviors;
+	const bool bIsRead = FDBSCapture::ReadCapture(CapturePath, [&Names, &HitBehaviors](const FDBSCaptureRecord& Record)
+	{
+		if (Record.Type == EDBSCaptureRecordType::Name)
+		{
+			Names.Add(Record.Id, Record.Name);
+		}
+		else if (Record.Type == EDBSCaptureRecordType::HitDecision && Record.Decision == EDBSCaptureHitDecision::RejectedInactive)
+		{
+			HitBehaviors.Add(Names.FindRef(Record.BehaviorId));
+		}
+	});
+	if (!TestTrue(TEXT("capture read"), bIsRead)) return false;
+	if (!TestEqual(TEXT("each sink called once"), HitBehaviors.Num(), 2)) return false;
+	TestEqual(TEXT("first sink called"), HitBehaviors[0], FirstDamageBehavior->GetPathName(nullptr));
+	TestEqual(TEXT("second sink called"), HitBehaviors[1], SecondDamageBehavior->GetPathName(nullptr));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHitSinkBenchmark, "DamageBehaviorsSystem.HitSink.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FDBSHitSinkBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumHits = 100000;
+
+	// inactive behavior returns right away, only dispatch itself is measured
+	UCapsuleHitRegistrator* HitRegistrator = NewObject<UCapsuleHitRegistrator>(GetTransientPackage());
+	UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(GetTransientPackage());
+	FDBSHitRegistratorHitResult HitRegistratorHitResult;
+	HitRegistratorHitResult.HitActor = NewObject<AActor>(GetTransientPackage());
+
+	HitRegistrator->AddHitSink(DamageBehavior);
+	const double SinkStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		HitRegistrator->DispatchHitForTests(HitRegistratorHitResult);
+	}
+	const double SinkSeconds = FPlatformTime::Seconds() - SinkStart;
+	HitRegistrator->RemoveHitSink(DamageBehavior);
+
+	// previous path - dynamic delegate through ProcessEvent
+	FScriptDelegate HandleHitDelegate;
+	HandleHitDelegate.BindUFunction(DamageBehavior, TEXT("HandleHitInternally"));
+	HitRegistrator->OnHitRegistered.Add(HandleHitDelegate);
+	const double DelegateStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		HitRegistrator->DispatchHitForTests(HitRegistratorHitResult);
+	}
+	const double DelegateSeconds = FPlatformTime::Seconds() - DelegateStart;
+	HitRegistrator->OnHitRegistered.RemoveAll(DamageBehavior);
+
+	AddInfo(FString::Printf(TEXT("%d hits: native sink %.1fns/hit, dynamic delegate %.1fns/hit"),
+		NumHits, SinkSeconds * 1e9 / NumHits, DelegateSeconds * 1e9 / NumHits));
+	return true;
+}
+
+#endif
@@ -0,0 +1,186 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSHurtboxComponent.h"
+#include "DBSHurtboxHistory.h"
+#include "DBSHurtboxesSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHurtboxHistoryTest, "DamageBehaviorsSystem.HurtboxHistory",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSHurtboxHistoryTest::RunTest(const FString& Parameters)
+{
+	FDBSHurtboxHistory History;
+	History.Init(4, 2);
+	TArray<FTransform> Transforms;
+	Transforms.SetNum(2);
+	uint32 EnabledMask = 0;
+
+	TestFalse(TEXT("nothing to rewind before first record"), History.Rewind(0.0, Transforms, EnabledMask));
+
+	// quantization - large world origin, 1mm location and int16 rotation components
+	const FVector Origin(1000000.0, -2000000.0, 50000.0);
+	const FQuat Rotation = FQuat(FVector(1.0, 2.0, 3.0).GetSafeNormal(), 1.234);
+	TArray<FTransform> Recorded = {
+		FTransform(Rotation, Origin + FVector(123.456, -78.91, 0.04)),
+		// offsets clamped to ~32m
+		FTransform(Rotation.Inverse(), Origin + FVector(5000.0, 0.0, -5000.0)) };
+	History.Record(1.0, Origin, Recorded, 0b11);
+	if (!TestTrue(TEXT("single sample rewound"), History.Rewind(1.0, Transforms, EnabledMask))) return false;
+
+	TestTrue(TEXT("location within 1mm"), Transforms[0].GetLocation().Equals(Recorded[0].GetLocation(), 0.05));
+	TestTrue(TEXT("rotation quantized"), Transforms[0].GetRotation().AngularDistance(Rotation) < 1e-3);
+	TestTrue(TEXT("far offset clamped"), Transforms[1].GetLocation().Equals(Origin + FVector(3276.7, 0.0, -3276.8), 0.05));
+	TestTrue(TEXT("inverse rotation quantized"), Transforms[1].GetRotation().AngularDistance(Rotation.Inverse()) < 1e-3);
+	TestEqual(TEXT("enabled mask"), EnabledMask, 0b11u);
+
+	// interpolation between samples, clamped to oldest/newest
+	History.Init(4, 1);
+	Transforms.SetNum(1);
+	History.Record(1.0, FVector::ZeroVector, { FTransform(FQuat::Identity, FVector::ZeroVector) }, 0b1);
+	History.Record(2.0, FVector::ZeroVector, { FTransform(FQuat(FVector::UpVector, UE_HALF_PI), FVector(100.0, 0.0, 0.0)) }, 0b0);
+	History.Rewind(1.5, Transforms, EnabledMask);
+	TestTrue(TEXT("location interpolated"), Transforms[0].GetLocation().Equals(FVector(50.0, 0.0, 0.0), 0.05));
+	TestTrue(TEXT("rotation interpolated"), Transforms[0].GetRotation().AngularDistance(FQuat(FVector::UpVector, UE_HALF_PI * 0.5)) < 1e-3);
+	TestEqual(TEXT("disabled at any of two samples is disabled"), EnabledMask, 0u);
+	History.Rewind(0.0, Transforms, EnabledMask);
+	TestTrue(TEXT("clamped to oldest"), Transforms[0].GetLocation().Equals(FVector::ZeroVector, 0.05));
+	History.Rewind(10.0, Transforms, EnabledMask);
+	TestTrue(TEXT("clamped to newest"), Transforms[0].GetLocation().Equals(FVector(100.0, 0.0, 0.0), 0.05));
+
+	// ring buffer keeps last Capacity samples, memory fixed on Init
+	const SIZE_T AllocatedSize = History.GetAllocatedSize();
+	for (int32 i = 3; i <= 10; i++)
+	{
+		History.Record(i, FVector::ZeroVector, { FTransform(FVector(i * 10.0, 0.0, 0.0)) }, 0b1);
+	}
+	TestEqual(TEXT("capacity samples kept"), History.Num(), 4);
+	TestEqual(TEXT("oldest sample overwritten"), History.GetOldestTime(), 7.0);
+	TestEqual(TEXT("no allocations after Init"), History.GetAllocatedSize(), AllocatedSize);
+	History.Rewind(8.5, Transforms, EnabledMask);
+	TestTrue(TEXT("rewind after wrap"), Transforms[0].GetLocation().Equals(FVector(85.0, 0.0, 0.0), 0.05));
+	History.Rewind(2.0, Transforms, EnabledMask);
+	TestTrue(TEXT("overwritten time clamped to oldest kept"), Transforms[0].GetLocation().Equals(FVector(70.0, 0.0, 0.0), 0.05));
+
+	// hurtboxes count mismatch ignored
+	History.Record(11.0, FVector::ZeroVector, Recorded, 0b1);
+	TestEqual(TEXT("record with other hurtboxes count ignored"), History.Num(), 4);
+	TestFalse(TEXT("rewind with other hurtboxes count fails"), History.Rewind(8.0, Recorded, EnabledMask));
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSHurtboxHistoryBenchmark, "DamageBehaviorsSystem.HurtboxHistory.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FDBSHurtboxHistoryBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumEntries = 100;
+	constexpr int32 NumHurtboxes = 8;
+	constexpr int32 HistorySize = 64;
+	constexpr int32 NumRewinds = 1000;
+	constexpr float DeltaTime = 1.0f / 30.0f;
+
+	// history alone, every entry filled to capacity
+	TArray<FDBSHurtboxHistory> Histories;
+	Histories.SetNum(NumEntries);
+	TArray<FTransform> Transforms;
+	Transforms.SetNum(NumHurtboxes);
+	for (int32 i = 0; i < NumEntries; i++)
+	{
+		Histories[i].Init(HistorySize, NumHurtboxes);
+		for (int32 Sample = 0; Sample < HistorySize; Sample++)
+		{
+			const FVector Origin(i * 500.0, Sample * 10.0, 0.0);
+			for (int32 j = 0; j < NumHurtboxes; j++)
+			{
+				Transforms[j] = FTransform(FQuat(FVector::UpVector, Sample * 0.1), Origin + FVector(0.0, 0.0, j * 20.0));
+			}
+			Histories[i].Record(Sample * DeltaTime, Origin, Transforms, 0xFF);
+		}
+	}
+
+	uint32 EnabledMask = 0;
+	const double RewindStart = FPlatformTime::Seconds();
+	for (int32 Rewind = 0; Rewind < NumRewinds; Rewind++)
+	{
+		// between samples, both interpolated
+		const double Time = (Rewind % (HistorySize - 1) + 0.5) * DeltaTime;
+		for (const FDBSHurtboxHistory& History : Histories)
+		{
+			History.Rewind(Time, Transforms, EnabledMask);
+		}
+	}
+	const double RewindSeconds = FPlatformTime::Seconds() - RewindStart;
+
+	// same entries through subsystem, rewound snapshot rebuilt every frame
+	IConsoleVariable* CVarDBSLagCompensation = IConsoleManager::Get().FindConsoleVariable(TEXT("DamageBehaviorsSystem.LagCompensation"));
+	if (!TestNotNull(TEXT("lag compensation cvar"), CVarDBSLagCompensation)) return false;
+	const bool bWasLagCompensationEnabled = CVarDBSLagCompensation->GetBool();
+	CVarDBSLagCompensation->Set(true, ECVF_SetByCode);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	UDBSHurtboxesSubsystem* HurtboxesSubsystem = UDBSHurtboxesSubsystem::Get(World);
+
+	TArray<AActor*> Owners;
+	for (int32 i = 0; i < NumEntries; i++)
+	{
+		AActor* Owner = World->SpawnActor<AActor>();
+		USceneComponent* Root = NewObject<USceneComponent>(Owner);
+		Owner->SetRootComponent(Root);
+		Root->RegisterComponent();
+		for (int32 j = 0; j < NumHurtboxes; j++)
+		{
+			UDBSHurtboxComponent* Hurtbox = NewObject<UDBSHurtboxComponent>(Owner);
+			Hurtbox->SetupAttachment(Root);
+			Hurtbox->SetRelativeLocation(FVector(0.0, 0.0, j * 20.0));
+			Hurtbox->RegisterComponent();
+			HurtboxesSubsystem->RegisterHurtbox(Hurtbox);
+		}
+		Owners.Add(Owner);
+	}
+
+	const double StartWorldTime = World->TimeSeconds;
+	for (int32 Sample = 0; Sample < HistorySize; Sample++)
+	{
+		World->TimeSeconds = StartWorldTime + Sample * DeltaTime;
+		for (int32 i = 0; i < NumEntries; i++)
+		{
+			Owners[i]->SetActorLocationAndRotation(FVector(i * 500.0, Sample * 10.0, 0.0), FQuat(FVector::UpVector, Sample * 0.1));
+		}
+		FWorldDelegates::OnWorldPostActorTick.Broadcast(World, LEVELTICK_All, DeltaTime);
+	}
+
+	int32 NumRewoundHurtboxes = 0;
+	const uint64 StartFrameCounter = GFrameCounter;
+	const double SnapshotStart = FPlatformTime::Seconds();
+	for (int32 Rewind = 0; Rewind < NumRewinds; Rewind++)
+	{
+		// snapshots cached per frame, new frame rebuilds
+		GFrameCounter++;
+		const double Time = StartWorldTime + (Rewind % (HistorySize - 1) + 0.5) * DeltaTime;
+		NumRewoundHurtboxes = HurtboxesSubsystem->GetRewoundHurtboxesSnapshot(Time).Hurtboxes.Num();
+	}
+	const double SnapshotSeconds = FPlatformTime::Seconds() - SnapshotStart;
+	GFrameCounter = StartFrameCounter;
+
+	TestEqual(TEXT("every hurtbox rewound"), NumRewoundHurtboxes, NumEntries * NumHurtboxes);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CVarDBSLagCompensation->Set(bWasLagCompensationEnabled, ECVF_SetByCode);
+
+	AddInfo(FString::Printf(TEXT("%d entries x %d hurtboxes, %d samples: Rewind %.1fns/entry, GetRewoundHurtboxesSnapshot %.1fus/frame"),
+		NumEntries, NumHurtboxes, HistorySize, RewindSeconds * 1e9 / (NumRewinds * NumEntries), SnapshotSeconds * 1e6 / NumRewinds));
+	return true;
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DBSTimerWheel.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDBSTimerWheelTest, "DamageBehaviorsSystem.TimerWheel",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDBSTimerWheelTest::RunTest(const FString& Parameters)
+{
+	// one tick per second, 256 slots - one revolution is 256 seconds
+	TDBSTimerWheel<int32> Wheel(1.0);
+	TArray<int32> Expired;
+
+	// expires in its tick, not before
+	Wheel.Schedule(3.0, 1);
+	Wheel.Schedule(6.0, 2);
+	TestEqual(TEXT("two scheduled"), Wheel.Num(), 2);
+	Wheel.Advance(2.5, Expired);
+	TestEqual(TEXT("nothing expired before tick"), Expired.Num(), 0);
+	Wheel.Advance(3.0, Expired);
+	TestEqual(TEXT("first expired in its tick"), Expired, TArray<int32>{ 1 });
+	Expired.Reset();
+	Wheel.Advance(10.0, Expired);
+	TestEqual(TEXT("second expired"), Expired, TArray<int32>{ 2 });
+	TestEqual(TEXT("nothing scheduled"), Wheel.Num(), 0);
+
+	// scheduled in past never expires in already processed tick
+	Expired.Reset();
+	Wheel.Schedule(5.0, 3);
+	Wheel.Advance(10.0, Expired);
+	TestEqual(TEXT("processed tick not visited again"), Expired.Num(), 0);
+	Wheel.Advance(11.0, Expired);
+	TestEqual(TEXT("past timer expired next tick"), Expired, TArray<int32>{ 3 });
+
+	// longer than one revolution stays in bucket until its tick
+	Expired.Reset();
+	Wheel.Schedule(11.0 + 256.0 + 4.0, 4);
+	Wheel.Advance(11.0 + 4.0, Expired);
+	TestEqual(TEXT("same bucket one revolution earlier not expired"), Expired.Num(), 0);
+	Wheel.Advance(11.0 + 256.0 + 4.0, Expired);
+	TestEqual(TEXT("long timer expired after revolution"), Expired, TArray<int32>{ 4 });
+
+	// hitch over several revolutions - every bucket visited once, every timer expired once
+	Expired.Reset();
+	const double HitchStart = 300.0;
+	Wheel.Advance(HitchStart, Expired);
+	for (int32 i = 1; i <= 1000; i++)
+	{
+		Wheel.Schedule(HitchStart + i, i);
+	}
+	Wheel.Advance(HitchStart + 500.0, Expired);
+	TestEqual(TEXT("hitch expired timers up to its time"), Expired.Num(), 500);
+	TestEqual(TEXT("hitch kept later timers"), Wheel.Num(), 500);
+	Wheel.Advance(HitchStart + 5000.0, Expired);
+	Expired.Sort();
+	bool bIsEveryTimerOnce = Expired.Num() == 1000;
+	for (int32 i = 0; bIsEveryTimerOnce && i < Expired.Num(); i++)
+	{
+		bIsEveryTimerOnce = Expired[i] == i + 1;
+	}
+	TestTrue(TEXT("hitch expired every timer once"), bIsEveryTimerOnce);
+
+	// cancel, stale handle and serial reuse
+	Expired.Reset();
+	const double Now = HitchStart + 5000.0;
+	FDBSTimerWheelHandle Handle = Wheel.Schedule(Now + 2.0, 5);
+	const FDBSTimerWheelHandle StaleHandle = Handle;
+	Wheel.Cancel(Handle);
+	TestFalse(TEXT("cancel invalidates handle"), Handle.IsValid());
+	TestEqual(TEXT("cancelled timer not counted"), Wheel.Num(), 0);
+
+	// same entry reused with new serial, old handle doesn't cancel it
+	FDBSTimerWheelHandle ReusedHandle = Wheel.Schedule(Now + 2.0, 6);
+	TestEqual(TEXT("entry reused"), ReusedHandle.Index, StaleHandle.Index);
+	TestNotEqual(TEXT("reused entry has new serial"), ReusedHandle.Serial, StaleHandle.Serial);
+	FDBSTimerWheelHandle StaleHandleCopy = StaleHandle;
+	Wheel.Cancel(StaleHandleCopy);
+	TestEqual(TEXT("stale handle cancels nothing"), Wheel.Num(), 1);
+
+	// stale bucket reference of cancelled timer dropped, only reused one expires
+	Wheel.Advance(Now + 2.0, Expired);
+	TestEqual(TEXT("only reused timer expired"), Expired, TArray<int32>{ 6 });
+	Wheel.Cancel(ReusedHandle);
+	TestEqual(TEXT("expired timer can't be cancelled"), Wheel.Num(), 0);
+
+	// only cancelled timers left
+	Expired.Reset();
+	FDBSTimerWheelHandle CancelledHandle = Wheel.Schedule(Now + 4.0, 7);
+	Wheel.Cancel(CancelledHandle);
+	Wheel.Advance(Now + 10.0, Expired);
+	TestEqual(TEXT("cancelled timer never expires"), Expired.Num(), 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,111 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DamageBehaviorHandle.h"
+#include "DamageBehavior.h"
+#include "DamageBehaviorsComponent.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DamageBehaviorHandleTests
+{
+	const TCHAR* SlashName = TEXT("Slash");
+	const TCHAR* WeaponSourceName = TEXT("RightHand");
+
+	// actor with component holding single DamageBehavior named Slash
+	UDamageBehaviorsComponent* MakeComponentWithSlash(UDamageBehavior*& OutSlash)
+	{
+		AActor* Actor = NewObject<AActor>(GetTransientPackage());
+		UDamageBehaviorsComponent* Component = NewObject<UDamageBehaviorsComponent>(Actor);
+		OutSlash = NewObject<UDamageBehavior>(Component);
+		OutSlash->Name = SlashName;
+		Component->DamageBehaviorsList.Add(OutSlash);
+		return Component;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDamageBehaviorHandleInvalidationTest, "DamageBehaviorsSystem.DamageBehaviorsComponent.HandleInvalidation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDamageBehaviorHandleInvalidationTest::RunTest(const FString& Parameters)
+{
+	using namespace DamageBehaviorHandleTests;
+
+	UDamageBehavior* CharacterSlash = nullptr;
+	UDamageBehaviorsComponent* Character = MakeComponentWithSlash(CharacterSlash);
+	UDamageBehavior* SwordSlash = nullptr;
+	UDamageBehaviorsComponent* Sword = MakeComponentWithSlash(SwordSlash);
+	UDamageBehavior* AxeSlash = nullptr;
+	UDamageBehaviorsComponent* Axe = MakeComponentWithSlash(AxeSlash);
+	Character->SetDamageBehaviorsSourceForTests(WeaponSourceName, Sword->GetOwner());
+
+	const TArray<FName> SourcesNames = { DEFAULT_DAMAGE_BEHAVIOR_SOURCE_NAME, WeaponSourceName };
+	FDamageBehaviorHandle Handle = Character->MakeDamageBehaviorHandle(SlashName, SourcesNames);
+	TestTrue(TEXT("resolved handle valid"), Handle.IsValid());
+	TestTrue(TEXT("owner and forwarded behaviors resolved"),
+		Handle.GetResolvedDamageBehaviorsForTests() == TArray<UDamageBehavior*>({ CharacterSlash, SwordSlash }));
+
+	// InvalidateDamageBehaviorHandles of owner and of forwarded component
+	Character->InvalidateDamageBehaviorHandles();
+	TestFalse(TEXT("owner invalidated handles"), Handle.IsValid());
+	Character->InvokeDamageBehaviorByHandle(Handle, false, FInstancedStruct());
+	TestTrue(TEXT("stale handle re-resolved on invoke"), Handle.IsValid());
+	Sword->InvalidateDamageBehaviorHandles();
+	TestFalse(TEXT("forwarded component invalidated handles"), Handle.IsValid());
+	Character->InvokeDamageBehaviorByHandle(Handle, false, FInstancedStruct());
+
+	// lookup rebuild same as invalidate
+	Character->RebuildDamageBehaviorsLookup();
+	TestFalse(TEXT("lookup rebuild invalidates handles"), Handle.IsValid());
+	Character->InvokeDamageBehaviorByHandle(Handle, false, FInstancedStruct());
+
+	// source actor swapped, e.g. other weapon equipped, detected without any invalidate call
+	Character->SetDamageBehaviorsSourceForTests(WeaponSourceName, Axe->GetOwner());
+	TestFalse(TEXT("source actor swapped"), Handle.IsValid());
+	Character->InvokeDamageBehaviorByHandle(Handle, false, FInstancedStruct());
+	TestTrue(TEXT("swapped source resolved"),
+		Handle.GetResolvedDamageBehaviorsForTests() == TArray<UDamageBehavior*>({ CharacterSlash, AxeSlash }));
+
+	// source actor unequipped
+	Character->SetDamageBehaviorsSourceForTests(WeaponSourceName, nullptr);
+	TestFalse(TEXT("source actor gone"), Handle.IsValid());
+	Character->InvokeDamageBehaviorByHandle(Handle, false, FInstancedStruct());
+	TestTrue(TEXT("source without component resolved"), Handle.IsValid());
+	TestTrue(TEXT("only owner behavior resolved"), Handle.GetResolvedDamageBehaviorsForTests() == TArray<UDamageBehavior*>({ CharacterSlash }));
+
+	// handle made by other component resolved again for invoking one
+	UDamageBehavior* OtherCharacterSlash = nullptr;
+	UDamageBehaviorsComponent* OtherCharacter = MakeComponentWithSlash(OtherCharacterSlash);
+	FDamageBehaviorHandle OtherHandle = OtherCharacter->MakeDamageBehaviorHandle(SlashName, {});
+	TestTrue(TEXT("handle of other component valid by itself"), OtherHandle.IsValid());
+	Character->InvokeDamageBehaviorByHandle(OtherHandle, false, FInstancedStruct());
+	TestTrue(TEXT("handle moved to invoking component"), OtherHandle.GetOwnerComponentForTests() == Character);
+	TestTrue(TEXT("behavior of invoking component resolved"), OtherHandle.GetResolvedDamageBehaviorsForTests() == TArray<UDamageBehavior*>({ CharacterSlash }));
+
+	// forwarded component destroyed
+	Character->SetDamageBehaviorsSourceForTests(WeaponSourceName, Sword->GetOwner());
+	Character->InvokeDamageBehaviorByHandle(Handle, false, FInstancedStruct());
+	TestTrue(TEXT("handle valid before forwarded component destroyed"), Handle.IsValid());
+	Sword->MarkAsGarbage();
+	TestFalse(TEXT("forwarded component destroyed"), Handle.IsValid());
+
+	// resolved DamageBehavior destroyed
+	FDamageBehaviorHandle AxeHandle = Axe->MakeDamageBehaviorHandle(SlashName, {});
+	TestTrue(TEXT("handle valid before behavior destroyed"), AxeHandle.IsValid());
+	AxeSlash->MarkAsGarbage();
+	TestFalse(TEXT("resolved behavior destroyed"), AxeHandle.IsValid());
+
+	// owner component destroyed
+	FDamageBehaviorHandle OtherCharacterHandle = OtherCharacter->MakeDamageBehaviorHandle(SlashName, {});
+	TestTrue(TEXT("handle valid before owner destroyed"), OtherCharacterHandle.IsValid());
+	OtherCharacter->MarkAsGarbage();
+	TestFalse(TEXT("owner component destroyed"), OtherCharacterHandle.IsValid());
+
+	Handle.Reset();
+	TestFalse(TEXT("reset handle invalid"), Handle.IsValid());
+	TestTrue(TEXT("reset handle has no name"), Handle.GetDamageBehaviorName().IsNone());
+	return true;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#include "DamageBehaviorsComponent.h"
+#include "DamageBehavior.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Guid.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDamageBehaviorsComponentLookupTest, "DamageBehaviorsSystem.DamageBehaviorsComponent.NamesLookup",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDamageBehaviorsComponentLookupTest::RunTest(const FString& Parameters)
+{
+	UDamageBehaviorsComponent* Component = NewObject<UDamageBehaviorsComponent>(GetTransientPackage());
+	auto AddDamageBehavior = [Component](const FString& Name)
+	{
+		UDamageBehavior* DamageBehavior = NewObject<UDamageBehavior>(Component);
+		DamageBehavior->Name = Name;
+		Component->DamageBehaviorsList.Add(DamageBehavior);
+		return DamageBehavior;
+	};
+
+	UDamageBehavior* Slash = AddDamageBehavior(TEXT("Slash"));
+	UDamageBehavior* Thrust = AddDamageBehavior(TEXT("Thrust"));
+	AddDamageBehavior(TEXT("Slash"));
+	AddDamageBehavior(TEXT(""));
+	Component->DamageBehaviorsList.Add(nullptr);
+
+	// before BeginPlay(editor preview actors) names searched linearly
+	TestEqual(TEXT("linear search by FName"), Component->GetDamageBehaviorByName(TEXT("Thrust")), Thrust);
+	TestEqual(TEXT("linear search by string"), Component->GetDamageBehavior(TEXT("Slash")), Slash);
+
+	const uint32 HandlesSerial = Component->GetDamageBehaviorHandlesSerial();
+	Component->RebuildDamageBehaviorsLookup();
+	TestNotEqual(TEXT("rebuild invalidates handles"), Component->GetDamageBehaviorHandlesSerial(), HandlesSerial);
+
+	// interned lookup gives same results as linear search
+	TestEqual(TEXT("lookup by FName"), Component->GetDamageBehaviorByName(TEXT("Thrust")), Thrust);
+	TestEqual(TEXT("first of duplicated names wins"), Component->GetDamageBehaviorByName(TEXT("Slash")), Slash);
+	TestEqual(TEXT("lookup by string"), Component->GetDamageBehavior(TEXT("Slash")), Slash);
+	TestEqual(TEXT("case insensitive same as FString compare"), Component->GetDamageBehavior(TEXT("slash")), Slash);
+	TestNull(TEXT("None not found"), Component->GetDamageBehaviorByName(NAME_None));
+	TestNull(TEXT("empty string not found"), Component->GetDamageBehavior(TEXT("")));
+
+	// unknown strings resolved with FNAME_Find, names table not grown by lookups
+	const FString UnknownName = FGuid::NewGuid().ToString();
+	TestNull(TEXT("unknown string not found"), Component->GetDamageBehavior(UnknownName));
+	Component->InvokeDamageBehavior(UnknownName, true, { UnknownName }, FInstancedStruct());
+	TestTrue(TEXT("unknown string not interned"), FName(*UnknownName, FNAME_Find).IsNone());
+
+	// runtime changes of list visible after rebuild only
+	UDamageBehavior* Kick = AddDamageBehavior(TEXT("Kick"));
+	TestNull(TEXT("added behavior not in lookup yet"), Component->GetDamageBehaviorByName(TEXT("Kick")));
+	Component->RebuildDamageBehaviorsLookup();
+	TestEqual(TEXT("added behavior found after rebuild"), Component->GetDamageBehaviorByName(TEXT("Kick")), Kick);
+	return true;
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "DamageBehaviorsComponent.h"
+#include "DBSBakedTrajectory.h"
 #include "Animation/AnimNotifies/AnimNotifyState.h"
 #include "ANS_InvokeDamageBehavior.generated.h"
 
@@ -29,8 +30,8 @@ struct FDBSDebugActor
 
 	bool IsValid() const { return ActorCDO.IsValid(); }
 
-	TArray<TWeakObjectPtr<UCapsuleHitRegistrator>> HitRegistrators;
-	TMap<TWeakObjectPtr<UCapsuleHitRegistrator>, FName> HitRegistratorsToAttachSocketsList = {};
+	TArray<TWeakObjectPtr<UDBSHitRegistratorBase>> HitRegistrators;
+	TMap<TWeakObjectPtr<UDBSHitRegistratorBase>, FName> HitRegistratorsToAttachSocketsList = {};
 	TWeakObjectPtr<AActor> ActorCDO;
 	TWeakObjectPtr<UDamageBehaviorsComponent> DBC;
 };
@@ -69,6 +70,12 @@ struct FDBSDebugHitRegistratorDescription
 {
 	GENERATED_BODY()
 
+	UPROPERTY()
+	FString SourceName;
+	// name from "HitRegistrators to Activate"
+	UPROPERTY()
+	FString HitRegistratorName;
+
 	UPROPERTY()
 	FName SocketNameAttached = "";
 
@@ -81,6 +88,12 @@ struct FDBSDebugHitRegistratorDescription
 	float CapsuleRadius = 0.0f;
 	UPROPERTY()
 	float CapsuleHalfHeight = 0.0f;
+	// box registrators drawn with BoxExtent, CapsuleHalfHeight keeps extent Z for labels.
+	// Sphere described as capsule with HalfHeight == Radius
+	UPROPERTY()
+	bool bIsBox = false;
+	UPROPERTY()
+	FVector BoxExtent = FVector::ZeroVector;
 
 	UPROPERTY()
 	FLinearColor Color = FLinearColor(1.0f, 0.491021f, 0.0f);
@@ -125,6 +138,22 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Default")
 	FInstancedStruct Payload;
 
+	// HitRegistrators trajectories of this window, baked on montage save/cook(settings "bBakeHitWindows")
+	UPROPERTY(VisibleAnywhere, Category="Baked")
+	FDBSBakedHitWindow BakedHitWindow;
+
+	// HitRegistrators this window activates on preview DebugActors of Mesh(settings "DefaultDebugActorsForPreview"),
+	// false if there are no DebugActors for mesh
+	bool GatherHitRegistratorsDescriptions(const USkeletalMesh* Mesh, TArray<FDBSDebugActor>& DebugActors,
+		TArray<FDBSDebugHitRegistratorDescription>& OutDescriptions) const;
+
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+
 private:
 	UPROPERTY()
 	TArray<FDBSDebugActor> FilledDebugActors;
@@ -132,9 +161,19 @@ private:
 	UPROPERTY()
 	TMap<FString, FDBSDebugHitRegistratorDescription> HitRegistratorsDescription = {};
 
-	FDBSDebugActor GetFilledDebugActor(FString SourceName);
+	// Name and enabled TargetSources as FNames, so invoke doesn't build them every time.
+	// Refreshed on load and edit, notify is shared asset so they aren't changed at runtime
+	FName CachedName;
+	TArray<FName> CachedSourcesNames;
+	void CacheNames();
+
+	static FDBSDebugActor GetFilledDebugActor(TArray<FDBSDebugActor>& DebugActors, FString SourceName);
+	// enabled ByTrace/ByHurtboxes HitRegistrators follow BakedHitWindow instead of animated pose
+	void ApplyBakedHitWindow(UDamageBehaviorsComponent* DamageBehaviorsComponent, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) const;
 
 	void DrawCapsules(UWorld* WorldContextObject, USkeletalMeshComponent* MeshComp);
 
 	TArray<FString> GetDamageBehaviorSourcesList() const;
+	// runtime invoke goes through FName lookups of UDamageBehaviorsComponent
+	TArray<FName> GetDamageBehaviorSourcesNames() const;
 };
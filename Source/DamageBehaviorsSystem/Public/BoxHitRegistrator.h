@@ -0,0 +1,30 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DBSHitRegistratorBase.h"
+#include "BoxHitRegistrator.generated.h"
+
+/**
+ * Box HitRegistrator - shields, wide blades, slams.
+ * Substeps counted by thinnest box side, so keep flat boxes for slow swings
+ */
+UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
+class DAMAGEBEHAVIORSSYSTEM_API UBoxHitRegistrator : public UDBSHitRegistratorBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual FCollisionShape GetUnscaledShape() const override;
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void SetBoxExtent(FVector BoxExtent_In, bool bUpdateOverlaps = true);
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	FVector GetScaledBoxExtent() const { return BoxExtent * GetComponentTransform().GetScale3D().GetAbs(); }
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Shape", meta=(ClampMin="0", UIMin="0"))
+	FVector BoxExtent = FVector(5.0f, 5.0f, 44.0f);
+};
@@ -3,86 +3,56 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "DamageBehaviorsSystemTypes.h"
-#include "Components/CapsuleComponent.h"
+#include "DBSHitRegistratorBase.h"
 #include "CapsuleHitRegistrator.generated.h"
 
-USTRUCT(BlueprintType)
-struct FDBSHitRegistratorHitResult
-{
-	GENERATED_BODY()
-
-public:
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TWeakObjectPtr<AActor> HitActor = nullptr;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FHitResult HitResult;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FVector Direction = FVector::ZeroVector;
-	// Default instigator is Character that owns CapsuleHitRegistrator,
-	// but don't forget to override it if needed
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TWeakObjectPtr<AActor> Instigator = nullptr;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TEnumAsByte<EPhysicalSurface> PhysicalSurfaceType = EPhysicalSurface::SurfaceType_Default;
-};
-
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHitRegistered,
-	const FDBSHitRegistratorHitResult&, HitRegistratorHitResult,
-	class UCapsuleHitRegistrator*, CapsuleHitRegistrator
-);
-
 /**
- *
+ * Capsule HitRegistrator, default choice for weapons
  */
 UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
-class DAMAGEBEHAVIORSSYSTEM_API UCapsuleHitRegistrator : public UCapsuleComponent
+class DAMAGEBEHAVIORSSYSTEM_API UCapsuleHitRegistrator : public UDBSHitRegistratorBase
 {
 	GENERATED_BODY()
 
 public:
-    UCapsuleHitRegistrator();
+	virtual FCollisionShape GetUnscaledShape() const override;
+
+	// capsule API of UCapsuleComponent registrator was derived from, same names so Blueprints keep working
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void SetCapsuleSize(float Radius_In, float HalfHeight_In, bool bUpdateOverlaps = true);
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void SetCapsuleRadius(float Radius_In, bool bUpdateOverlaps = true) { SetCapsuleSize(Radius_In, CapsuleHalfHeight, bUpdateOverlaps); }
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void SetCapsuleHalfHeight(float HalfHeight_In, bool bUpdateOverlaps = true) { SetCapsuleSize(CapsuleRadius, HalfHeight_In, bUpdateOverlaps); }
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	float GetScaledCapsuleRadius() const { return CapsuleRadius * GetComponentTransform().GetMinimumAxisScale(); }
+	// includes radius
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	float GetScaledCapsuleHalfHeight() const { return CapsuleHalfHeight * GetComponentTransform().GetMinimumAxisScale(); }
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void GetScaledCapsuleSize(float& OutRadius, float& OutHalfHeight) const
+	{
+		OutRadius = GetScaledCapsuleRadius();
+		OutHalfHeight = GetScaledCapsuleHalfHeight();
+	}
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	float GetUnscaledCapsuleRadius() const { return CapsuleRadius; }
+	// includes radius
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	float GetUnscaledCapsuleHalfHeight() const { return CapsuleHalfHeight; }
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void GetUnscaledCapsuleSize(float& OutRadius, float& OutHalfHeight) const
+	{
+		OutRadius = CapsuleRadius;
+		OutHalfHeight = CapsuleHalfHeight;
+	}
 
-	UPROPERTY(BlueprintAssignable)
-    FOnHitRegistered OnHitRegistered;
-
-    UFUNCTION(BlueprintCallable)
-    void SetIsHitRegistrationEnabled(bool bIsEnabled_In, FDamageBehaviorHitDetectionSettings HitDetectionSettings);
-    // probably with multitrace its not required to ignore some actors
-    UFUNCTION(BlueprintCallable)
-    void AddActorsToIgnoreList(const TArray<AActor*>& Actors_In);
-
-	UFUNCTION(BlueprintCallable)
-	float GetLineThickness() const { return LineThickness; };
-
-	void TickHitRegistration(float DeltaTime);
-	bool IsHitRegistrationEnabled() const { return bIsHitRegistrationEnabled; }
-	EDamageBehaviorHitDetectionType GetHitDetectionType() const { return CurrentHitDetectionSettings.HitDetectionType; }
-	
 protected:
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Melee hit registration")
-    bool bIsHitRegistrationEnabled = false;
-
-private:
-    FVector PreviousComponentLocation = FVector::ZeroVector;
-	FDamageBehaviorHitDetectionSettings CurrentHitDetectionSettings;
-    UPROPERTY()
-    TArray<AActor*> IgnoredActors;
-
-	void ProcessHitRegistration();
-	UFUNCTION()
-	void OnBegingOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-	UFUNCTION()
-	void OnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
-
-	void OnDebugCategoryChanged(IConsoleVariable* Var);
-	void UpdateCapsuleVisibility(bool bIsVisible_In);
-
-	// full copy of UnrealHelperLibrary TraceUtils function
-	static bool SweepCapsuleMultiByChannel(const UWorld* World, TArray<FHitResult>& OutHits, const FVector& Start,
-		const FVector& End, float Radius, float HalfHeight, const FQuat& Rot,
-		ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
-		const FCollisionResponseParams& ResponseParam, bool bDrawDebug = false,
-		float DrawTime = -1.0f, FColor TraceColor = FColor::Black,
-		FColor HitColor = FColor::Red, float FailDrawTime = -1.0f);
+	// same names as UCapsuleComponent had, so existing assets keep their sizes
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Shape", meta=(ClampMin="0", UIMin="0"))
+	float CapsuleHalfHeight = 44.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Shape", meta=(ClampMin="0", UIMin="0"))
+	float CapsuleRadius = 5.0f;
 };
@@ -0,0 +1,62 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DBSHitRegistratorBase.h"
+#include "ChainHitRegistrator.generated.h"
+
+USTRUCT(BlueprintType)
+struct FDBSChainHitRegistratorSegment
+{
+	GENERATED_BODY()
+
+	// relative to HitRegistrator
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector Location = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FRotator Rotation = FRotator::ZeroRotator;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
+	float CapsuleRadius = 5.0f;
+	// includes radius
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
+	float CapsuleHalfHeight = 20.0f;
+};
+
+/**
+ * Compound HitRegistrator - chain of capsules along long weapon(greatsword, halberd, whip tail)
+ * in one component instead of separate UCapsuleHitRegistrator per part.
+ * One transform update and one tick for whole chain, segments swept as one batch and
+ * target touched by several segments in same frame is hit once
+ */
+UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
+class DAMAGEBEHAVIORSSYSTEM_API UChainHitRegistrator : public UDBSHitRegistratorBase
+{
+	GENERATED_BODY()
+
+public:
+	// sphere around component origin enclosing all segments
+	virtual FCollisionShape GetUnscaledShape() const override;
+	virtual TConstArrayView<FDBSHitRegistratorSegment> GetSegments() const override { return CachedSegments; }
+	virtual void UpdateBodySetup() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void SetSegments(const TArray<FDBSChainHitRegistratorSegment>& Segments_In);
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	const TArray<FDBSChainHitRegistratorSegment>& GetChainSegments() const { return Segments; }
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Shape")
+	TArray<FDBSChainHitRegistratorSegment> Segments;
+
+	virtual void OnRegister() override;
+
+private:
+	// Segments converted once, read every sweep
+	TArray<FDBSHitRegistratorSegment> CachedSegments;
+
+	void RebuildCachedSegments();
+};
@@ -0,0 +1,85 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DBSBakedTrajectory.generated.h"
+
+class UAnimInstance;
+class UAnimMontage;
+class UANS_InvokeDamageBehavior;
+class USkeletalMeshComponent;
+
+// HitRegistrator transform in skeletal mesh component space sampled over hit window,
+// keys that could be interpolated from neighbours within tolerance are dropped on bake
+USTRUCT()
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSBakedTrajectoryTrack
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString SourceName;
+	// same as in "HitRegistrators to Activate"
+	UPROPERTY()
+	FString HitRegistratorName;
+
+	// seconds from window start, ascending
+	UPROPERTY()
+	TArray<float> KeyTimes;
+	UPROPERTY()
+	TArray<FVector3f> KeyLocations;
+	UPROPERTY()
+	TArray<FQuat4f> KeyRotations;
+
+	// clamped to first/last key
+	FTransform Evaluate(float Time) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FDBSBakedTrajectoryTrack& Track);
+};
+
+// all HitRegistrators trajectories of one UANS_InvokeDamageBehavior window in montage
+USTRUCT()
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSBakedHitWindow
+{
+	GENERATED_BODY()
+
+	// montage position of window start
+	UPROPERTY()
+	float StartTime = 0.0f;
+	UPROPERTY()
+	float Duration = 0.0f;
+	UPROPERTY()
+	TArray<FDBSBakedTrajectoryTrack> Tracks;
+
+#if WITH_EDITORONLY_DATA
+	// DDC key of baked data, bake skipped while inputs unchanged
+	UPROPERTY()
+	FString BakeKey;
+#endif
+
+	bool IsValid() const { return !Tracks.IsEmpty(); }
+	const FDBSBakedTrajectoryTrack* FindTrack(const FString& SourceName, const FString& HitRegistratorName) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FDBSBakedHitWindow& HitWindow);
+};
+
+// baked window driving HitRegistrator instead of its animated component transform
+struct FDBSBakedTrajectoryPlayback
+{
+	const FDBSBakedTrajectoryTrack* Track = nullptr;
+	// owner of Track data
+	TWeakObjectPtr<const UAnimMontage> Montage = nullptr;
+	TWeakObjectPtr<UAnimInstance> AnimInstance = nullptr;
+	TWeakObjectPtr<const USkeletalMeshComponent> MeshComponent = nullptr;
+	float WindowStartTime = 0.0f;
+
+	bool IsActive() const { return Track != nullptr; }
+	void Reset() { *this = FDBSBakedTrajectoryPlayback(); }
+	// false if montage/mesh gone, OutTransform in world space
+	bool Evaluate(FTransform& OutTransform) const;
+};
+
+// bakes window of ANS into HitWindow, bound by DBSEditor module. False - nothing to bake
+DECLARE_DELEGATE_RetVal_TwoParams(bool, FDBSBakeHitWindow, const UANS_InvokeDamageBehavior* /*InvokeDamageBehavior*/, FDBSBakedHitWindow& /*HitWindow*/);
+
+DAMAGEBEHAVIORSSYSTEM_API FDBSBakeHitWindow& DBS_GetBakeHitWindowDelegate();
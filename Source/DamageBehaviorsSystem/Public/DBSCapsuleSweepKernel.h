@@ -0,0 +1,76 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionShape.h"
+#include "Engine/HitResult.h"
+
+struct FDBSHitRegistratorSweep;
+
+// Target capsules stored structure-of-arrays for FDBSCapsuleSweepKernel.
+// Positions kept in floats relative to Origin, so choose Origin near the sweeps(e.g. attacker location).
+// Arrays padded to multiple of 4 with capsules that can never be hit
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSCapsulesSoA
+{
+	FVector Origin = FVector::ZeroVector;
+
+	TArray<float> CenterX;
+	TArray<float> CenterY;
+	TArray<float> CenterZ;
+	// half of capsule segment(without hemispheres) along capsule up axis
+	TArray<float> SegmentX;
+	TArray<float> SegmentY;
+	TArray<float> SegmentZ;
+	TArray<float> Radius;
+
+	// keeps allocations
+	void Reset(const FVector& Origin_In);
+	// HalfHeight includes radius same as UCapsuleComponent, returns index of capsule
+	int32 Add(const FVector& Center, const FQuat& Rotation, float Radius_In, float HalfHeight);
+
+	int32 Num() const { return NumCapsules; }
+	int32 NumPadded() const { return Radius.Num(); }
+
+private:
+	int32 NumCapsules = 0;
+};
+
+struct FDBSCapsuleSweepHit
+{
+	// index in FDBSCapsulesSoA
+	int32 TargetIndex = INDEX_NONE;
+	// 0..1 along sweep, same as FHitResult::Time
+	float Time = 0.0f;
+	// swept capsule center at Time
+	FVector Location = FVector::ZeroVector;
+	FVector ImpactPoint = FVector::ZeroVector;
+	// points from target to swept capsule
+	FVector ImpactNormal = FVector::ZeroVector;
+	bool bStartPenetrating = false;
+};
+
+/**
+ * Swept capsule vs N capsules narrowphase without physics scene, 4 targets per SIMD register.
+ * Sweep translates from Start to End keeping Rotation, same as SweepMultiByChannel with capsule shape.
+ * Time of impact found by conservative advancement on segment-segment distance, which is exact
+ * for translating convex shapes, hits closer than Tolerance are counted as touching.
+ * Targets not resolved in MaxIterations(grazing sweeps) are resolved by searching minimum of distance
+ * over rest of sweep, FallbackIterations steps of ternary search and bisection.
+ * Padding lanes have -UE_BIG_NUMBER radius, their first step moves T far past 1
+ */
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSCapsuleSweepKernel
+{
+	static constexpr int32 MaxIterations = 32;
+	static constexpr int32 FallbackIterations = 32;
+	static constexpr float Tolerance = 0.1f;
+
+	// uses Start, End, Rotation and CollisionShape of Sweep, OutHits sorted by Time
+	static void SweepCapsuleAgainstCapsules(const FDBSHitRegistratorSweep& Sweep, const FDBSCapsulesSoA& Targets, TArray<FDBSCapsuleSweepHit>& OutHits);
+
+	// capsule enclosing sphere or box, capsule returned as is
+	static FCollisionShape MakeSweepCapsule(const FCollisionShape& CollisionShape);
+
+	// fills geometry part of FHitResult, actor/component of target should be set by caller
+	static void MakeHitResult(const FDBSHitRegistratorSweep& Sweep, const FDBSCapsuleSweepHit& SweepHit, FHitResult& OutHitResult);
+};
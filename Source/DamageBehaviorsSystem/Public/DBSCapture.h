@@ -0,0 +1,106 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UDamageBehavior;
+struct FDBSHitRegistratorSweep;
+struct FInstancedStruct;
+
+enum class EDBSCaptureRecordType : uint8
+{
+	// frame of all following records
+	Frame,
+	// id -> object path, written once before first record referencing the id
+	Name,
+	Activation,
+	Sweep,
+	// raw hit of preceding Sweep
+	SweepHit,
+	HitDecision,
+};
+
+enum class EDBSCaptureHitDecision : uint8
+{
+	Accepted,
+	RejectedInactive,
+	RejectedInvalidActor,
+	RejectedAlreadyHit,
+	RejectedByProcessHit,
+	RejectedReHitInterval,
+	RejectedMaxHitsPerTarget,
+	RejectedMaxTargets,
+};
+
+// decoded record for tools, only fields of record Type are filled
+struct FDBSCaptureRecord
+{
+	EDBSCaptureRecordType Type = EDBSCaptureRecordType::Frame;
+
+	// Frame
+	uint64 Frame = 0;
+	double WorldTime = 0.0;
+
+	// Name
+	uint32 Id = 0;
+	FString Name;
+
+	// Activation, HitDecision
+	uint32 BehaviorId = 0;
+	uint32 OwnerId = 0;
+	bool bIsActive = false;
+	uint32 PayloadHash = 0;
+	uint32 HitActorId = 0;
+	EDBSCaptureHitDecision Decision = EDBSCaptureHitDecision::Accepted;
+
+	// Sweep
+	uint32 HitRegistratorId = 0;
+	uint32 HitRegistrationWindow = 0;
+	FVector3f Start = FVector3f::ZeroVector;
+	FVector3f End = FVector3f::ZeroVector;
+	FQuat4f Rotation = FQuat4f::Identity;
+	// ECollisionShape::Type, ShapeExtent - FCollisionShape::GetExtent(capsule - radius, radius, half height)
+	uint8 ShapeType = 0;
+	FVector3f ShapeExtent = FVector3f::ZeroVector;
+	uint8 TraceChannel = 0;
+	bool bByHurtboxes = false;
+	uint16 NumHits = 0;
+
+	// SweepHit, hit actor in HitActorId
+	uint32 HitComponentId = 0;
+	FVector3f ImpactPoint = FVector3f::ZeroVector;
+	float Time = 0.0f;
+	bool bStartPenetrating = false;
+};
+
+/**
+ * Binary capture of hit pipeline for forensics and diffing between builds("DamageBehaviorsSystem.Capture").
+ * Game thread appends fixed-size records to in-memory chunk, full chunks are handed
+ * to writer thread which appends them to Saved/DamageBehaviorsSystem/Captures/*.dbscap,
+ * chunks are recycled so steady state capture doesn't allocate.
+ * Convert to CSV/JSON with "-run=DBSCaptureConvert"
+ */
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSCapture
+{
+	static constexpr uint32 Magic = 0x43534244; // "DBSC"
+	static constexpr uint32 Version = 1;
+
+	// game thread only, empty FilePath - new file in Saved/DamageBehaviorsSystem/Captures
+	static bool Start(const FString& FilePath = FString());
+	// flushes everything captured, blocks until writer thread finished
+	static void Stop();
+	static bool IsCapturing() { return bIsCapturing; }
+
+	// call only while IsCapturing
+	static void RecordActivation(const UDamageBehavior* DamageBehavior, bool bIsActive, const FInstancedStruct& Payload);
+	static void RecordSweep(const FDBSHitRegistratorSweep& Sweep, uint32 HitRegistrationWindow);
+	static void RecordHitDecision(const UDamageBehavior* DamageBehavior, const AActor* HitActor, EDBSCaptureHitDecision Decision);
+
+	// false if file missing or not a capture of known version, truncated tail is ignored
+	static bool ReadCapture(const FString& FilePath, TFunctionRef<void(const FDBSCaptureRecord&)> Visitor);
+
+private:
+	static bool bIsCapturing;
+};
@@ -0,0 +1,89 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "DBSHitPolicy.generated.h"
+
+// which hits DamageBehavior accepts during one window(MakeActive true -> false)
+USTRUCT(BlueprintType)
+struct FDBSHitPolicySettings
+{
+	GENERATED_BODY()
+
+	// 0 - target hit once per window(ByEntering/ByOverlapQuery/WhileStandingInside - on every enter),
+	// otherwise target hit again after interval while window active, e.g. drills
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="DamageBehavior", meta=(ClampMin=0, Units="Seconds"))
+	float ReHitInterval = 0.0f;
+
+	// 0 - unlimited
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="DamageBehavior", meta=(ClampMin=0))
+	int32 MaxHitsPerTarget = 0;
+
+	// cleave cap, 0 - unlimited. New targets rejected once reached, if targets can't be hit again
+	// ticked HitRegistrators stop sweeping until window ends. Hit registration stays enabled,
+	// overlap events of entering types still come and are rejected before any lookup
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="DamageBehavior", meta=(ClampMin=0))
+	int32 MaxTargets = 0;
+};
+
+enum class EDBSHitPolicyResult : uint8
+{
+	Accepted,
+	RejectedAlreadyHit,
+	RejectedReHitInterval,
+	RejectedMaxHitsPerTarget,
+	RejectedMaxTargets,
+};
+
+/**
+ * Actors hit during current window. Open addressing set with linear probing keyed by FObjectKey
+ * (object index + serial number, no weak pointer resolve on lookup).
+ * Slots of previous windows recognized by Generation, so Reset is O(1) and keeps memory
+ */
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSHitActorsSet
+{
+	struct FEntry
+	{
+		FObjectKey Key;
+		uint32 Generation = 0;
+		int32 Hits = 0;
+		uint32 LastHitSerial = 0;
+		double LastHitTime = 0.0;
+	};
+
+	// nullptr if Object not hit in current window
+	const FEntry* Find(const UObject* Object) const;
+	bool Contains(const UObject* Object) const { return Find(Object) != nullptr; }
+	// adds Object or increments its Hits. Every accepted hit has own HitSerial, adds with same
+	// HitSerial counted once(target and actors attached to it added by one hit)
+	void Add(const UObject* Object, double Time, uint32 HitSerial);
+	void Reset();
+
+	int32 Num() const { return NumEntries; }
+
+	template<typename FuncType>
+	void ForEach(FuncType Func) const
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			if (Entry.Generation == Generation)
+			{
+				Func(Entry);
+			}
+		}
+	}
+
+private:
+	static constexpr int32 MinCapacity = 16;
+
+	TArray<FEntry> Entries;
+	// 0 is never used, zeroed slots are free
+	uint32 Generation = 1;
+	int32 NumEntries = 0;
+
+	// index of slot with Key, or free slot where Key should be added
+	int32 FindSlot(const FObjectKey& Key) const;
+	void Grow();
+};
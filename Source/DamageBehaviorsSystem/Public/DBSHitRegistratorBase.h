@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DamageBehaviorsSystemTypes.h"
+#include "DBSBakedTrajectory.h"
+#include "DBSHitRegistratorSweep.h"
+#include "DBSHitSink.h"
+#include "DBSTimerWheel.h"
+#include "Components/ShapeComponent.h"
+#include "Engine/OverlapResult.h"
+#include "UObject/ObjectKey.h"
+#include "WorldCollision.h"
+#include "DBSHitRegistratorBase.generated.h"
+
+USTRUCT(BlueprintType)
+struct FDBSHitRegistratorHitResult
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TWeakObjectPtr<AActor> HitActor = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FHitResult HitResult;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector Direction = FVector::ZeroVector;
+	// Default instigator is Character that owns CapsuleHitRegistrator,
+	// but don't forget to override it if needed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TWeakObjectPtr<AActor> Instigator = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<EPhysicalSurface> PhysicalSurfaceType = EPhysicalSurface::SurfaceType_Default;
+	// WhileStandingInside - stacks occupant accumulated while inside(see "bUseStacks"), 1 for other types
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Stacks = 1;
+};
+
+// piece of compound registrator shape, component space without scale
+struct FDBSHitRegistratorSegment
+{
+	FTransform RelativeTransform = FTransform::Identity;
+	FCollisionShape CollisionShape;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHitRegistered,
+	const FDBSHitRegistratorHitResult&, HitRegistratorHitResult,
+	class UDBSHitRegistratorBase*, CapsuleHitRegistrator
+);
+
+/**
+ * Hit registration of any shape - sweeps, overlap queries and hit dispatching.
+ * Shape itself defined by subclasses(UCapsuleHitRegistrator, USphereHitRegistrator, UBoxHitRegistrator),
+ * scene queries issued with that shape so physics picks cheapest narrowphase for it
+ */
+UCLASS(Abstract, HideCategories = (Object, LOD, Lighting, TextureStreaming))
+class DAMAGEBEHAVIORSSYSTEM_API UDBSHitRegistratorBase : public UShapeComponent
+{
+	GENERATED_BODY()
+
+public:
+    UDBSHitRegistratorBase();
+
+	//~ UPrimitiveComponent/UShapeComponent interface, built from GetUnscaledShape
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	virtual bool IsZeroExtent() const override;
+	virtual FCollisionShape GetCollisionShape(float Inflation = 0.0f) const override;
+	virtual void UpdateBodySetup() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	//~ End of UPrimitiveComponent/UShapeComponent interface
+
+	// shape in component space without scale, capsule HalfHeight includes radius
+	virtual FCollisionShape GetUnscaledShape() const PURE_VIRTUAL(UDBSHitRegistratorBase::GetUnscaledShape, return FCollisionShape(););
+	// compound registrators(UChainHitRegistrator) swept/queried as all segments at once and hits deduped
+	// between segments, empty - single GetUnscaledShape at component origin
+	virtual TConstArrayView<FDBSHitRegistratorSegment> GetSegments() const { return {}; }
+
+	UPROPERTY(BlueprintAssignable)
+    FOnHitRegistered OnHitRegistered;
+
+    UFUNCTION(BlueprintCallable)
+    void SetIsHitRegistrationEnabled(bool bIsEnabled_In, FDamageBehaviorHitDetectionSettings HitDetectionSettings);
+    // probably with multitrace its not required to ignore some actors
+    UFUNCTION(BlueprintCallable)
+    void AddActorsToIgnoreList(const TArray<AActor*>& Actors_In);
+
+	// query params and ignore list built once per hit registration window,
+	// call it if actors attached to owner/character changed while window is active(e.g. weapon equipped).
+	// DamageBehavior calls it itself when it attaches/detaches hit actors
+	UFUNCTION(BlueprintCallable)
+	void NotifyAttachmentsChanged() { bQueryParamsDirty = true; }
+
+	// native listeners called directly before Blueprint "OnHitRegistered"
+	template<typename ObjectType>
+	void AddHitSink(ObjectType* SinkObject) { HitSinks.AddUnique(TDBSHitSinkRef<IDBSHitSink>(SinkObject)); }
+	template<typename ObjectType>
+	void RemoveHitSink(ObjectType* SinkObject) { HitSinks.RemoveSingle(TDBSHitSinkRef<IDBSHitSink>(SinkObject)); }
+
+	UFUNCTION(BlueprintCallable)
+	float GetLineThickness() const { return LineThickness; };
+
+	// if SweepBatch provided sweep only collected and should be executed/committed by batch owner.
+	// Only first call per frame sweeps, next calls in same frame are ignored
+	void TickHitRegistration(float DeltaTime, FDBSHitRegistratorSweepBatch* SweepBatch = nullptr);
+	bool IsHitRegistrationEnabled() const { return bIsHitRegistrationEnabled; }
+	// not swept this frame on purpose(see EDBSDetectionLOD::Simplified), next sweep starts from current transform
+	void ResyncHitRegistration();
+	// bUseAsyncTrace - delivers ready results of previous frames without sweeping,
+	// for frames registrator isn't ticked(detection LOD) so results don't expire
+	void DeliverAsyncSweeps();
+	// bUseAsyncTrace - before hit registration disabled, ready results delivered and
+	// not finished sweeps(submitted on last active frame) executed synchronously
+	void FlushAsyncSweeps();
+	EDamageBehaviorHitDetectionType GetHitDetectionType() const { return CurrentHitDetectionSettings.HitDetectionType; }
+	uint32 GetHitRegistrationWindow() const { return HitRegistrationWindow; }
+
+	// ByTrace/ByHurtboxes swept along baked montage trajectory instead of animated transform
+	// until hit registration disabled, see UANS_InvokeDamageBehavior
+	void SetBakedTrajectory(const FDBSBakedTrajectoryPlayback& BakedTrajectory_In);
+	bool HasBakedTrajectory() const { return BakedTrajectory.IsActive(); }
+	// baked trajectory transform if set, component transform otherwise
+	FTransform GetHitRegistrationTransform() const;
+
+	// ByHurtboxes swept against hurtboxes as they were Delay seconds ago(lag compensation)
+	// until hit registration disabled, see UDamageBehavior::SetLagCompensationTimestamp
+	void SetLagCompensationDelay(float Delay) { LagCompensationDelay = Delay; }
+	float GetLagCompensationDelay() const { return LagCompensationDelay; }
+
+	// WhileStandingInside re-hit timer of occupant expired, see UDamageBehaviorsSubsystem
+	void HandleStandingInsideHit(const TObjectKey<UPrimitiveComponent>& OccupantKey);
+
+	// thread-safe, only reads physics scene
+	static void ExecuteSweep(const UWorld* World, FDBSHitRegistratorSweep& Sweep);
+	// game thread only, broadcasts hits
+	void CommitSweep(const FDBSHitRegistratorSweep& Sweep);
+
+#if WITH_DEV_AUTOMATION_TESTS
+	// automation tests only, see Private/Tests
+	FDamageBehaviorHitDetectionSettings& GetHitDetectionSettingsForTests() { return CurrentHitDetectionSettings; }
+	void SetNumDeferredSweepFramesForTests(int32 NumDeferredSweepFrames_In) { NumDeferredSweepFrames = NumDeferredSweepFrames_In; }
+	int32 CalculateSubstepsCountForTests(const FTransform& From, const FTransform& To, const FCollisionShape& CollisionShape) const
+	{
+		return CalculateSubstepsCount(From, To, CollisionShape);
+	}
+	int32 GetNumHitSinksForTests() const { return HitSinks.Num(); }
+	void DispatchHitForTests(const FDBSHitRegistratorHitResult& HitRegistratorHitResult) { DispatchHit(HitRegistratorHitResult); }
+	bool IsQueryParamsDirtyForTests() const { return bQueryParamsDirty; }
+	void RebuildQueryParamsForTests() { RebuildQueryParams(); }
+#endif
+	
+protected:
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Melee hit registration")
+    bool bIsHitRegistrationEnabled = false;
+
+	// subclasses call it after their shape size changed at runtime
+	void NotifyShapeChanged(bool bUpdateOverlaps);
+
+private:
+	struct FDBSPendingAsyncSweep
+	{
+		FTraceHandle TraceHandle;
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		FQuat Rotation = FQuat::Identity;
+		FCollisionShape CollisionShape;
+		uint32 HitRegistrationWindow = 0;
+	};
+
+	// full transform, rotation used for substeps interpolation on fast swings
+    FTransform PreviousComponentTransform = FTransform::Identity;
+	// GFrameCounter of last TickHitRegistration, registrator sweeps once per frame
+	// no matter how many active DamageBehaviors tick it
+	uint64 LastHitRegistrationFrame = 0;
+	// skeletal mesh capsule attached to(directly or through attached actors), animation skipped frames detected from it
+	TWeakObjectPtr<USkeletalMeshComponent> AnimatedMeshComponent = nullptr;
+	uint32 LastBoneTransformRevision = 0;
+	// frames not swept since PreviousComponentTransform because pose was frozen
+	int32 NumDeferredSweepFrames = 0;
+	FDBSBakedTrajectoryPlayback BakedTrajectory;
+	float LagCompensationDelay = 0.0f;
+	// incremented every time hit registration enabled, async results of previous windows are dropped
+	uint32 HitRegistrationWindow = 0;
+	TArray<FDBSPendingAsyncSweep, TInlineAllocator<4>> PendingAsyncSweeps;
+	// reused for every QueryTraceData so delivered hits don't allocate
+	FTraceDatum AsyncTraceDatum;
+	FDamageBehaviorHitDetectionSettings CurrentHitDetectionSettings;
+    UPROPERTY()
+    TArray<AActor*> IgnoredActors;
+
+	TArray<TDBSHitSinkRef<IDBSHitSink>, TInlineAllocator<4>> HitSinks;
+
+	// ByOverlapQuery, 0 - not queried in current window yet
+	uint64 LastOverlapQueryFrame = 0;
+	double LastOverlapQueryTime = 0.0;
+	TArray<FOverlapResult> OverlapResults;
+	TArray<FOverlapResult> SegmentOverlapResults;
+	// diffed to synthesize enter events
+	TSet<TObjectKey<UPrimitiveComponent>> PreviousOverlappedComponents;
+	TSet<TObjectKey<UPrimitiveComponent>> CurrentOverlappedComponents;
+
+	struct FDBSStandingInsideOccupant
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component = nullptr;
+		FDBSTimerWheelHandle HitTimerHandle;
+		int32 Stacks = 0;
+	};
+	// WhileStandingInside, re-hits scheduled in UDamageBehaviorsSubsystem timer wheel
+	TMap<TObjectKey<UPrimitiveComponent>, FDBSStandingInsideOccupant> StandingInsideOccupants;
+
+	// compound registrators - components(actors for hits without component) already hit by other segment this frame
+	TSet<FObjectKey> SegmentsHitObjects;
+	uint64 SegmentsHitFrame = 0;
+
+	FCollisionQueryParams CachedQueryParams;
+	// actors ignored by CachedQueryParams, raw pointers only compared
+	TArray<const AActor*, TInlineAllocator<8>> QueryIgnoredActors;
+	// RebuildQueryParams scratch, keeps its allocation between windows
+	TArray<AActor*> AttachedActorsScratch;
+	// sweeps of calls without UDamageBehaviorsSubsystem batch, HitResults keep their allocations between frames
+	FDBSHitRegistratorSweepBatch ScratchSweepBatch;
+	// hits processing can flush this registrator while its scratch sweep is committed, nested call uses own batch
+	bool bIsScratchSweepBatchInUse = false;
+	ECollisionChannel CachedTraceChannel = ECC_Visibility;
+	bool bQueryParamsDirty = true;
+
+	void RebuildQueryParams();
+	// false when hittable actors broadphase enabled and nobody to hit near swept capsule
+	bool HasHittableActorsNearSweep() const;
+	// true when mesh didn't evaluate new pose this frame, sweep waits for next evaluated pose
+	bool ShouldDeferSweepForSkippedAnimation();
+	void DispatchHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult);
+
+	void BuildSweeps(FDBSHitRegistratorSweepBatch& SweepBatch) const;
+	void BuildShapeSweeps(FDBSHitRegistratorSweepBatch& SweepBatch, const FTransform& From, const FTransform& To,
+		const FCollisionShape& CollisionShape, const FDBSHurtboxesSnapshot* Hurtboxes) const;
+	// distance from component origin to farthest point of any segment, scaled
+	float GetScaledReach() const;
+	// false if other segment of compound registrator already hit this component in current frame,
+	// keyed by hit actor if HitResult has no component
+	bool ShouldDispatchSegmentsHit(const FHitResult& HitResult);
+	bool ShouldQueryOverlaps() const;
+	void TickOverlapQuery();
+	void DispatchOverlapHit(UPrimitiveComponent* OverlappedComponent, int32 Stacks);
+	void AddStandingInsideOccupant(UPrimitiveComponent* OverlappedComponent, bool bHitOnEnter);
+	FDBSTimerWheelHandle ScheduleStandingInsideHit(UPrimitiveComponent* OverlappedComponent);
+	void CancelStandingInsideHit(FDBSTimerWheelHandle& HitTimerHandle);
+	void ClearStandingInsideOccupants();
+	int32 CalculateSubstepsCount(const FTransform& From, const FTransform& To, const FCollisionShape& CollisionShape) const;
+	void SubmitAsyncSweep(const FDBSHitRegistratorSweep& Sweep);
+	// bSweepNotReady - pending sweeps without results executed right away, otherwise kept until ready or expired
+	void ConsumeAsyncSweeps(FDBSHitRegistratorSweepBatch& SweepBatch, bool bSweepNotReady = false);
+	UFUNCTION()
+	void OnBegingOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	UFUNCTION()
+	void OnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	void OnDebugCategoryChanged(IConsoleVariable* Var);
+	void UpdateCapsuleVisibility(bool bIsVisible_In);
+
+	// drawing part of UnrealHelperLibrary TraceUtils SweepCapsuleMultiByChannel,
+	// split from query so sweeps can run outside of game thread
+	static void DrawDebugSweep(const UWorld* World, const TArray<FHitResult>& OutHits, bool bResult, const FVector& Start,
+		const FVector& End, const FCollisionShape& CollisionShape, const FQuat& Rot,
+		float DrawTime = -1.0f, FColor TraceColor = FColor::Black,
+		FColor HitColor = FColor::Red, float FailDrawTime = -1.0f);
+	static void DrawDebugShape(const UWorld* World, const FVector& Location, const FQuat& Rot, const FCollisionShape& CollisionShape,
+		FColor Color, float DrawTime = -1.0f, float Thickness = 0.0f);
+};
@@ -0,0 +1,78 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "Engine/HitResult.h"
+
+class UDBSHitRegistratorBase;
+struct FDBSHurtboxesSnapshot;
+
+// Single scene query of HitRegistrator, built on game thread,
+// can be executed on any thread, committed(broadcasted) on game thread
+struct FDBSHitRegistratorSweep
+{
+	UDBSHitRegistratorBase* HitRegistrator = nullptr;
+
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FCollisionShape CollisionShape;
+	ECollisionChannel TraceChannel = ECC_Visibility;
+	// owned by HitRegistrator, built once per hit registration window
+	const FCollisionQueryParams* QueryParams = nullptr;
+	// ByHurtboxes - sweep resolved against hurtboxes of current frame instead of physics scene,
+	// owners of hurtboxes in IgnoredActors skipped same as actors ignored by QueryParams
+	const FDBSHurtboxesSnapshot* Hurtboxes = nullptr;
+	TConstArrayView<const AActor*> IgnoredActors;
+
+	TArray<FHitResult> HitResults;
+	bool bHasHit = false;
+};
+
+// All sweeps of active DamageBehaviors collected during frame.
+// Sweeps are never destroyed on Reset so HitResults keep their allocations
+// between frames - steady state sweeping doesn't touch heap
+struct FDBSHitRegistratorSweepBatch
+{
+	// true - sweeps executed later all together (see UDamageBehaviorsSubsystem::TickActiveBehaviors),
+	// false - HitRegistrator executes and commits its sweeps right away and gives them back
+	bool bDeferExecution = false;
+
+	FDBSHitRegistratorSweep& AddSweep()
+	{
+		if (NumSweeps == Sweeps.Num())
+		{
+			Sweeps.AddDefaulted();
+		}
+		FDBSHitRegistratorSweep& Sweep = Sweeps[NumSweeps++];
+		Sweep.HitResults.Reset();
+		Sweep.bHasHit = false;
+		return Sweep;
+	}
+
+	// drops sweeps added after NewNum, keeps their memory
+	void Truncate(int32 NewNum)
+	{
+		check(NewNum >= 0 && NewNum <= NumSweeps);
+		NumSweeps = NewNum;
+	}
+
+	void Reset() { NumSweeps = 0; }
+
+	int32 Num() const { return NumSweeps; }
+
+	FDBSHitRegistratorSweep& operator[](int32 Index)
+	{
+		check(Index >= 0 && Index < NumSweeps);
+		return Sweeps[Index];
+	}
+
+	TArrayView<FDBSHitRegistratorSweep> GetSweeps() { return MakeArrayView(Sweeps.GetData(), NumSweeps); }
+
+private:
+	TArray<FDBSHitRegistratorSweep> Sweeps;
+	int32 NumSweeps = 0;
+};
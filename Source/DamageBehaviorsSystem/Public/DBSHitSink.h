@@ -0,0 +1,56 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+struct FDBSHitRegistratorHitResult;
+struct FInstancedStruct;
+class UDBSHitRegistratorBase;
+class UDamageBehavior;
+
+// Native receiver of HitRegistrator hits, called directly without reflection/ProcessEvent.
+// UDamageBehavior listens its HitRegistrators this way
+class DAMAGEBEHAVIORSSYSTEM_API IDBSHitSink
+{
+public:
+	virtual ~IDBSHitSink() = default;
+
+	virtual void HandleHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator) = 0;
+};
+
+// Native receiver of hits processed by DamageBehavior,
+// UDamageBehaviorsComponent listens its DamageBehaviors this way
+class DAMAGEBEHAVIORSSYSTEM_API IDBSDamageBehaviorHitSink
+{
+public:
+	virtual ~IDBSDamageBehaviorHitSink() = default;
+
+	virtual void HandleDamageBehaviorHit(
+		const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
+		const UDamageBehavior* DamageBehavior,
+		const UDBSHitRegistratorBase* CapsuleHitRegistrator,
+		const FInstancedStruct& Payload) = 0;
+};
+
+// Sink implemented by UObject, not called after object is gone
+template<typename SinkType>
+struct TDBSHitSinkRef
+{
+	TWeakObjectPtr<const UObject> Object = nullptr;
+	SinkType* Sink = nullptr;
+
+	TDBSHitSinkRef() = default;
+
+	template<typename ObjectType>
+	TDBSHitSinkRef(ObjectType* SinkObject)
+		: Object(SinkObject)
+		, Sink(SinkObject)
+	{
+	}
+
+	SinkType* Get() const { return Object.IsValid() ? Sink : nullptr; }
+
+	bool operator==(const TDBSHitSinkRef& Other) const { return Sink == Other.Sink; }
+};
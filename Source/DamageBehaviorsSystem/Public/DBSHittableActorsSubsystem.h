@@ -0,0 +1,90 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "DBSHittableActorsSubsystem.generated.h"
+
+class USceneComponent;
+
+/**
+ * Registry of actors that can be hit by DamageBehaviors, kept in uniform spatial hash.
+ * Pawns registered automatically(settings "bRegisterPawnsAsHittable"), anything else
+ * opt-in with UDBSHittableComponent. Entries updated incrementally from root component
+ * TransformUpdated, cells touched only when actor bounds moved to other cells.
+ * ByTrace HitRegistrators check swept bounds here and skip scene query when
+ * there is nobody to hit around (see "DamageBehaviorsSystem.HittableBroadphase").
+ * Created only when "bHittableActorsBroadphase" enabled in settings.
+ */
+UCLASS()
+class DAMAGEBEHAVIORSSYSTEM_API UDBSHittableActorsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UDBSHittableActorsSubsystem* Get(const UWorld* World);
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category="DamageBehaviorsSystem")
+	void RegisterHittableActor(AActor* Actor);
+	UFUNCTION(BlueprintCallable, Category="DamageBehaviorsSystem")
+	void UnregisterHittableActor(AActor* Actor);
+
+	// true if any registered actor except IgnoredActors intersects Bounds.
+	// Conservative - too big Bounds always returns true
+	bool HasHittableActorsInBounds(const FBox& Bounds, TConstArrayView<const AActor*> IgnoredActors) const;
+
+	int32 GetNumHittableActors() const { return HittableActors.Num(); }
+	uint64 GetNumQueriesIssued() const { return NumQueriesIssued; }
+	uint64 GetNumQueriesSkipped() const { return NumQueriesSkipped; }
+	// HitRegistrators report result of every broadphase check
+	void RecordQuery(bool bIssued) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FDBSHittableActor
+	{
+		TWeakObjectPtr<AActor> Actor = nullptr;
+		TWeakObjectPtr<USceneComponent> RootComponent = nullptr;
+		FBox Bounds = FBox(ForceInit);
+		FIntVector MinCell = FIntVector::ZeroValue;
+		FIntVector MaxCell = FIntVector::ZeroValue;
+		FDelegateHandle TransformUpdatedHandle;
+	};
+
+	TSparseArray<FDBSHittableActor> HittableActors;
+	TMap<TObjectKey<AActor>, int32> HittableActorIndices;
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+
+	// from settings, read once on Initialize
+	float CellSize = 500.0f;
+	float BoundsExpansion = 50.0f;
+	// query touching more cells than this is not culled, checking it costs more than sweep
+	static constexpr int32 MaxQueryCells = 64;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	mutable uint64 NumQueriesIssued = 0;
+	mutable uint64 NumQueriesSkipped = 0;
+
+	FIntVector GetCell(const FVector& Location) const;
+	void UpdateHittableActor(int32 Index);
+	void AddToCells(int32 Index, const FIntVector& MinCell, const FIntVector& MaxCell);
+	void RemoveFromCells(int32 Index, const FIntVector& MinCell, const FIntVector& MaxCell);
+
+	void OnActorSpawned(AActor* Actor);
+	// Index - payload bound on register, stable while actor registered
+	void OnHittableTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 Index);
+	UFUNCTION()
+	void OnHittableActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+};
@@ -0,0 +1,25 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DBSHittableComponent.generated.h"
+
+/**
+ * Registers owner in UDBSHittableActorsSubsystem so ByTrace HitRegistrators
+ * don't skip sweeps near it when "bHittableActorsBroadphase" enabled.
+ * Pawns are registered without it, add to destructibles, props, etc.
+ */
+UCLASS(ClassGroup=(DamageBehaviorsSystem), meta=(BlueprintSpawnableComponent))
+class DAMAGEBEHAVIORSSYSTEM_API UDBSHittableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDBSHittableComponent();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,53 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "DBSHurtboxComponent.generated.h"
+
+class UPhysicalMaterial;
+class UPrimitiveComponent;
+
+/**
+ * Capsule that can be hit by "ByHurtboxes" DamageBehaviors.
+ * Never enters physics scene - sweeps are resolved against it with DBS own math
+ * (see UDBSHurtboxesSubsystem), so no channels or collision profiles required.
+ * Attach to bones of your character, HalfHeight includes radius same as UCapsuleComponent
+ */
+UCLASS(ClassGroup=(DamageBehaviorsSystem), meta=(BlueprintSpawnableComponent))
+class DAMAGEBEHAVIORSSYSTEM_API UDBSHurtboxComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDBSHurtboxComponent();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hurtbox", meta=(ClampMin=0, Units="Centimeters"))
+	float CapsuleRadius = 20.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hurtbox", meta=(ClampMin=0, Units="Centimeters"))
+	float CapsuleHalfHeight = 40.0f;
+
+	// disable e.g. for dodge invincibility frames
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Hurtbox")
+	bool bIsHurtboxEnabled = true;
+
+	// used as hit result PhysMaterial, so "PhysicalSurfaceType" works same as with physics sweeps
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hurtbox")
+	TObjectPtr<UPhysicalMaterial> PhysicalMaterial = nullptr;
+
+	UFUNCTION(BlueprintCallable)
+	float GetScaledCapsuleRadius() const { return CapsuleRadius * GetComponentTransform().GetMinimumAxisScale(); }
+	UFUNCTION(BlueprintCallable)
+	float GetScaledCapsuleHalfHeight() const { return CapsuleHalfHeight * GetComponentTransform().GetMinimumAxisScale(); }
+
+	// hurtbox is not a primitive, hit results report first primitive it's attached to(usually skeletal mesh),
+	// owner root primitive if there is none
+	UFUNCTION(BlueprintCallable)
+	UPrimitiveComponent* GetHitComponent() const;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,58 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed capacity ring buffer of hurtbox transforms of one actor for lag compensation.
+ * Samples stored quantized structure-of-arrays: location as int16 millimeters relative
+ * to sample origin(owner root), rotation as int16 normalized quaternion, enabled state as bitmask.
+ * Memory is fixed on Init - Capacity * (36 + NumHurtboxes * 14) bytes
+ */
+struct DAMAGEBEHAVIORSSYSTEM_API FDBSHurtboxHistory
+{
+	// bits of enabled mask
+	static constexpr int32 MaxHurtboxes = 32;
+	// 1mm, offsets from origin clamped to ~32m
+	static constexpr float LocationQuantizationScale = 10.0f;
+
+	// drops all samples
+	void Init(int32 Capacity_In, int32 NumHurtboxes_In);
+
+	// Transforms - one per hurtbox, Time should grow between records
+	void Record(double Time, const FVector& Origin, TConstArrayView<FTransform> Transforms, uint32 EnabledMask);
+
+	// interpolated between two samples around Time, clamped to oldest/newest sample.
+	// OutTransforms - one per hurtbox, false if nothing recorded yet
+	bool Rewind(double Time, TArrayView<FTransform> OutTransforms, uint32& OutEnabledMask) const;
+
+	int32 Num() const { return NumSamples; }
+	int32 GetNumHurtboxes() const { return NumHurtboxes; }
+	double GetOldestTime() const;
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// [SampleIndex]
+	TArray<double> Times;
+	TArray<FVector> Origins;
+	TArray<uint32> EnabledMasks;
+	// [SampleIndex * NumHurtboxes + HurtboxIndex]
+	TArray<int16> LocationX;
+	TArray<int16> LocationY;
+	TArray<int16> LocationZ;
+	TArray<int16> RotationX;
+	TArray<int16> RotationY;
+	TArray<int16> RotationZ;
+	TArray<int16> RotationW;
+
+	int32 Capacity = 0;
+	int32 NumHurtboxes = 0;
+	// next sample written here
+	int32 Head = 0;
+	int32 NumSamples = 0;
+
+	// Age 0 - oldest sample
+	int32 GetSampleIndex(int32 Age) const { return (Head - NumSamples + Age + Capacity) % Capacity; }
+	FTransform GetTransform(int32 SampleIndex, int32 HurtboxIndex) const;
+};
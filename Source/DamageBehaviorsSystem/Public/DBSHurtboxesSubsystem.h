@@ -0,0 +1,101 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DBSCapsuleSweepKernel.h"
+#include "DBSHurtboxHistory.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DBSHurtboxesSubsystem.generated.h"
+
+class UDBSHurtboxComponent;
+class UPrimitiveComponent;
+struct FDBSHitRegistratorSweep;
+
+// Enabled hurtboxes of current frame, read-only while sweeps executed so can be used from worker threads
+struct FDBSHurtboxesSnapshot
+{
+	FDBSCapsulesSoA Capsules;
+	// same indices as in Capsules
+	TArray<const UDBSHurtboxComponent*> Hurtboxes;
+	TArray<AActor*> Owners;
+	// UDBSHurtboxComponent::GetHitComponent resolved on game thread, set as hit result Component
+	TArray<UPrimitiveComponent*> HitComponents;
+};
+
+/**
+ * Registry of UDBSHurtboxComponents of the world for "ByHurtboxes" hit detection.
+ * Hurtboxes gathered into FDBSHurtboxesSnapshot once per frame on first request,
+ * sweeps of HitRegistrators are resolved against it by FDBSCapsuleSweepKernel.
+ * With lag compensation("DamageBehaviorsSystem.LagCompensation", read on world start) server records
+ * transforms of hurtboxes per owner into FDBSHurtboxHistory every frame, sweeps of DamageBehaviors with
+ * lag compensation timestamp are resolved against hurtboxes rewound to that time
+ */
+UCLASS()
+class DAMAGEBEHAVIORSSYSTEM_API UDBSHurtboxesSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UDBSHurtboxesSubsystem* Get(const UWorld* World);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RegisterHurtbox(UDBSHurtboxComponent* Hurtbox);
+	void UnregisterHurtbox(UDBSHurtboxComponent* Hurtbox);
+
+	int32 GetNumHurtboxes() const { return Hurtboxes.Num(); }
+
+	// game thread only
+	const FDBSHurtboxesSnapshot& GetHurtboxesSnapshot();
+
+	// game thread only, hurtboxes as they were at world Time, interpolated between recorded frames.
+	// Cached per frame and Time, so all behaviors rewound by same latency share one snapshot.
+	// Current snapshot if lag compensation is not recorded
+	const FDBSHurtboxesSnapshot& GetRewoundHurtboxesSnapshot(double Time);
+
+	// thread-safe, fills Sweep.HitResults same way as SweepMultiByChannel would
+	static void ExecuteSweep(FDBSHitRegistratorSweep& Sweep);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<UDBSHurtboxComponent>> Hurtboxes;
+
+	FDBSHurtboxesSnapshot HurtboxesSnapshot;
+	uint64 HurtboxesSnapshotFrame = 0;
+	bool bIsHurtboxesSnapshotDirty = true;
+
+	void RebuildHurtboxesSnapshot();
+
+	struct FDBSHurtboxesHistoryEntry
+	{
+		AActor* Owner = nullptr;
+		// first FDBSHurtboxHistory::MaxHurtboxes are recorded, others rewound as current
+		TArray<const UDBSHurtboxComponent*, TInlineAllocator<8>> Hurtboxes;
+		FDBSHurtboxHistory History;
+	};
+	// by hurtboxes owner, history of owner restarts when its hurtboxes added/removed
+	TMap<TObjectKey<AActor>, FDBSHurtboxesHistoryEntry> HurtboxesHistory;
+
+	// snapshots stay at same address until next frame, sweeps point to them
+	TArray<TUniquePtr<FDBSHurtboxesSnapshot>> RewoundSnapshots;
+	TArray<double> RewoundSnapshotsTimes;
+	uint64 RewoundSnapshotsFrame = 0;
+	TArray<FTransform> HistoryTransforms;
+
+	// from settings, read once on Initialize
+	bool bIsLagCompensationEnabled = false;
+	int32 LagCompensationHistorySize = 64;
+
+	FDelegateHandle WorldPostActorTickHandle;
+
+	void AddToHurtboxesHistory(const UDBSHurtboxComponent* Hurtbox);
+	void RemoveFromHurtboxesHistory(const UDBSHurtboxComponent* Hurtbox);
+	void RecordHurtboxesHistory(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void RebuildRewoundHurtboxesSnapshot(double Time, FDBSHurtboxesSnapshot& Snapshot);
+};
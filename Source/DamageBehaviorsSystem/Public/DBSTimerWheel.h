@@ -0,0 +1,156 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FDBSTimerWheelHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; }
+};
+
+/**
+ * Hashed timer wheel - timers hashed into NumSlots buckets by expire tick,
+ * Advance visits only buckets of passed ticks, so frame cost is O(expiring timers)
+ * instead of checking every scheduled timer. Timers longer than one wheel revolution
+ * stay in their bucket until their tick comes. Cancel is O(1), stale bucket
+ * references are dropped lazily when bucket visited
+ */
+template<typename PayloadType>
+class TDBSTimerWheel
+{
+public:
+	explicit TDBSTimerWheel(double TickSeconds_In = 1.0 / 30.0)
+		: TickSeconds(TickSeconds_In)
+	{
+	}
+
+	// Time - same clock as passed to Advance, e.g. world time seconds
+	FDBSTimerWheelHandle Schedule(double ExpireTime, const PayloadType& Payload)
+	{
+		int32 Index;
+		if (FreeEntries.Num() > 0)
+		{
+			Index = FreeEntries.Pop(EAllowShrinking::No);
+		}
+		else
+		{
+			Index = Entries.AddDefaulted();
+		}
+
+		FEntry& Entry = Entries[Index];
+		Entry.Payload = Payload;
+		// never expires in already processed tick
+		Entry.ExpireTick = FMath::Max(CurrentTick + 1, static_cast<uint64>(FMath::CeilToDouble(ExpireTime / TickSeconds)));
+		Entry.bIsScheduled = true;
+		NumScheduled++;
+
+		Slots[Entry.ExpireTick % NumSlots].Add({ Index, Entry.Serial });
+		return { Index, Entry.Serial };
+	}
+
+	void Cancel(FDBSTimerWheelHandle& Handle)
+	{
+		if (Handle.IsValid() && Entries.IsValidIndex(Handle.Index))
+		{
+			FEntry& Entry = Entries[Handle.Index];
+			if (Entry.bIsScheduled && Entry.Serial == Handle.Serial)
+			{
+				Release(Handle.Index);
+				NumStaleSlotEntries++;
+			}
+		}
+		Handle.Invalidate();
+	}
+
+	// payloads of expired timers appended to OutExpired
+	template<typename AllocatorType>
+	void Advance(double Time, TArray<PayloadType, AllocatorType>& OutExpired)
+	{
+		const uint64 TargetTick = static_cast<uint64>(FMath::FloorToDouble(Time / TickSeconds));
+		if (TargetTick <= CurrentTick) return;
+
+		if (NumScheduled == 0)
+		{
+			// only cancelled timers left, drop them all at once
+			if (NumStaleSlotEntries > 0)
+			{
+				for (TArray<FSlotEntry>& Slot : Slots)
+				{
+					Slot.Reset();
+				}
+				NumStaleSlotEntries = 0;
+			}
+			CurrentTick = TargetTick;
+			return;
+		}
+
+		// after long hitch every bucket visited once
+		const uint64 FirstTick = FMath::Max(CurrentTick + 1, TargetTick >= NumSlots ? TargetTick - NumSlots + 1 : 0);
+		for (uint64 Tick = FirstTick; Tick <= TargetTick; Tick++)
+		{
+			TArray<FSlotEntry>& Slot = Slots[Tick % NumSlots];
+			for (int32 i = Slot.Num() - 1; i >= 0; i--)
+			{
+				const FSlotEntry SlotEntry = Slot[i];
+				FEntry& Entry = Entries[SlotEntry.Index];
+				const bool bIsStale = !Entry.bIsScheduled || Entry.Serial != SlotEntry.Serial;
+				if (!bIsStale && Entry.ExpireTick > TargetTick) continue;
+
+				if (!bIsStale)
+				{
+					OutExpired.Add(Entry.Payload);
+					Release(SlotEntry.Index);
+				}
+				else
+				{
+					NumStaleSlotEntries--;
+				}
+				Slot.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			}
+		}
+		CurrentTick = TargetTick;
+	}
+
+	int32 Num() const { return NumScheduled; }
+
+private:
+	static constexpr uint64 NumSlots = 256;
+
+	struct FEntry
+	{
+		PayloadType Payload;
+		uint64 ExpireTick = 0;
+		uint32 Serial = 0;
+		bool bIsScheduled = false;
+	};
+
+	struct FSlotEntry
+	{
+		int32 Index = INDEX_NONE;
+		uint32 Serial = 0;
+	};
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+	TArray<FSlotEntry> Slots[NumSlots];
+	uint64 CurrentTick = 0;
+	double TickSeconds = 1.0 / 30.0;
+	int32 NumScheduled = 0;
+	int32 NumStaleSlotEntries = 0;
+
+	void Release(int32 Index)
+	{
+		FEntry& Entry = Entries[Index];
+		Entry.bIsScheduled = false;
+		Entry.Payload = PayloadType();
+		// bucket references to this entry become stale
+		Entry.Serial++;
+		FreeEntries.Add(Index);
+		NumScheduled--;
+	}
+};
@@ -3,18 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "CapsuleHitRegistrator.h"
+#include "DBSHitPolicy.h"
+#include "DBSHitRegistratorBase.h"
+#include "DBSHitSink.h"
 #include "HitRegistratorsSource.h"
 #include "StructUtils/InstancedStruct.h"
-#include "Tickable.h"
 #include "DamageBehavior.generated.h"
 
-class UCapsuleHitRegistrator;
+class UDBSHitRegistratorBase;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnDamageBehaviorHitRegistered,
     const FDBSHitRegistratorHitResult&, HitRegistratorHitResult,
     const class UDamageBehavior*, DamageBehavior,
-    const UCapsuleHitRegistrator*, CapsuleHitRegistrator,
+    const UDBSHitRegistratorBase*, CapsuleHitRegistrator,
     const FInstancedStruct&, Payload
 );
 
@@ -35,11 +36,12 @@ struct FDBSNoiseEventOnDamageSettings
 
 /**
  * DamageBehavior entity that handles all hits from dumb "CapsuleHitRegistrators"
- * and filter hitted objects by adding them in "HitActors".
+ * and filter hitted objects by adding them in "HitActors" according to "HitPolicy".
  * When "InvokeDamageBehavior" ends, all "HitActors" cleanup
+ * While active ticked by UDamageBehaviorsSubsystem of its world
  */
 UCLASS(Blueprintable, BlueprintType, DefaultToInstanced, EditInlineNew, AutoExpandCategories = ("Default,DamageBehavior"), meta=(DisplayName=""))
-class DAMAGEBEHAVIORSSYSTEM_API UDamageBehavior : public UObject, public FTickableGameObject
+class DAMAGEBEHAVIORSSYSTEM_API UDamageBehavior : public UObject, public IDBSHitSink
 {
     GENERATED_BODY()
 
@@ -55,6 +57,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="DamageBehavior", meta=(ShowOnlyInnerProperties))
 	FDamageBehaviorHitDetectionSettings HitDetectionSettings;
 
+	// re-hit intervals, per target hits and targets caps
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="DamageBehavior")
+	FDBSHitPolicySettings HitPolicy;
+
     /**
      * @brief If enabled DamageBehaviorsComponent will DealDamage to enemy automatically
      * Enable it only on AI enemies or in cases when DamageBehavior on Character(like DmgBeh_Roll, DmgBeh_Backstep)...
@@ -104,18 +110,18 @@ public:
 	// by default HitTarget is most top actor in "attach" hierarchy
 	// TODO: probably in GrabAttacks it might cause problems
 	UFUNCTION(BlueprintNativeEvent)
-	AActor* GetHitTarget(AActor* HitActor_In, const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UCapsuleHitRegistrator* CapsuleHitRegistrator) const;
+	AActor* GetHitTarget(AActor* HitActor_In, const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator) const;
 
 	// ex. CanGetHit
 	// if can - added to hitted actors array and should be ignored by other capsules in DamageBehavior
 	// make your checks for IHittableInterface or whatever you check that actor is hittable 
 	UFUNCTION(BlueprintNativeEvent)
-	bool CanBeAddedToHittedActors(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UCapsuleHitRegistrator* CapsuleHitRegistrator);
+	bool CanBeAddedToHittedActors(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator);
 
 	// Main function for ProcessingHit, if you lasy use OnHitRegistered
 	// Result - is hit should be registered
 	UFUNCTION(BlueprintNativeEvent)
-	bool ProcessHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UCapsuleHitRegistrator* CapsuleHitRegistrator, FInstancedStruct& Payload_Out);
+	bool ProcessHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator, FInstancedStruct& Payload_Out);
 
 	UFUNCTION(BlueprintNativeEvent)
     void AddHittedActor(AActor* Actor_In, bool bCanBeAttached, bool bAddAttachedActorsToActorAlso);
@@ -130,7 +136,7 @@ public:
 	AActor* GetOwningActor() const { return OwnerActor.Get(); };
 
 	// TODO: probably not required at all after refactoring
-	TArray<UCapsuleHitRegistrator*> GetCapsuleHitRegistratorsFromAllSources() const;
+	TArray<UDBSHitRegistratorBase*> GetCapsuleHitRegistratorsFromAllSources() const;
 
 	void SyncSourcesFromSettings();
 
@@ -140,10 +146,26 @@ public:
 	UFUNCTION(BlueprintCallable)
 	const FInstancedStruct& GetCurrentInvokePayload() const { return CurrentInvokePayload; };
 
-	virtual void Tick(float DeltaTime) override;
-	virtual bool IsTickable() const override;
-	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; };
-	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageBehavior, STATGROUP_Tickables); };
+	// server lag compensation for ByHurtboxes - Timestamp is world time(GetServerWorldTimeSeconds) on attacker
+	// client when attack started, hurtboxes are rewound by the same latency for the whole window.
+	// Can be set before or while active, cleared on deactivation. Clamped to "LagCompensationMaxRewindTime"
+	UFUNCTION(BlueprintCallable)
+	void SetLagCompensationTimestamp(double Timestamp);
+
+	// called by UDamageBehaviorsSubsystem only while DamageBehavior is active,
+	// with SweepBatch sweeps are only collected to be executed in parallel
+	virtual void Tick(float DeltaTime, FDBSHitRegistratorSweepBatch* SweepBatch = nullptr);
+	// instead of Tick on frames skipped by detection LOD, async trace results don't expire
+	void DeliverAsyncHits();
+	bool IsActive() const { return bIsActive; }
+	EDBSDetectionLOD GetDetectionLOD() const { return DetectionLOD; }
+
+	// IDBSHitSink, called directly by HitRegistrators
+	virtual void HandleHit(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator) override;
+
+	// native receiver of processed hits(UDamageBehaviorsComponent), called before Blueprint "OnHitRegistered"
+	template<typename ObjectType>
+	void SetDamageBehaviorHitSink(ObjectType* SinkObject) { DamageBehaviorHitSink = TDBSHitSinkRef<IDBSDamageBehaviorHitSink>(SinkObject); }
 
 	bool operator==(const FString& OtherName) const
 	{
@@ -154,6 +176,16 @@ public:
 		return Name == Other->Name;
 	}
 
+#if WITH_DEV_AUTOMATION_TESTS
+	// automation tests only, see Private/Tests
+	EDBSHitPolicyResult CheckHitPolicyForTests(const AActor* HitActor, double Time) const { return CheckHitPolicy(HitActor, Time); }
+	bool CanReHitTargetsForTests() const { return CanReHitTargets(); }
+	// bookkeeping of HandleHitInternally for accepted hit of actor without HitTarget
+	void AddAcceptedHitForTests(AActor* HitActor);
+	void ResolveActiveHitRegistratorsForTests() { ResolveActiveHitRegistrators(); }
+	const TArray<TObjectPtr<UDBSHitRegistratorBase>>& GetActiveHitRegistratorsForTests() const { return ActiveHitRegistrators; }
+#endif
+
 protected:
 	UPROPERTY()
 	FInstancedStruct CurrentInvokePayload = {};
@@ -165,19 +197,45 @@ protected:
 #endif
 	
 private:
-    UPROPERTY()
-    TArray<TWeakObjectPtr<AActor>> HitActors = {};
+	friend class UDamageBehaviorsSubsystem;
+
+	// targets and actors attached to them, cleared by generation on ClearHittedActors
+	FDBSHitActorsSet HitActors;
+	// targets accepted in current window, attached actors not counted
+	int32 NumHitTargets = 0;
+	// incremented for every handled hit, see FDBSHitActorsSet::Add
+	uint32 HitSerial = 0;
     UPROPERTY()
     TArray<TWeakObjectPtr<AActor>> AttachedActors = {}; 
     UPROPERTY()
     bool bIsActive = false;
     TWeakObjectPtr<AActor> OwnerActor = nullptr;
+	// index in UDamageBehaviorsSubsystem active list, INDEX_NONE when not scheduled
+	int32 ActiveBehaviorIndex = INDEX_NONE;
+	// set by UDamageBehaviorsSubsystem before Tick
+	EDBSDetectionLOD DetectionLOD = EDBSDetectionLOD::Full;
+	// seconds hurtboxes rewound by, 0 - no lag compensation
+	float LagCompensationDelay = 0.0f;
+	// HitRegistrators enabled by current MakeActive(sources and "HitRegistrators to Activate" resolved once),
+	// Tick only iterates them
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UDBSHitRegistratorBase>> ActiveHitRegistrators;
+	TDBSHitSinkRef<IDBSDamageBehaviorHitSink> DamageBehaviorHitSink;
 
 	UFUNCTION()
-    void HandleHitInternally(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UCapsuleHitRegistrator* CapsuleHitRegistrator);
+    void HandleHitInternally(const FDBSHitRegistratorHitResult& HitRegistratorHitResult, UDBSHitRegistratorBase* CapsuleHitRegistrator);
 
 	AActor* GetRootAttachedActor(AActor* Actor_In) const;
 
+	void ResolveActiveHitRegistrators();
+	// attached actors are ignored by sweeps, active registrators rebuild query params
+	void NotifyAttachmentsChanged();
+	EDBSHitPolicyResult CheckHitPolicy(const AActor* HitActor, double Time) const;
+	bool CanReHitTargets() const;
+	double GetHitPolicyTime() const;
+	bool ShouldBeScheduled() const;
+	void UpdateScheduling();
+
 	// copy of UnrealHelperLibrary function
 	TArray<FString> GetNamesOfComponentsOnObject(UObject* OwnerObject, UClass* Class) const;
 };
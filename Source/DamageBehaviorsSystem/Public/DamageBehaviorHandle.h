@@ -0,0 +1,65 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "DamageBehaviorHandle.generated.h"
+
+class UDamageBehavior;
+class UDamageBehaviorsComponent;
+
+/**
+ * DamageBehavior resolved once by UDamageBehaviorsComponent::MakeDamageBehaviorHandle.
+ * Name/source lookups and forwarding to source components done on resolve,
+ * UDamageBehaviorsComponent::InvokeDamageBehaviorByHandle only activates cached DamageBehaviors.
+ * Source evaluators still run on every invoke(source actor can change any time, e.g. weapon swapped
+ * or equipped after resolve), handle becomes stale when any source gives other component than on resolve.
+ * Everything kept by weak pointers, handle also stale when any of used components or
+ * DamageBehaviors gone, or component invalidated its handles (EndPlay, lookup or sources rebuild,
+ * InvalidateDamageBehaviorHandles). Stale handle re-resolved on next invoke
+ */
+USTRUCT(BlueprintType)
+struct DAMAGEBEHAVIORSSYSTEM_API FDamageBehaviorHandle
+{
+	GENERATED_BODY()
+
+	bool IsValid() const;
+	void Reset();
+
+	FName GetDamageBehaviorName() const { return DamageBehaviorName; }
+
+#if WITH_DEV_AUTOMATION_TESTS
+	// automation tests only, see Private/Tests
+	const UDamageBehaviorsComponent* GetOwnerComponentForTests() const { return OwnerComponent.Get(); }
+	TArray<UDamageBehavior*> GetResolvedDamageBehaviorsForTests() const;
+#endif
+
+private:
+	friend class UDamageBehaviorsComponent;
+
+	struct FResolvedDamageBehavior
+	{
+		TWeakObjectPtr<UDamageBehavior> DamageBehavior = nullptr;
+		// component DamageBehavior found on, owner component or forwarded source component
+		TWeakObjectPtr<UDamageBehaviorsComponent> DamageBehaviorsComponent = nullptr;
+		uint32 HandlesSerial = 0;
+	};
+
+	// forwarded source as it was on resolve, DamageBehaviorsComponent nullptr if source had no component
+	struct FResolvedSource
+	{
+		int32 SourceIndex = INDEX_NONE;
+		TWeakObjectPtr<UDamageBehaviorsComponent> DamageBehaviorsComponent = nullptr;
+	};
+
+	// kept to re-resolve stale handle
+	FName DamageBehaviorName = NAME_None;
+	TArray<FName, TInlineAllocator<2>> DamageBehaviorsSourcesNames;
+
+	TWeakObjectPtr<UDamageBehaviorsComponent> OwnerComponent = nullptr;
+	uint32 OwnerHandlesSerial = 0;
+	TArray<FResolvedDamageBehavior, TInlineAllocator<2>> ResolvedDamageBehaviors;
+	TArray<FResolvedSource, TInlineAllocator<2>> ResolvedSources;
+	bool bIsResolved = false;
+};
@@ -5,12 +5,14 @@
 #include "CoreMinimal.h"
 #include "DamageBehaviorsSource.h"
 #include "DamageBehavior.h"
-#include "CapsuleHitRegistrator.h"
+#include "DamageBehaviorHandle.h"
+#include "DBSHitRegistratorBase.h"
+#include "DBSHitSink.h"
 #include "Components/ActorComponent.h"
 #include "StructUtils/InstancedStruct.h"
 #include "DamageBehaviorsComponent.generated.h"
 
-class UCapsuleHitRegistrator;
+class UDBSHitRegistratorBase;
 class UCapsuleHitRegistratorUDamageBehavior;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogDamageBehaviorsSystem, Log, All);
@@ -19,12 +21,12 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(FDamageBehaviorOnProcessedHit,
 	const UDamageBehavior*, DamageBehavior,
 	const FString, DamageBehaviorName,
 	const FDBSHitRegistratorHitResult&, HitRegistratorHitResult,
-	const UCapsuleHitRegistrator*, CapsuleHitRegistrator,
+	const UDBSHitRegistratorBase*, CapsuleHitRegistrator,
 	const FInstancedStruct&, Payload
 );
 
 UCLASS(Blueprintable, BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class DAMAGEBEHAVIORSSYSTEM_API UDamageBehaviorsComponent : public UActorComponent
+class DAMAGEBEHAVIORSSYSTEM_API UDamageBehaviorsComponent : public UActorComponent, public IDBSDamageBehaviorHitSink
 {
 	GENERATED_BODY()
 
@@ -94,6 +96,45 @@ public:
     UFUNCTION(BlueprintCallable)
     UDamageBehavior* GetDamageBehavior(const FString Name) const;
 
+	// same as InvokeDamageBehavior but without string conversions, names hashed once
+	// so cost doesn't depend on count or length of DamageBehaviors names
+    UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="DamageBehaviorsSourcesToUse,Payload"))
+	void InvokeDamageBehaviorByName(
+		const FName DamageBehaviorName,
+		const bool bShouldActivate,
+		const TArray<FName>& DamageBehaviorsSourcesToUse,
+		const FInstancedStruct& Payload
+	);
+
+    UFUNCTION(BlueprintCallable)
+    UDamageBehavior* GetDamageBehaviorByName(const FName Name) const;
+
+	// lookup built on BeginPlay, call it if DamageBehaviorsList changed at runtime
+    UFUNCTION(BlueprintCallable)
+    void RebuildDamageBehaviorsLookup();
+
+	// resolves DamageBehavior with its sources once, for abilities/notifies invoking same DamageBehavior often
+    UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="DamageBehaviorsSourcesToUse"))
+	FDamageBehaviorHandle MakeDamageBehaviorHandle(const FName DamageBehaviorName, const TArray<FName>& DamageBehaviorsSourcesToUse);
+
+	// same as InvokeDamageBehaviorByName without any lookups, stale Handle re-resolved in place
+    UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="Payload"))
+	void InvokeDamageBehaviorByHandle(UPARAM(ref) FDamageBehaviorHandle& Handle, const bool bShouldActivate, const FInstancedStruct& Payload);
+
+	// makes all handles using this component stale, source actors changes are detected by handles themselves
+    UFUNCTION(BlueprintCallable)
+	void InvalidateDamageBehaviorHandles() { DamageBehaviorHandlesSerial++; }
+
+	uint32 GetDamageBehaviorHandlesSerial() const { return DamageBehaviorHandlesSerial; }
+	// current component of source, evaluates source actor
+	UDamageBehaviorsComponent* GetDamageBehaviorsSourceComponent(int32 SourceIndex) const;
+
+#if WITH_DEV_AUTOMATION_TESTS
+	// automation tests only, see Private/Tests. Source without evaluator gives SourceActor,
+	// replacing actor of existing source doesn't invalidate handles same as evaluator result changing
+	void SetDamageBehaviorsSourceForTests(const FString& SourceName, AActor* SourceActor);
+#endif
+
 	// TODO: попытаться вернуть, но хз зач все это можно в DamageBehavior'ах ловить
     // for cases there HandleHitInternally is custom, e.g. BProjectileComponent, MeleeWeaponItem, ...
     // UFUNCTION(BlueprintCallable)
@@ -108,9 +149,17 @@ public:
 
 	UFUNCTION()
 	const TArray<FDBSHitRegistratorsSource> GetHitRegistratorsSources(TArray<UDamageBehaviorsSourceEvaluator*> SourceEvaluators_In) const;
+
+	// IDBSDamageBehaviorHitSink, called directly by owned DamageBehaviors
+	virtual void HandleDamageBehaviorHit(
+		const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
+		const UDamageBehavior* DamageBehavior,
+		const UDBSHitRegistratorBase* CapsuleHitRegistrator,
+		const FInstancedStruct& Payload) override;
 	
 protected:
     virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void PostLoad() override;
 	void SyncAllBehaviorSources();
 
@@ -124,17 +173,30 @@ private:
 	UPROPERTY()
 	TArray<TObjectPtr<UDamageBehaviorsSourceEvaluator>> DamageBehaviorsSourceEvaluators = {};
 
+	// Name -> DamageBehavior, first one wins for duplicated names same as linear search did
+	UPROPERTY(Transient)
+	TMap<FName, TObjectPtr<UDamageBehavior>> DamageBehaviorsByName;
+	bool bIsDamageBehaviorsLookupBuilt = false;
+
+	// SourceName -> index in DamageBehaviorsSources
+	TMap<FName, int32> DamageBehaviorsSourcesIndices;
+
+	// FDamageBehaviorHandle resolved with other value is stale
+	uint32 DamageBehaviorHandlesSerial = 0;
+
+	void ResolveDamageBehaviorHandle(FDamageBehaviorHandle& Handle);
+
 	UFUNCTION()
 	void PrepareDamageBehaviorsSources();
 	
     UFUNCTION()
-    TMap<FString, UCapsuleHitRegistrator*> FindCapsuleHitRegistrators(AActor* Actor) const;
+    TMap<FName, UDBSHitRegistratorBase*> FindCapsuleHitRegistrators(AActor* Actor) const;
 
 	UFUNCTION()
 	void DefaultOnHitAnything(
 		const FDBSHitRegistratorHitResult& HitRegistratorHitResult,
 		const UDamageBehavior* DamageBehavior,
-		const UCapsuleHitRegistrator* CapsuleHitRegistrator,
+		const UDBSHitRegistratorBase* CapsuleHitRegistrator,
 		const FInstancedStruct& Payload
 	);
 };
@@ -0,0 +1,141 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DamageBehaviorsSystemTypes.h"
+#include "DBSHitRegistratorSweep.h"
+#include "DBSTimerWheel.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "DamageBehaviorsSubsystem.generated.h"
+
+class UDBSHitRegistratorBase;
+class UDamageBehavior;
+class UPrimitiveComponent;
+class UDamageBehaviorsSubsystem;
+class USkeletalMeshComponent;
+
+USTRUCT()
+struct FDBSActiveBehaviorsTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UDamageBehaviorsSubsystem* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FDBSActiveBehaviorsTickFunction> : public TStructOpsTypeTraitsBase2<FDBSActiveBehaviorsTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+// custom significance(e.g. USignificanceManager) - DefaultLOD is DBS own distance based score
+DECLARE_DELEGATE_RetVal_TwoParams(EDBSDetectionLOD, FDBSDetectionLODOverride, const UDamageBehavior* /*DamageBehavior*/, EDBSDetectionLOD /*DefaultLOD*/);
+
+/**
+ * Per-world scheduler for DamageBehaviors.
+ * Only active DamageBehaviors are registered here (see UDamageBehavior::MakeActive)
+ * so frame cost scales with currently opened hit windows, not with amount of
+ * DamageBehaviors that exist. Ticks in "ActiveBehaviorsTickGroup" after skeletal meshes
+ * of hit registrators finished their animation update.
+ */
+UCLASS()
+class DAMAGEBEHAVIORSSYSTEM_API UDamageBehaviorsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UDamageBehaviorsSubsystem* Get(const UWorld* World);
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	void RegisterActiveBehavior(UDamageBehavior* DamageBehavior);
+	void UnregisterActiveBehavior(UDamageBehavior* DamageBehavior);
+
+	int32 GetNumActiveBehaviors() const { return ActiveBehaviors.Num(); }
+
+	void TickActiveBehaviors(float DeltaTime);
+
+	// called for every active DamageBehavior each frame while "DamageBehaviorsSystem.DetectionLOD" enabled
+	FDBSDetectionLODOverride DetectionLODOverride;
+
+	// WhileStandingInside re-hits, registrator notified when Delay(world time) passed
+	FDBSTimerWheelHandle ScheduleStandingInsideHit(UDBSHitRegistratorBase* HitRegistrator, UPrimitiveComponent* Occupant, float Delay);
+	void CancelStandingInsideHit(FDBSTimerWheelHandle& Handle);
+
+#if WITH_DEV_AUTOMATION_TESTS
+	// automation tests only, see Private/Tests
+	void SetDetectionLODIntervalsForTests(int32 ReducedInterval, int32 SimplifiedInterval)
+	{
+		DetectionLODReducedInterval = FMath::Max(1, ReducedInterval);
+		DetectionLODSimplifiedInterval = FMath::Max(1, SimplifiedInterval);
+	}
+	bool ShouldTickAtDetectionLODForTests(const UDamageBehavior* DamageBehavior, EDBSDetectionLOD DetectionLOD) const;
+#endif
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FDBSActiveBehavior
+	{
+		TWeakObjectPtr<UDamageBehavior> DamageBehavior = nullptr;
+		// given on register, stays with behavior when dense list reorders
+		uint32 DetectionLODPhase = 0;
+		// skeletal meshes that should finish animation before we sweep
+		TArray<TWeakObjectPtr<USkeletalMeshComponent>, TInlineAllocator<2>> PrerequisiteMeshes;
+	};
+
+	// dense list, DamageBehavior knows its index so add/remove is O(1)
+	TArray<FDBSActiveBehavior> ActiveBehaviors;
+	TMap<TWeakObjectPtr<USkeletalMeshComponent>, int32> PrerequisiteMeshesRefCount;
+
+	FDBSActiveBehaviorsTickFunction ActiveBehaviorsTickFunction;
+
+	// reusable sweeps scratch, with "DamageBehaviorsSystem.ParallelSweeps" holds all sweeps of current frame
+	FDBSHitRegistratorSweepBatch SweepBatch;
+
+	struct FDBSStandingInsideHit
+	{
+		TWeakObjectPtr<UDBSHitRegistratorBase> HitRegistrator = nullptr;
+		TObjectKey<UPrimitiveComponent> Occupant;
+	};
+	// thousands of occupants cost only expiring timers per frame
+	TDBSTimerWheel<FDBSStandingInsideHit> StandingInsideHitsWheel;
+	TArray<FDBSStandingInsideHit> ExpiredStandingInsideHits;
+
+	// from settings, read once on world begin play
+	float DetectionLODReducedDistanceSquared = 0.0f;
+	float DetectionLODSimplifiedDistanceSquared = 0.0f;
+	int32 DetectionLODReducedInterval = 1;
+	int32 DetectionLODSimplifiedInterval = 1;
+	// spreads behaviors of same LOD over frames
+	uint32 NextDetectionLODPhase = 0;
+	// locations of player pawns, gathered once per frame for all active behaviors
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+
+	// behaviors can be deactivated from ProcessHit/OnHitRegistered while we iterate
+	bool bIsTickingActiveBehaviors = false;
+	bool bHasPendingRemovals = false;
+
+	void AddMeshPrerequisite(USkeletalMeshComponent* MeshComponent);
+	void RemoveMeshPrerequisite(const TWeakObjectPtr<USkeletalMeshComponent>& MeshComponent);
+	void CompactActiveBehaviors();
+	void ExecuteSweepBatch();
+	void CommitSweepBatch();
+	void TickStandingInsideHits();
+	void GatherPlayerLocations();
+	EDBSDetectionLOD CalculateDetectionLOD(const UDamageBehavior& DamageBehavior) const;
+	bool ShouldTickAtDetectionLOD(EDBSDetectionLOD DetectionLOD, uint32 DetectionLODPhase) const;
+	void UpdateTickFunctionEnabled();
+};
@@ -23,6 +23,92 @@ public:
 	UPROPERTY(config, EditAnywhere, Category="DamageBehaviorsSystemSettings")
 	TArray<TSubclassOf<UDamageBehaviorsSourceEvaluator>> DamageBehaviorsSourcesEvaluators = {};
 
+	// TickGroup in which active DamageBehaviors sweep their HitRegistrators,
+	// skeletal meshes HitRegistrators attached to are always ticked before
+	UPROPERTY(config, EditAnywhere, Category="Performance")
+	TEnumAsByte<ETickingGroup> ActiveBehaviorsTickGroup = TG_PostPhysics;
+
+	// collect ByTrace sweeps of all active DamageBehaviors and run them on worker threads,
+	// hits still processed on game thread in one pass after all sweeps done
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(ConsoleVariable="DamageBehaviorsSystem.ParallelSweeps"))
+	bool bParallelSweeps = false;
+
+	// hittable actors kept in spatial hash(UDBSHittableActorsSubsystem), ByTrace sweeps
+	// skip scene query when no hittable actor is near swept capsule.
+	// Only registered actors can be hit with it - pawns and actors with UDBSHittableComponent
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(ConsoleVariable="DamageBehaviorsSystem.HittableBroadphase"))
+	bool bHittableActorsBroadphase = false;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bHittableActorsBroadphase"))
+	bool bRegisterPawnsAsHittable = true;
+
+	// size of spatial hash cell, roughly attack reach works well
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bHittableActorsBroadphase", ClampMin=50, Units="Centimeters"))
+	float HittableActorsCellSize = 500.0f;
+
+	// hittable actors bounds are root component bounds, expanded to cover meshes/weapons outside of it
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bHittableActorsBroadphase", ClampMin=0, Units="Centimeters"))
+	float HittableActorsBoundsExpansion = 50.0f;
+
+	// ByTrace/ByHurtboxes HitRegistrators on skeletal mesh that skipped animation update(URO, VisibilityBasedAnimTickOption)
+	// don't sweep frozen pose, movement of skipped frames swept at once when pose evaluated again
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(ConsoleVariable="DamageBehaviorsSystem.AnimSkippedFramesSweeps"))
+	bool bDeferSweepsOnAnimSkippedFrames = true;
+
+	// mesh that never refreshes bones(e.g. not rendered with OnlyTickPoseWhenRendered) still swept after this many frames
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bDeferSweepsOnAnimSkippedFrames", ClampMin=1, UIMax=16))
+	int32 MaxAnimSkippedFramesToDefer = 8;
+
+	// active DamageBehaviors scored by distance to nearest player, attacks of players and AI focused
+	// on player always Full. Custom scoring(e.g. SignificanceManager) - UDamageBehaviorsSubsystem::DetectionLODOverride
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(ConsoleVariable="DamageBehaviorsSystem.DetectionLOD"))
+	bool bDetectionLOD = false;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bDetectionLOD", ClampMin=0, Units="Centimeters"))
+	float DetectionLODReducedDistance = 3000.0f;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bDetectionLOD", ClampMin=0, Units="Centimeters"))
+	float DetectionLODSimplifiedDistance = 6000.0f;
+
+	// ticked once per this many frames
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bDetectionLOD", ClampMin=1, UIMax=8))
+	int32 DetectionLODReducedInterval = 2;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bDetectionLOD", ClampMin=1, UIMax=16))
+	int32 DetectionLODSimplifiedInterval = 4;
+
+	// HitRegistrators of baked UANS_InvokeDamageBehavior windows swept along baked trajectory + mesh transform
+	// instead of animated pose, so dedicated server can stop evaluating AI poses(e.g. OnlyTickMontagesWhenNotRendered)
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(ConsoleVariable="DamageBehaviorsSystem.BakedHitWindows"))
+	bool bUseBakedHitWindows = false;
+
+	// bake HitRegistrators trajectories of UANS_InvokeDamageBehavior windows when montage saved/cooked,
+	// sampled on DebugActors from "DefaultDebugActorsForPreview", cached in DDC
+	UPROPERTY(config, EditAnywhere, Category="Performance")
+	bool bBakeHitWindows = false;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bBakeHitWindows", ClampMin=10, UIMax=120, Units="Hertz"))
+	float BakedHitWindowsSampleRate = 60.0f;
+
+	// keys interpolated from neighbours within tolerances are dropped
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bBakeHitWindows", ClampMin=0, Units="Centimeters"))
+	float BakedHitWindowsLocationTolerance = 0.5f;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bBakeHitWindows", ClampMin=0, Units="Degrees"))
+	float BakedHitWindowsRotationTolerance = 0.5f;
+
+	// server records hurtboxes transforms history, ByHurtboxes DamageBehaviors with
+	// SetLagCompensationTimestamp sweep against hurtboxes as attacker client saw them. Read on world start
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(ConsoleVariable="DamageBehaviorsSystem.LagCompensation"))
+	bool bLagCompensation = false;
+
+	// recorded frames per hurtboxes owner, should cover MaxRewindTime at server tick rate
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bLagCompensation", ClampMin=2, UIMax=256))
+	int32 LagCompensationHistorySize = 64;
+
+	UPROPERTY(config, EditAnywhere, Category="Performance", meta=(EditCondition="bLagCompensation", ClampMin=0, Units="Seconds"))
+	float LagCompensationMaxRewindTime = 0.5f;
+
 	// TODO: ActorsBySourceName - RightHandActor, LeftHandActor
 	UPROPERTY(config, EditAnywhere, Category="DamageBehaviorsSystemSettings")
 	TArray<FDBSDebugActorsForMesh> DefaultDebugActorsForPreview = {};
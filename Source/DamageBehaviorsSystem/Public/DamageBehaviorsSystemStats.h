@@ -0,0 +1,11 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// "stat DamageBehaviorsSystem" to see all DBS counters
+DECLARE_STATS_GROUP(TEXT("DamageBehaviorsSystem"), STATGROUP_DamageBehaviorsSystem, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active DamageBehaviors"), STAT_DBS_ActiveBehaviors, STATGROUP_DamageBehaviorsSystem, DAMAGEBEHAVIORSSYSTEM_API);
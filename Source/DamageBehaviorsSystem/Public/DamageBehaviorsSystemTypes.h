@@ -6,16 +6,61 @@
 #include "DamageBehaviorsSystemTypes.generated.h"
 
 const FString DEFAULT_DAMAGE_BEHAVIOR_SOURCE = FString(TEXT("ThisActor"));
+// interned DEFAULT_DAMAGE_BEHAVIOR_SOURCE for runtime lookups
+const FName DEFAULT_DAMAGE_BEHAVIOR_SOURCE_NAME = FName(TEXT("ThisActor"));
 
 UENUM(BlueprintType)
 enum class EDamageBehaviorHitDetectionType : uint8
 {
 	ByTrace,
 	ByEntering UMETA(DisplayName = "By Entering (Capsule)"),
-	// TODO for "ticking" DamageBehaviors
-	// WhileStandingInside,
+	// sweeps resolved against UDBSHurtboxComponents with DBS own math, no physics scene involved
+	ByHurtboxes UMETA(DisplayName = "By Hurtboxes (No Physics)"),
+	// capsule stays NoCollision, OverlapMultiByChannel issued with "OverlapQueryRate",
+	// newly found components are hit same as "ByEntering" begin overlap
+	ByOverlapQuery UMETA(DisplayName = "By Overlap Query (Capsule)"),
+	// occupants found by overlap query are hit on enter and re-hit every "StandingInsideHitInterval"
+	// while inside - fire pools, poison clouds, traps
+	WhileStandingInside UMETA(DisplayName = "While Standing Inside (Capsule)"),
 };
 
+UENUM(BlueprintType)
+enum class EDBSOverlapQueryRate : uint8
+{
+	EveryFrame,
+	EveryNFrames,
+	EveryNMilliseconds,
+};
+
+// how much hit detection active DamageBehavior gets, see "DamageBehaviorsSystem.DetectionLOD"
+UENUM(BlueprintType)
+enum class EDBSDetectionLOD : uint8
+{
+	// every frame, every HitRegistrator
+	Full,
+	// every "DetectionLODReducedInterval" frames, skipped movement swept as one longer segment
+	Reduced,
+	// every "DetectionLODSimplifiedInterval" frames, only first HitRegistrator of DamageBehavior
+	Simplified,
+};
+
+// HitRegistrators of these types ticked by DamageBehavior while active
+inline bool DBSIsTickedHitDetectionType(EDamageBehaviorHitDetectionType HitDetectionType)
+{
+	return HitDetectionType == EDamageBehaviorHitDetectionType::ByTrace
+		|| HitDetectionType == EDamageBehaviorHitDetectionType::ByHurtboxes
+		|| HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery
+		|| HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside;
+}
+
+// hits of these types come from entering volume, same target hit again on every enter
+inline bool DBSIsEnteringHitDetectionType(EDamageBehaviorHitDetectionType HitDetectionType)
+{
+	return HitDetectionType == EDamageBehaviorHitDetectionType::ByEntering
+		|| HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery
+		|| HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside;
+}
+
 USTRUCT(BlueprintType)
 struct FDamageBehaviorHitDetectionSettings
 {
@@ -31,15 +76,47 @@ public:
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="DamageBehavior", meta = (EditCondition = "bUseCustomTraceChannel"))
 	TEnumAsByte<ECollisionChannel> CustomTraceChannel = ECC_Visibility;
+
+	// sweep submitted via AsyncSweepByChannel and hits delivered on next frame,
+	// takes scene queries off the game thread for the price of one frame latency - good for AI
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::ByTrace"))
+	bool bUseAsyncTrace = false;
+
+	// false - always Full detection LOD, e.g. boss attacks that should look precise from any distance
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior")
+	bool bAllowDetectionLOD = true;
+
+	// fast swings are split in substeps interpolating position and rotation,
+	// amount of substeps calculated from rotation relative to capsule radius, straight movement is never split
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (ClampMin = 1, UIMin = 1, UIMax = 16, EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::ByTrace || HitDetectionType == EDamageBehaviorHitDetectionType::ByHurtboxes"))
+	int32 MaxSubsteps = 4;
 	
 	
-	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::ByEntering"))
+	// WhileStandingInside - if disabled actors inside on start are first hit after "StandingInsideHitInterval"
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::ByEntering || HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery || HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside"))
 	bool bCheckOverlappingActorsOnStart = true;
+
+	// AoE volumes over crowds usually don't need every frame precision
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery || HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside"))
+	EDBSOverlapQueryRate OverlapQueryRate = EDBSOverlapQueryRate::EveryFrame;
+
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (ClampMin = 1, EditCondition = "(HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery || HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside) && OverlapQueryRate == EDBSOverlapQueryRate::EveryNFrames"))
+	int32 OverlapQueryIntervalFrames = 2;
+
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (ClampMin = 0, Units = "Milliseconds", EditCondition = "(HitDetectionType == EDamageBehaviorHitDetectionType::ByOverlapQuery || HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside) && OverlapQueryRate == EDBSOverlapQueryRate::EveryNMilliseconds"))
+	float OverlapQueryIntervalMs = 100.0f;
 	
 	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::ByEntering"))
 	FCollisionProfileName CollisionProfileName = FCollisionProfileName(FName("VolumeHitRegistrator"));
 
-	// call GetHit every time "WhileStandingInside"
-	// UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside"))
-	// bool bUseStacks = true;
+	// occupants re-hit with this interval while standing inside
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (ClampMin = 0.05, Units = "Seconds", EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside"))
+	float StandingInsideHitInterval = 1.0f;
+
+	// every re-hit adds stack, see FDBSHitRegistratorHitResult "Stacks", reset when occupant leaves
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside"))
+	bool bUseStacks = false;
+
+	UPROPERTY(EditDefaultsOnly, Category="DamageBehavior", meta = (ClampMin = 1, EditCondition = "HitDetectionType == EDamageBehaviorHitDetectionType::WhileStandingInside && bUseStacks"))
+	int32 MaxStacks = 5;
 };
\ No newline at end of file
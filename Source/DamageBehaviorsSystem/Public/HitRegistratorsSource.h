@@ -3,7 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "CapsuleHitRegistrator.h"
+#include "DBSHitRegistratorBase.h"
 #include "HitRegistratorsSource.generated.h"
 
 
@@ -19,7 +19,7 @@ struct FDBSHitRegistratorsSource
 	AActor* Actor = nullptr;
 
 	UPROPERTY()
-	TArray<UCapsuleHitRegistrator*> CapsuleHitRegistrators;
+	TArray<UDBSHitRegistratorBase*> CapsuleHitRegistrators;
 };
 
 USTRUCT(BlueprintType)
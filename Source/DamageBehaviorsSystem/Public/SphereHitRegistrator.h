@@ -0,0 +1,30 @@
+// Pavel Penkov 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DBSHitRegistratorBase.h"
+#include "SphereHitRegistrator.generated.h"
+
+/**
+ * Sphere HitRegistrator - fists, explosions, projectiles.
+ * Cheapest narrowphase and rotation never changes sweep, so fast spins need no extra substeps
+ */
+UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
+class DAMAGEBEHAVIORSSYSTEM_API USphereHitRegistrator : public UDBSHitRegistratorBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual FCollisionShape GetUnscaledShape() const override;
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	void SetSphereRadius(float Radius_In, bool bUpdateOverlaps = true);
+
+	UFUNCTION(BlueprintCallable, Category="Shape")
+	float GetScaledSphereRadius() const { return SphereRadius * GetComponentTransform().GetMinimumAxisScale(); }
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Shape", meta=(ClampMin="0", UIMin="0"))
+	float SphereRadius = 10.0f;
+};